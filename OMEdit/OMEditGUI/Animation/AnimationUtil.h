@@ -42,6 +42,7 @@
 
 #include <sys/stat.h>
 #include <string>
+#include <algorithm>
 #include <osg/Vec3>
 
 #include "Shapes.h"
@@ -158,6 +159,52 @@ inline std::string extractCADFilename(const std::string& s)
   }
 }
 
+/*!
+ * \brief The ResultAttributeHandle struct
+ * A ShapeObjectAttribute resolved once against the result file.
+ * values points to the trajectory of the variable in the result file.
+ */
+struct ResultAttributeHandle
+{
+  ShapeObjectAttribute* attr;
+  const double* values;
+};
+
+/*! \brief Finds the interpolation interval of time in the sorted time vector.
+ * The values at time are value[index1] + weight * (value[index2] - value[index1]).
+ * In case of events (identical time points) the right limit is used. Times outside the vector are clamped.
+ * index1 is also used as a hint, e.g., the index of the previous frame, so sequential playback doesn't need a search.
+ */
+inline void findTimeInterval(const double* timeValues, unsigned int numTimePoints, double time,
+                             unsigned int& index1, unsigned int& index2, double& weight)
+{
+  weight = 0.0;
+  if (numTimePoints == 0) {
+    index1 = index2 = 0;
+    return;
+  }
+  // upper is the first time point after time
+  unsigned int upper;
+  if (index1 < numTimePoints && timeValues[index1] <= time
+      && (index1 + 1 == numTimePoints || timeValues[index1 + 1] > time)) {
+    upper = index1 + 1;
+  } else if (index1 + 1 < numTimePoints && timeValues[index1 + 1] <= time
+             && (index1 + 2 == numTimePoints || timeValues[index1 + 2] > time)) {
+    upper = index1 + 2;
+  } else {
+    upper = std::upper_bound(timeValues, timeValues + numTimePoints, time) - timeValues;
+  }
+  if (upper == 0) {
+    index1 = index2 = 0;
+  } else if (upper == numTimePoints || timeValues[upper - 1] == time) {
+    index1 = index2 = upper - 1;
+  } else {
+    index1 = upper - 1;
+    index2 = upper;
+    weight = (time - timeValues[index1]) / (timeValues[index2] - timeValues[index1]);
+  }
+}
+
 inline const char* boolToString(bool b)
 {
     return b ? "true" : "false";
@@ -34,6 +34,8 @@
 
 #include "ExtraShapes.h"
 #include <iostream>
+#include <map>
+#include <tuple>
 
 
 /*!
@@ -66,9 +68,11 @@ osg::Vec3f normalizeVec(osg::Vec3f vec) {
  * creates a pipe or pipecylinder geometry
  */
 Pipecylinder::Pipecylinder(float rI, float rO, float l) :
-  osg::Geometry()
+  osg::Geometry(),
+  mRI(rI),
+  mRO(rO),
+  mLength(l)
 {
-  const int nEdges = 16;
   double phi = 2 * M_PI/nEdges;
   int vertIdx = 0;
   //VERTICES
@@ -204,12 +208,36 @@ Pipecylinder::Pipecylinder(float rI, float rO, float l) :
     vertIdx = vertIdx+4;
   }
 
+  mpVertices = vertices;
   this->setVertexArray(vertices);
   this->setNormalArray(normals);
   this->setTexCoordArray(0,texcoords);
   this->setNormalBinding( osg::Geometry::BIND_PER_VERTEX);
 }
 
+/*!
+ * \brief Pipecylinder::setLength
+ * moves the vertices of the top plane and the top edges of the lateral planes to the new length.
+ * The geometry is not recreated since the normals and texture coordinates don't depend on the length.
+ */
+void Pipecylinder::setLength(float l)
+{
+  if (l == mLength)
+    return;
+  mLength = l;
+  // the inner and outer end rings
+  for (int i = 2 * nEdges; i < 4 * nEdges; i++)
+    (*mpVertices)[i].z() = l;
+  // the outer and inner lateral planes, the last two vertices of each plane are at the top
+  for (int i = 4 * nEdges; i < 12 * nEdges; i += 4) {
+    (*mpVertices)[i + 2].z() = l;
+    (*mpVertices)[i + 3].z() = l;
+  }
+  mpVertices->dirty();
+  this->dirtyDisplayList();
+  this->dirtyBound();
+}
+
 /*!
  * \brief Spring::getNormal
  * \param the input vector
@@ -367,8 +395,35 @@ osg::Vec3f Spring::rotateArbitraryAxis(osg::Vec3f vec, osg::Vec3f axis, float ph
  * creates an osg spring geometry
  */
 Spring::Spring(float r, float rWire, float nWindings, float l) :
-  osg::Geometry()
+  osg::Geometry(),
+  mpOuterVertices(nullptr),
+  mpSplineVertices(nullptr),
+  mR(0.0f),
+  mRWire(0.0f),
+  mNWindings(0.0f),
+  mLength(0.0f)
+{
+  setParameters(r, rWire, nWindings, l);
+}
+
+/*!
+ * \brief Spring::setParameters
+ * \param center radius of the coil
+ * \param radius of the wire
+ * \param number of windings
+ * \param the length
+ * computes the vertices of the spring. The vertex arrays and the planes are only created again if the number of
+ * segments changes, otherwise the vertices are updated in place.
+ */
+void Spring::setParameters(float r, float rWire, float nWindings, float l)
 {
+  if (mpOuterVertices.valid() && r == mR && rWire == mRWire && nWindings == mNWindings && l == mLength)
+    return;
+  mR = r;
+  mRWire = rWire;
+  mNWindings = nWindings;
+  mLength = l;
+
   float R = r;
   float L = l;
   float RWIRE = rWire;
@@ -377,11 +432,15 @@ Spring::Spring(float r, float rWire, float nWindings, float l) :
   const int ELEMENTS_WINDING = 10;
   const int ELEMENTS_CONTOUR = 6;
 
-  this->getPrimitiveSetList().clear();
-
   //the inner line points
   int numSegments = (ELEMENTS_WINDING * NWIND) + 1;
-  mpSplineVertices = new osg::Vec3Array(numSegments);
+  bool createArrays = !mpSplineVertices.valid() || (int)mpSplineVertices->size() != numSegments;
+  if (createArrays)
+  {
+    this->getPrimitiveSetList().clear();
+    mpSplineVertices = new osg::Vec3Array(numSegments);
+    mpOuterVertices = new osg::Vec3Array((numSegments + 1)*ELEMENTS_CONTOUR);
+  }
 
   for (int segIdx = 0; segIdx < numSegments; segIdx++)
   {
@@ -392,8 +451,6 @@ Spring::Spring(float r, float rWire, float nWindings, float l) :
   }
 
   //the outer points for the facettes
-  int numVertices = (numSegments + 1)*ELEMENTS_CONTOUR;
-  mpOuterVertices = new osg::Vec3Array(numVertices);
   osg::Vec3f normal;
   osg::Vec3f v1;
   osg::Vec3f v2;
@@ -414,8 +471,16 @@ Spring::Spring(float r, float rWire, float nWindings, float l) :
     }
   }
 
+  if (!createArrays)
+  {
+    mpOuterVertices->dirty();
+    this->dirtyDisplayList();
+    this->dirtyBound();
+    return;
+  }
+
   // pass the created vertex array to the points geometry object.
-  this->setVertexArray(mpOuterVertices);
+  this->setVertexArray(mpOuterVertices.get());
 
   //PLANES
   // base plane bottom
@@ -611,6 +676,8 @@ osg::Vec3f DXF3dFace::calcNormals()
 
 /*!
  * \brief DXFile constructor
+ * Parses the 3DFACE entities of the dxf file in a single pass. All faces are put into one indexed triangle primitive set,
+ * vertices with the same position, normal and color are welded.
  * \param std::string filename
  */
 DXFile::DXFile(std::string filename)
@@ -618,98 +685,74 @@ DXFile::DXFile(std::string filename)
 {
   // parse dxf file and fill 3dface objects
   fileName = filename;
-  QFile* dxfFile = new QFile(QString::fromStdString(filename));
-  if (dxfFile->open(QIODevice::ReadOnly))
+  QFile dxfFile(QString::fromStdString(filename));
+  if (dxfFile.open(QIODevice::ReadOnly))
   {
-    QTextStream* in = new QTextStream(dxfFile);
-    //count all 3d faces
-    int num3dFaces = in->readAll().count(QString("3DFACE"));
-
-    //reset textstream
-    in->seek(0);
+    QTextStream in(&dxfFile);
 
     // prepare drawing objects
-    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(num3dFaces * 4);
-    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array(num3dFaces * 4);
-    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(num3dFaces * 4);
-
-    // fill face objects
-    DXF3dFace* faces = new DXF3dFace[num3dFaces];
-    QString line = in->readLine();
-    int faceIdx = 0;
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
+    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array();
+    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array();
+    osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES);
+    // the index of every welded vertex
+    std::map<std::tuple<osg::Vec3f, osg::Vec3f, osg::Vec4f>, unsigned int> vertexIndices;
+    QString line = in.readLine();
 
     int done = 0;
     while (!done)
     {
       if (!line.compare("SECTION")) {
-        int secID = in->readLine().toInt();
-        //std::cout << "enter section" << secID << std::endl;
-        line = in->readLine();
+        in.readLine();
+        line = in.readLine();
       }
       else if (!line.compare("ENTITIES")) {
-        int entityID = in->readLine().toInt();
-        //std::cout << "enter entity" << entityID << std::endl;
-        line = in->readLine();
+        in.readLine();
+        line = in.readLine();
       }
       else if (!line.compare("3DFACE")) {
-        //std::cout << "fill face entity" << std::endl;
-
-        //add vertices
-        line = faces[faceIdx].fill3dFace(in);
-        (*vertices)[(faceIdx*4) + 0] = faces[faceIdx].vec1;
-        (*vertices)[(faceIdx * 4) + 1] = faces[faceIdx].vec2;
-        (*vertices)[(faceIdx * 4) + 2] = faces[faceIdx].vec3;
-        (*vertices)[(faceIdx * 4) + 3] = faces[faceIdx].vec4;
-        //add colors
-        (*colors)[(faceIdx * 4) + 0] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 1] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 2] = faces[faceIdx].color;
-        (*colors)[(faceIdx * 4) + 3] = faces[faceIdx].color;
-        //add normals
-        (*normals)[(faceIdx * 4) + 0] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 1] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 2] = faces[faceIdx].calcNormals();
-        (*normals)[(faceIdx * 4) + 3] = faces[faceIdx].calcNormals();
-
-        faceIdx = faceIdx + 1;
-      }
-      else if (!line.compare("ENDSEC")) {
-        //std::cout << "close section" << std::endl;
-        line = in->readLine();
+        DXF3dFace face;
+        line = face.fill3dFace(&in);
+        osg::Vec3f normal = face.calcNormals();
+        // the fourth corner equals the third one (or the first one) if the face is a triangle
+        bool isTriangle = (face.vec4 == face.vec3) || (face.vec4 == face.vec1);
+        const osg::Vec3f corners[4] = {face.vec1, face.vec2, face.vec3, face.vec4};
+        unsigned int indices[4];
+        for (int i = 0; i < (isTriangle ? 3 : 4); i++)
+        {
+          std::tuple<osg::Vec3f, osg::Vec3f, osg::Vec4f> key(corners[i], normal, face.color);
+          std::map<std::tuple<osg::Vec3f, osg::Vec3f, osg::Vec4f>, unsigned int>::iterator it = vertexIndices.find(key);
+          if (it == vertexIndices.end())
+          {
+            it = vertexIndices.insert(std::make_pair(key, (unsigned int)vertices->size())).first;
+            vertices->push_back(corners[i]);
+            normals->push_back(normal);
+            colors->push_back(face.color);
+          }
+          indices[i] = it->second;
+        }
+        triangles->push_back(indices[0]);
+        triangles->push_back(indices[1]);
+        triangles->push_back(indices[2]);
+        if (!isTriangle)
+        {
+          triangles->push_back(indices[0]);
+          triangles->push_back(indices[2]);
+          triangles->push_back(indices[3]);
+        }
       }
-      else if (!line.compare("EOF")) {
+      else if (!line.compare("EOF") || in.atEnd()) {
         done = 1;
       }
       else {
-        line = in->readLine();
+        line = in.readLine();
       }
     }
-    dxfFile->close();
+    dxfFile.close();
 
-    //add planes
+    //add faces
     this->setVertexArray(vertices);
-    for (int i = 0; i < num3dFaces; i++)
-    {
-      if (faces[i].vec1 == faces[i].vec4) {
-        //std::cout << "its a triangle" << std::endl;
-        //faces[i].dumpDXF3DFace();
-        osg::ref_ptr<osg::DrawElementsUInt> facette = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 3);
-        (*facette)[0] = (i * 4) + 0;
-        (*facette)[1] = (i * 4) + 1;
-        (*facette)[2] = (i * 4) + 2;
-        this->addPrimitiveSet(facette);
-      }
-      else
-      {
-        //std::cout << "its a quad" << std::endl;
-        osg::ref_ptr<osg::DrawElementsUInt> facette = new osg::DrawElementsUInt(osg::PrimitiveSet::QUADS, 4);
-        (*facette)[0] = (i * 4) + 0;
-        (*facette)[1] = (i * 4) + 1;
-        (*facette)[2] = (i * 4) + 2;
-        (*facette)[3] = (i * 4) + 3;
-        this->addPrimitiveSet(facette);
-      }
-    }
+    this->addPrimitiveSet(triangles);
     //add normals
     this->setNormalArray(normals);
     this->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
@@ -718,4 +761,3 @@ DXFile::DXFile(std::string filename)
     this->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
   }
 }
-
@@ -51,6 +51,14 @@ class Pipecylinder : public osg::Geometry
 public:
   Pipecylinder(float rI, float rO, float l);
   ~Pipecylinder() {};
+  bool hasRadii(float rI, float rO) const {return rI == mRI && rO == mRO;}
+  void setLength(float l);
+private:
+  enum {nEdges = 16};
+  float mRI;
+  float mRO;
+  float mLength;
+  osg::ref_ptr<osg::Vec3Array> mpVertices;
 };
 
 
@@ -59,6 +67,7 @@ class Spring : public osg::Geometry
 public:
   Spring(float r, float rCoil, float nWindings,  float l);
   ~Spring() {};
+  void setParameters(float r, float rWire, float nWindings, float l);
 private:
   osg::Vec3f getNormal(osg::Vec3f vec, float length = 1);
   osg::Vec3f rotateX(osg::Vec3f vec, float phi);
@@ -68,8 +77,12 @@ private:
   osg::Vec3f rotateArbitraryAxis(osg::Vec3f vec, osg::Vec3f axis, float phi);
   float angleBetweenVectors(osg::Vec3f vec1, osg::Vec3f vec2);
 
-  osg::Vec3Array* mpOuterVertices;
-  osg::Vec3Array* mpSplineVertices;
+  osg::ref_ptr<osg::Vec3Array> mpOuterVertices;
+  osg::ref_ptr<osg::Vec3Array> mpSplineVertices;
+  float mR;
+  float mRWire;
+  float mNWindings;
+  float mLength;
 };
 
 class DXF3dFace
@@ -58,6 +58,8 @@ FMUSettingsDialog::FMUSettingsDialog(QWidget *pParent, VisualizerFMU* pVisualize
   QLabel *solverLabel = new QLabel(tr("Solver"));
   mpSolverComboBox = new QComboBox();
   mpSolverComboBox->addItem(QString("Explicit Euler"), QVariant((int)Solver::EULER_FORWARD));
+  mpSolverComboBox->addItem(QString("Runge-Kutta 4"), QVariant((int)Solver::RUNGE_KUTTA));
+  mpSolverComboBox->addItem(QString("Dormand-Prince (adaptive)"), QVariant((int)Solver::DORMAND_PRINCE));
   Label *stepsizeLabel = new Label(tr("Step Size [s]"));
   mpStepSizeLineEdit = new QLineEdit(QString::number(mStepSize));
   Label *handleEventsLabel = new Label(tr("Process Events in FMU"));
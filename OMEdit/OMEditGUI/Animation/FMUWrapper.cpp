@@ -35,6 +35,12 @@
 
 #include "FMUWrapper.h"
 
+#include <algorithm>
+#include <cmath>
+
+//! The maximum number of bisections to locate a state event.
+static const int maxEventBisections = 50;
+
 SimSettingsFMU::SimSettingsFMU()
                 : _callEventUpdate(fmi1_false),
                   _toleranceControlled(fmi1_true),
@@ -98,6 +104,11 @@ void SimSettingsFMU::setSolver(const Solver& solver)
   _solver = solver;
 }
 
+Solver SimSettingsFMU::getSolver() const
+{
+  return _solver;
+}
+
 int* SimSettingsFMU::getCallEventUpdate()
 {
   return &_callEventUpdate;
@@ -122,7 +133,205 @@ bool SimSettingsFMU::getIterateEvents()
 //-------------------------------
 
 
-FMUWrapperAbstract::FMUWrapperAbstract(){
+FMUWrapperAbstract::FMUWrapperAbstract()
+  : mFMUdata(),
+    mStatesStart(),
+    mStatesDerStart(),
+    mStatesStage(),
+    mStatesTemp(),
+    mEventIndicatorsTemp(),
+    mDormandPrinceStepSize(0.0)
+{
+}
+
+/*!
+ * \brief eventIndicatorsChanged
+ * Checks if the sign of an event indicator has changed.
+ */
+static bool eventIndicatorsChanged(const double* eventIndicators, const double* eventIndicatorsPrev, size_t nEventIndicators)
+{
+  for (size_t k = 0; k < nEventIndicators; ++k)
+  {
+    if (eventIndicators[k] * eventIndicatorsPrev[k] < 0)
+      return true;
+  }
+  return false;
+}
+
+/*!
+ * \brief FMUWrapperAbstract::doStep
+ * Integrates the states from _tcur - _hcur to _tcur with the solver.
+ * solveSystem() must have been called before, i.e., _statesDer are the derivatives at the beginning of the step.
+ * \param solver
+ * \param tolerance - the relative and absolute tolerance of the adaptive solver.
+ */
+void FMUWrapperAbstract::doStep(const Solver& solver, const double tolerance)
+{
+  mStatesStart.assign(mFMUdata._states, mFMUdata._states + mFMUdata._nStates);
+  mStatesDerStart.assign(mFMUdata._statesDer, mFMUdata._statesDer + mFMUdata._nStates);
+  integrate(solver, mFMUdata._tcur - mFMUdata._hcur, mFMUdata._hcur, tolerance, mStatesStart.data(), mStatesDerStart.data(),
+            mFMUdata._states);
+}
+
+/*!
+ * \brief FMUWrapperAbstract::locateStateEvent
+ * Checks if an event indicator changes its sign during the last step of doStep().
+ * In that case the step is shortened by bisection so that it ends right after the zero crossing and the event is handled
+ * at the beginning of the next step.
+ * \param solver
+ * \param tolerance
+ * \return true if the step was shortened.
+ */
+bool FMUWrapperAbstract::locateStateEvent(const Solver& solver, const double tolerance)
+{
+  const size_t nEventIndicators = mFMUdata._nEventIndicators;
+  if (nEventIndicators == 0)
+    return false;
+  mEventIndicatorsTemp.resize(nEventIndicators);
+  getEventIndicators(mFMUdata._tcur, mFMUdata._states, mEventIndicatorsTemp.data());
+  if (!eventIndicatorsChanged(mEventIndicatorsTemp.data(), mFMUdata._eventIndicatorsPrev, nEventIndicators))
+    return false;
+
+  const double tStart = mFMUdata._tcur - mFMUdata._hcur;
+  const double minInterval = 1e-12 * std::max(1.0, std::fabs(tStart));
+  double hLeft = 0.0;
+  double hRight = mFMUdata._hcur;
+  // the trial integrations must not change the initial step size of the next step
+  const double dormandPrinceStepSize = mDormandPrinceStepSize;
+  mStatesTemp.resize(mFMUdata._nStates);
+  for (int i = 0; i < maxEventBisections && hRight - hLeft > minInterval; ++i)
+  {
+    const double hMid = 0.5 * (hLeft + hRight);
+    integrate(solver, tStart, hMid, tolerance, mStatesStart.data(), mStatesDerStart.data(), mStatesTemp.data());
+    getEventIndicators(tStart + hMid, mStatesTemp.data(), mEventIndicatorsTemp.data());
+    if (eventIndicatorsChanged(mEventIndicatorsTemp.data(), mFMUdata._eventIndicatorsPrev, nEventIndicators))
+    {
+      hRight = hMid;
+      std::copy(mStatesTemp.begin(), mStatesTemp.end(), mFMUdata._states);
+    }
+    else
+    {
+      hLeft = hMid;
+    }
+  }
+  mDormandPrinceStepSize = dormandPrinceStepSize;
+  mFMUdata._hcur = hRight;
+  mFMUdata._tcur = tStart + hRight;
+  return true;
+}
+
+/*!
+ * \brief FMUWrapperAbstract::updateEventIndicators
+ * Takes the current event indicators as reference for the zero crossing detection of the next step.
+ */
+void FMUWrapperAbstract::updateEventIndicators()
+{
+  std::copy(mFMUdata._eventIndicators, mFMUdata._eventIndicators + mFMUdata._nEventIndicators, mFMUdata._eventIndicatorsPrev);
+}
+
+/*!
+ * \brief FMUWrapperAbstract::integrate
+ * Integrates the states from time to time + h.
+ * \param solver - explicit Euler, classical Runge-Kutta or Dormand-Prince with step size control.
+ * \param time
+ * \param h
+ * \param tolerance - the relative and absolute tolerance of Dormand-Prince.
+ * \param states - the states at time.
+ * \param statesDer - the derivatives at time.
+ * \param statesOut - the states at time + h, must not be states.
+ */
+void FMUWrapperAbstract::integrate(const Solver& solver, const double time, const double h, const double tolerance,
+                                   const double* states, const double* statesDer, double* statesOut)
+{
+  const size_t nStates = mFMUdata._nStates;
+  switch (solver)
+  {
+    case Solver::RUNGE_KUTTA:
+    {
+      for (int s = 1; s < 4; ++s)
+        mStages[s].resize(nStates);
+      mStatesStage.resize(nStates);
+      for (size_t k = 0; k < nStates; ++k)
+        mStatesStage[k] = states[k] + 0.5 * h * statesDer[k];
+      getDerivatives(time + 0.5 * h, mStatesStage.data(), mStages[1].data());
+      for (size_t k = 0; k < nStates; ++k)
+        mStatesStage[k] = states[k] + 0.5 * h * mStages[1][k];
+      getDerivatives(time + 0.5 * h, mStatesStage.data(), mStages[2].data());
+      for (size_t k = 0; k < nStates; ++k)
+        mStatesStage[k] = states[k] + h * mStages[2][k];
+      getDerivatives(time + h, mStatesStage.data(), mStages[3].data());
+      for (size_t k = 0; k < nStates; ++k)
+        statesOut[k] = states[k] + h / 6.0 * (statesDer[k] + 2.0 * mStages[1][k] + 2.0 * mStages[2][k] + mStages[3][k]);
+      break;
+    }
+    case Solver::DORMAND_PRINCE:
+    {
+      // Butcher tableau of Dormand-Prince 5(4), the last row are the weights of the 5th order solution.
+      static const double c[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
+      static const double a[7][6] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0},
+        {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0},
+        {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0},
+        {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0},
+        {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}};
+      // difference of the weights of the 5th and the 4th order solution.
+      static const double e[7] = {71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+      for (int s = 0; s < 7; ++s)
+        mStages[s].resize(nStates);
+      mStatesStage.resize(nStates);
+      std::copy(states, states + nStates, statesOut);
+      std::copy(statesDer, statesDer + nStates, mStages[0].begin());
+      const double tEnd = time + h;
+      const double minStepSize = 1e-12 * std::max(1.0, std::fabs(tEnd));
+      double t = time;
+      double stepSize = (mDormandPrinceStepSize > 0.0) ? std::min(mDormandPrinceStepSize, h) : h;
+      while (tEnd - t > minStepSize)
+      {
+        const double hs = std::min(stepSize, tEnd - t);
+        // the stage of the last row is the 5th order solution.
+        for (int s = 1; s < 7; ++s)
+        {
+          for (size_t k = 0; k < nStates; ++k)
+          {
+            double sum = 0.0;
+            for (int j = 0; j < s; ++j)
+              sum += a[s][j] * mStages[j][k];
+            mStatesStage[k] = statesOut[k] + hs * sum;
+          }
+          getDerivatives(t + c[s] * hs, mStatesStage.data(), mStages[s].data());
+        }
+        double error = 0.0;
+        for (size_t k = 0; k < nStates; ++k)
+        {
+          double sum = 0.0;
+          for (int j = 0; j < 7; ++j)
+            sum += e[j] * mStages[j][k];
+          const double scale = tolerance + tolerance * std::max(std::fabs(statesOut[k]), std::fabs(mStatesStage[k]));
+          error = std::max(error, std::fabs(hs * sum) / scale);
+        }
+        if (error <= 1.0 || hs <= minStepSize)
+        {
+          // accept the step, the derivative at its end is the first stage of the next one.
+          t += hs;
+          std::copy(mStatesStage.begin(), mStatesStage.end(), statesOut);
+          mStages[0].swap(mStages[6]);
+        }
+        const double factor = (error > 0.0) ? 0.9 * std::pow(error, -0.2) : 5.0;
+        stepSize = hs * std::min(5.0, std::max(0.2, factor));
+      }
+      mDormandPrinceStepSize = stepSize;
+      break;
+    }
+    case Solver::EULER_FORWARD:
+    default:
+    {
+      for (size_t k = 0; k < nStates; ++k)
+        statesOut[k] = states[k] + h * statesDer[k];
+      break;
+    }
+  }
 }
 
 //-------------------------------
@@ -132,8 +341,7 @@ FMUWrapperAbstract::FMUWrapperAbstract(){
 FMUWrapper_ME_1::FMUWrapper_ME_1()
     : FMUWrapperAbstract(),
       mpFMU(nullptr),
-      mCallBackFunctions(),
-      mFMUdata()
+      mCallBackFunctions()
 {
 }
 
@@ -158,6 +366,11 @@ void FMUWrapper_ME_1::fmi_get_real(unsigned int* valueRef, double* res)
   fmi1_import_get_real(mpFMU, valueRef, 1, res);
 }
 
+void FMUWrapper_ME_1::fmi_get_reals(const unsigned int* valueRefs, size_t n, double* res)
+{
+  fmi1_import_get_real(mpFMU, valueRefs, n, res);
+}
+
 unsigned int FMUWrapper_ME_1::fmi_get_variable_by_name(const char* name)
 {
     fmi1_import_variable_t* var = fmi1_import_get_variable_by_name(mpFMU, name);
@@ -243,6 +456,8 @@ const FMUData* FMUWrapper_ME_1::getFMUData()
 
 void FMUWrapper_ME_1::setContinuousStates()
 {
+  // the integrators and the event location leave the FMU at their last trial time, so set the time of the states as well
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, mFMUdata._tcur);
   mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, mFMUdata._states, mFMUdata._nStates);
 }
 
@@ -310,15 +525,23 @@ void FMUWrapper_ME_1::solveSystem()
   mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, mFMUdata._statesDer, mFMUdata._nStates);
 }
 
-void FMUWrapper_ME_1::doEulerStep()
+void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
 {
-  for (size_t k = 0; k < mFMUdata._nStates; ++k)
-    mFMUdata._states[k] = mFMUdata._states[k] + mFMUdata._hcur * mFMUdata._statesDer[k];
+  mFMUdata._fmiStatus = fmi1_import_completed_integrator_step(mpFMU, (char*)callEventUpdate);
 }
 
-void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
+void FMUWrapper_ME_1::getDerivatives(const double time, const double* states, double* statesDer)
 {
-  mFMUdata._fmiStatus = fmi1_import_completed_integrator_step(mpFMU, (char*)callEventUpdate);
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, time);
+  mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, statesDer, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_1::getEventIndicators(const double time, const double* states, double* eventIndicators)
+{
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, time);
+  mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata._fmiStatus = fmi1_import_get_event_indicators(mpFMU, eventIndicators, mFMUdata._nEventIndicators);
 }
 
 //-------------------------------
@@ -328,8 +551,7 @@ void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
 FMUWrapper_ME_2::FMUWrapper_ME_2()
     : FMUWrapperAbstract(),
       mpFMU(nullptr),
-      mCallBackFunctions(),
-      mFMUdata()
+      mCallBackFunctions()
 {
   mFMUdata.terminateSimulation = fmi2_false;
 }
@@ -355,6 +577,11 @@ void FMUWrapper_ME_2::fmi_get_real(unsigned int* valueRef, double* res)
   fmi2_import_get_real(mpFMU, valueRef, 1, res);
 }
 
+void FMUWrapper_ME_2::fmi_get_reals(const unsigned int* valueRefs, size_t n, double* res)
+{
+  fmi2_import_get_real(mpFMU, valueRefs, n, res);
+}
+
 void FMUWrapper_ME_2::load(const std::string& modelFile, const std::string& path, fmi_import_context_t* context)
 {
   //Callbackfunctions
@@ -464,6 +691,8 @@ const FMUData* FMUWrapper_ME_2::getFMUData()
 
 void FMUWrapper_ME_2::setContinuousStates()
 {
+  // the integrators and the event location leave the FMU at their last trial time, so set the time of the states as well
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, mFMUdata._tcur);
   mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, mFMUdata._states, mFMUdata._nStates);
 }
 
@@ -526,15 +755,23 @@ void FMUWrapper_ME_2::solveSystem()
   mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, mFMUdata._statesDer, mFMUdata._nStates);
 }
 
-void FMUWrapper_ME_2::doEulerStep()
+void FMUWrapper_ME_2::completedIntegratorStep(int* callEventUpdate)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_completed_integrator_step(mpFMU, fmi2_true, (fmi2_boolean_t*)callEventUpdate, &mFMUdata.terminateSimulation);
+}
+
+void FMUWrapper_ME_2::getDerivatives(const double time, const double* states, double* statesDer)
 {
-  for (size_t k = 0; k < mFMUdata._nStates; ++k)
-    mFMUdata._states[k] = mFMUdata._states[k] + mFMUdata._hcur * mFMUdata._statesDer[k];
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, time);
+  mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, statesDer, mFMUdata._nStates);
 }
 
-void FMUWrapper_ME_2::completedIntegratorStep(int* callEventUpdate)
+void FMUWrapper_ME_2::getEventIndicators(const double time, const double* states, double* eventIndicators)
 {
-  mFMUdata.fmiStatus2 = fmi2_import_completed_integrator_step(mpFMU, fmi2_true, (fmi2_boolean_t*)callEventUpdate, &mFMUdata.terminateSimulation);
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, time);
+  mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata.fmiStatus2 = fmi2_import_get_event_indicators(mpFMU, eventIndicators, mFMUdata._nEventIndicators);
 }
 
 unsigned int FMUWrapper_ME_2::fmi_get_variable_by_name(const char* name)
@@ -42,6 +42,7 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <vector>
 
 
 typedef struct
@@ -65,7 +66,9 @@ typedef struct
 enum class Solver
 {
   NONE = 0,
-  EULER_FORWARD = 1
+  EULER_FORWARD = 1,
+  RUNGE_KUTTA = 2,
+  DORMAND_PRINCE = 3
 };
 
 class SimSettingsFMU
@@ -85,6 +88,7 @@ class SimSettingsFMU
   double getRelativeTolerance();
   int getToleranceControlled() const;
   void setSolver(const Solver& solver);
+  Solver getSolver() const;
   int* getCallEventUpdate();
   int getIntermediateResults();
   void setIterateEvents(bool iE);
@@ -119,13 +123,34 @@ class FMUWrapperAbstract
   virtual void updateNextTimeStep(const double hdef) = 0;
   virtual void setLastStepSize(const double simTimeEnd) = 0;
   virtual void solveSystem() = 0;
-  virtual void doEulerStep() = 0;
+  void doStep(const Solver& solver, const double tolerance);
+  bool locateStateEvent(const Solver& solver, const double tolerance);
+  void updateEventIndicators();
   virtual void setContinuousStates() = 0;
   virtual void completedIntegratorStep(int* callEventUpdate) = 0;
 
   virtual const FMUData* getFMUData()  = 0;
   virtual void fmi_get_real(unsigned int* valueRef, double* res) = 0;
+  virtual void fmi_get_reals(const unsigned int* valueRefs, size_t n, double* res) = 0;
   virtual unsigned int fmi_get_variable_by_name(const char* name) = 0;
+ protected:
+  virtual void getDerivatives(const double time, const double* states, double* statesDer) = 0;
+  virtual void getEventIndicators(const double time, const double* states, double* eventIndicators) = 0;
+  void integrate(const Solver& solver, const double time, const double h, const double tolerance, const double* states,
+                 const double* statesDer, double* statesOut);
+
+  FMUData mFMUdata;
+ private:
+  //! The states and derivatives at the beginning of the current step.
+  std::vector<double> mStatesStart;
+  std::vector<double> mStatesDerStart;
+  //! The stages of the Runge-Kutta methods.
+  std::vector<double> mStages[7];
+  std::vector<double> mStatesStage;
+  std::vector<double> mStatesTemp;
+  std::vector<double> mEventIndicatorsTemp;
+  //! The last step size of the Dormand-Prince method, it is used as the first trial step of the next step.
+  double mDormandPrinceStepSize;
 };
 
 class FMUWrapper_ME_1 : public FMUWrapperAbstract
@@ -145,18 +170,21 @@ class FMUWrapper_ME_1 : public FMUWrapperAbstract
   void updateNextTimeStep(const double hdef);
   void setLastStepSize(const double simTimeEnd);
   void solveSystem();
-  void doEulerStep();
   void setContinuousStates();
   void completedIntegratorStep(int* callEventUpdate);
 
   const FMUData* getFMUData();
   void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_reals(const unsigned int* valueRefs, size_t n, double* res);
   unsigned int fmi_get_variable_by_name(const char* name);
 
+ protected:
+  void getDerivatives(const double time, const double* states, double* statesDer);
+  void getEventIndicators(const double time, const double* states, double* eventIndicators);
+
  private:
   fmi1_import_t* mpFMU;
   fmi1_callback_functions_t mCallBackFunctions;
-  FMUData mFMUdata;
 };
 
 
@@ -177,18 +205,21 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
   void prepareSimulationStep(const double time);
   void setLastStepSize(const double simTimeEnd);
   void solveSystem();
-  void doEulerStep();
   void completedIntegratorStep(int* callEventUpdate);
   void do_event_iteration(fmi2_import_t *fmu, fmi2_event_info_t *eventInfo);
 
   const FMUData* getFMUData();
   void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_reals(const unsigned int* valueRefs, size_t n, double* res);
   unsigned int fmi_get_variable_by_name(const char* name);
 
+ protected:
+  void getDerivatives(const double time, const double* states, double* statesDer);
+  void getEventIndicators(const double time, const double* states, double* eventIndicators);
+
  private:
   fmi2_import_t* mpFMU;
   fmi2_callback_functions_t mCallBackFunctions;
-  FMUData mFMUdata;
 };
 
 #endif // end FMUWRAPPER_H
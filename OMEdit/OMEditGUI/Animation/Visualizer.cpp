@@ -44,6 +44,17 @@
 #include <osgDB/Registry>
 #include <osgDB/WriteFile>
 
+#include <QDateTime>
+#include <QFileInfo>
+
+#include <limits>
+#include <unordered_map>
+
+//! Marks the middle frame of the FramePrefetcher as not yet seen by the GUI thread.
+static const int freshFrame = 4;
+//! Masks the frame index of the middle frame.
+static const int frameIndexMask = 3;
+
 OMVisualBase::OMVisualBase(const std::string& modelFile, const std::string& path)
   : _shapes(),
     _modelFile(modelFile),
@@ -314,13 +325,41 @@ void VisualizerAbstract::modifyShape(std::string shapeName)
   int shapeIdx = getBaseData()->getShapeObjectIndexByID(shapeName);
   ShapeObject* shape = getBaseData()->getShapeObjectByID(shapeName);
   shape->setStateSetAction(stateSetAction::modify);
-  mpUpdateVisitor->_shape = *shape;
+  mpUpdateVisitor->_shape = shape;
   osg::ref_ptr<osg::Node> child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
   child->accept(*mpUpdateVisitor);
   shape->setStateSetAction(stateSetAction::update);
 }
 
 
+/*!
+ * \brief VisualizerAbstract::applyFrame
+ * Applies a frame computed by the FramePrefetcher to the shapes and the scene graph.
+ * \param frame
+ * \param handles - the result attribute handles the frame was computed for.
+ */
+void VisualizerAbstract::applyFrame(const VisualizerFrame& frame, const std::vector<ResultAttributeHandle>& handles)
+{
+  for (std::size_t i = 0; i < handles.size(); ++i)
+  {
+    // the attribute might have been made constant by the user e.g., by changing the color of the shape.
+    if (!handles[i].attr->isConst)
+      handles[i].attr->exp = frame.values[i];
+  }
+  unsigned int shapeIdx = 0;
+  osg::ref_ptr<osg::Node> child = nullptr;
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    shape._mat = frame.matrices[shapeIdx];
+    // Update the shapes.
+    mpUpdateVisitor->_shape = &shape;
+    // Get the scene graph nodes and stuff.
+    child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
+    child->accept(*mpUpdateVisitor);
+    ++shapeIdx;
+  }
+}
+
 void VisualizerAbstract::sceneUpdate()
 {
   //measure realtime
@@ -338,6 +377,8 @@ void VisualizerAbstract::sceneUpdate()
       } else {
         mpTimeManager->setVisTime(mpTimeManager->getEndTime());
       }
+      // compute the next frame while the current one is rendered.
+      prefetchVisAttributes(mpTimeManager->getVisTime());
     }
   }
 }
@@ -388,6 +429,186 @@ void VisualizerAbstract::pauseVisualization()
 
 
 
+FramePrefetcher::FramePrefetcher()
+  : mShapeGeometries(),
+    mHandleValues(),
+    mpTimeValues(nullptr),
+    mNumTimePoints(0),
+    mFrontFrame(0),
+    mBackFrame(1),
+    mMiddleFrame(2),
+    mPrefetchTime(std::numeric_limits<double>::lowest()),
+    mStop(true),
+    mTimeIndex(0)
+{
+  for (auto& frame : mFrames)
+    frame.time = std::numeric_limits<double>::lowest();
+}
+
+FramePrefetcher::~FramePrefetcher()
+{
+  stop();
+}
+
+/*!
+ * \brief FramePrefetcher::setUp
+ * Stores how the transformation of each shape is computed from the result attribute handles and starts the prefetch thread.\n
+ * The attributes without a handle keep their current value.
+ * The handle values and time values must stay valid until stop() is called.
+ * \param shapes
+ * \param handles
+ * \param timeValues
+ * \param numTimePoints
+ */
+void FramePrefetcher::setUp(const std::vector<ShapeObject>& shapes, const std::vector<ResultAttributeHandle>& handles,
+                            const double* timeValues, unsigned int numTimePoints)
+{
+  stop();
+  std::unordered_map<const ShapeObjectAttribute*, int> handleIndexes;
+  mHandleValues.clear();
+  mHandleValues.reserve(handles.size());
+  for (std::size_t i = 0; i < handles.size(); ++i)
+  {
+    handleIndexes[handles[i].attr] = i;
+    mHandleValues.push_back(handles[i].values);
+  }
+  mShapeGeometries.clear();
+  mShapeGeometries.reserve(shapes.size());
+  for (const auto& shape : shapes)
+  {
+    // the order must match computeFrame.
+    const ShapeObjectAttribute* attributes[numGeometryAttributes] = {
+      &shape._r[0], &shape._r[1], &shape._r[2], &shape._rShape[0], &shape._rShape[1], &shape._rShape[2],
+      &shape._T[0], &shape._T[1], &shape._T[2], &shape._T[3], &shape._T[4], &shape._T[5], &shape._T[6], &shape._T[7], &shape._T[8],
+      &shape._lDir[0], &shape._lDir[1], &shape._lDir[2], &shape._wDir[0], &shape._wDir[1], &shape._wDir[2], &shape._length};
+    ShapeGeometry geometry;
+    for (int i = 0; i < numGeometryAttributes; ++i)
+    {
+      auto it = handleIndexes.find(attributes[i]);
+      geometry.handles[i] = (it == handleIndexes.end()) ? -1 : it->second;
+      geometry.values[i] = attributes[i]->exp;
+    }
+    geometry.type = shape._type;
+    mShapeGeometries.push_back(geometry);
+  }
+  mpTimeValues = timeValues;
+  mNumTimePoints = numTimePoints;
+  mTimeIndex = 0;
+  for (auto& frame : mFrames)
+    frame.time = std::numeric_limits<double>::lowest();
+  mFrontFrame = 0;
+  mBackFrame = 1;
+  mMiddleFrame = 2;
+  mPrefetchTime = std::numeric_limits<double>::lowest();
+  mStop = false;
+  mThread = std::thread(&FramePrefetcher::run, this);
+}
+
+/*!
+ * \brief FramePrefetcher::stop
+ * Stops the prefetch thread.
+ */
+void FramePrefetcher::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_one();
+  if (mThread.joinable())
+    mThread.join();
+}
+
+/*!
+ * \brief FramePrefetcher::prefetch
+ * Asks the prefetch thread to compute the frame at time.
+ * \param time
+ */
+void FramePrefetcher::prefetch(const double time)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPrefetchTime = time;
+  }
+  mCondition.notify_one();
+}
+
+/*!
+ * \brief FramePrefetcher::getFrame
+ * Returns the frame at time.\n
+ * Takes the latest frame of the prefetch thread if there is one and computes the frame on the calling thread if it is for another time, e.g., after seeking.
+ * \param time
+ * \return
+ */
+const VisualizerFrame& FramePrefetcher::getFrame(const double time)
+{
+  if (mMiddleFrame.load() & freshFrame)
+    mFrontFrame = mMiddleFrame.exchange(mFrontFrame) & frameIndexMask;
+  VisualizerFrame& frame = mFrames[mFrontFrame];
+  if (frame.time != time)
+    computeFrame(time, frame, mTimeIndex);
+  return frame;
+}
+
+/*!
+ * \brief FramePrefetcher::computeFrame
+ * Interpolates the result attribute handles at time and computes the transformations of the shapes.
+ * \param time
+ * \param frame
+ * \param timeIndex - the interpolation interval hint of the calling thread.
+ */
+void FramePrefetcher::computeFrame(const double time, VisualizerFrame& frame, unsigned int& timeIndex) const
+{
+  // Find the interpolation interval once for all the attributes.
+  unsigned int index2 = 0;
+  double weight = 0.0;
+  findTimeInterval(mpTimeValues, mNumTimePoints, time, timeIndex, index2, weight);
+  const unsigned int index1 = timeIndex;
+  frame.values.resize(mHandleValues.size());
+  for (std::size_t i = 0; i < mHandleValues.size(); ++i)
+  {
+    const double* values = mHandleValues[i];
+    frame.values[i] = values[index1] + weight * (values[index2] - values[index1]);
+  }
+  frame.matrices.resize(mShapeGeometries.size());
+  float v[numGeometryAttributes];
+  for (std::size_t shapeIdx = 0; shapeIdx < mShapeGeometries.size(); ++shapeIdx)
+  {
+    const ShapeGeometry& geometry = mShapeGeometries[shapeIdx];
+    for (int i = 0; i < numGeometryAttributes; ++i)
+      v[i] = geometry.handles[i] < 0 ? geometry.values[i] : frame.values[geometry.handles[i]];
+    rAndT rT = rotateModelica2OSG(osg::Vec3f(v[0], v[1], v[2]), osg::Vec3f(v[3], v[4], v[5]),
+        osg::Matrix3(v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13], v[14]),
+        osg::Vec3f(v[15], v[16], v[17]), osg::Vec3f(v[18], v[19], v[20]), v[21], geometry.type);
+    assemblePokeMatrix(frame.matrices[shapeIdx], rT._T, rT._r);
+  }
+  frame.time = time;
+}
+
+/*!
+ * \brief FramePrefetcher::run
+ * The prefetch thread. Computes the requested frame into the back frame and publishes it as the middle frame.
+ */
+void FramePrefetcher::run()
+{
+  unsigned int timeIndex = 0;
+  double computedTime = std::numeric_limits<double>::lowest();
+  while (true)
+  {
+    double time;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCondition.wait(lock, [&] {return mStop || mPrefetchTime != computedTime;});
+      if (mStop)
+        return;
+      time = mPrefetchTime;
+    }
+    computeFrame(time, mFrames[mBackFrame], timeIndex);
+    mBackFrame = mMiddleFrame.exchange(mBackFrame | freshFrame) & frameIndexMask;
+    computedTime = time;
+  }
+}
+
 OMVisScene::OMVisScene()
   : _scene()
 {
@@ -432,17 +653,15 @@ int OSGScene::setUpScene(std::vector<ShapeObject> allShapes)
     if (shape._type.compare("stl") == 0)
     {
       //std::cout<<"Its a CAD and the filename is "<<shape._fileName<<std::endl;
-      osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(shape._fileName);
+      osg::ref_ptr<osg::Node> node = getCADNode(shape._fileName);
       osg::ref_ptr<osg::StateSet> ss = node->getOrCreateStateSet();
       ss->setAttribute(material.get());
       node->setStateSet(ss);
       transf->addChild(node.get());
     }
     else if ((shape._type.compare("dxf") == 0)) {
-      std::string name = shape._fileName;
-      DXFile* shape = new DXFile(name);
       geode = new osg::Geode();
-      geode->addDrawable(shape);
+      geode->addDrawable(getDXFDrawable(shape._fileName));
       transf->addChild(geode);
     }
     //geode with shape drawable
@@ -477,9 +696,59 @@ void OSGScene::setPath(const std::string path)
   _path = path;
 }
 
+/*!
+ * \brief meshCacheKey
+ * Returns the key of a CAD file in the mesh cache. The modification time is part of the key so that a changed file is read again.
+ */
+static std::string meshCacheKey(const std::string& fileName)
+{
+  QFileInfo fileInfo(QString::fromStdString(fileName));
+  return fileName + "|" + fileInfo.lastModified().toString(Qt::ISODate).toStdString();
+}
+
+/*!
+ * \brief OSGScene::getCADNode
+ * Returns a node for the stl file. The file is only read once, every further instance is a copy of the node hierarchy
+ * and its state sets that shares the drawables, i.e. the geometry, with the cached node.
+ * \param fileName
+ * \return
+ */
+osg::ref_ptr<osg::Node> OSGScene::getCADNode(const std::string& fileName)
+{
+  std::string key = meshCacheKey(fileName);
+  std::unordered_map<std::string, osg::ref_ptr<osg::Node>>::iterator it = _cadNodeCache.find(key);
+  if (it == _cadNodeCache.end())
+  {
+    it = _cadNodeCache.insert(std::make_pair(key, osgDB::readNodeFile(fileName))).first;
+  }
+  if (!it->second.valid())
+  {
+    return it->second;
+  }
+  // each instance needs its own state sets since the color and transparency are set per shape
+  return osg::clone(it->second.get(), osg::CopyOp(osg::CopyOp::DEEP_COPY_NODES | osg::CopyOp::DEEP_COPY_STATESETS | osg::CopyOp::DEEP_COPY_STATEATTRIBUTES));
+}
+
+/*!
+ * \brief OSGScene::getDXFDrawable
+ * Returns the drawable of the dxf file. The file is only parsed once and the drawable is shared by all geodes using it.
+ * \param fileName
+ * \return
+ */
+osg::ref_ptr<osg::Drawable> OSGScene::getDXFDrawable(const std::string& fileName)
+{
+  std::string key = meshCacheKey(fileName);
+  std::unordered_map<std::string, osg::ref_ptr<osg::Drawable>>::iterator it = _dxfDrawableCache.find(key);
+  if (it == _dxfDrawableCache.end())
+  {
+    it = _dxfDrawableCache.insert(std::make_pair(key, osg::ref_ptr<osg::Drawable>(new DXFile(fileName)))).first;
+  }
+  return it->second;
+}
+
 
 UpdateVisitor::UpdateVisitor()
-  : _shape()
+  : _shape(nullptr)
 {
   setTraversalMode(NodeVisitor::TRAVERSE_ALL_CHILDREN);
 }
@@ -490,7 +759,7 @@ UpdateVisitor::UpdateVisitor()
 void UpdateVisitor::apply(osg::MatrixTransform& node)
 {
   //std::cout<<"MT "<<node.className()<<"  "<<node.getName()<<std::endl;
-  node.setMatrix(_shape._mat);
+  node.setMatrix(_shape->_mat);
   traverse(node);
 }
 
@@ -499,56 +768,93 @@ void UpdateVisitor::apply(osg::MatrixTransform& node)
  */
 void UpdateVisitor::apply(osg::Geode& node)
 {
-  //std::cout<<"GEODE "<< _shape._id<<" "<<_shape.getTransparency()<<std::endl;
+  //std::cout<<"GEODE "<< _shape->_id<<" "<<_shape->getTransparency()<<std::endl;
   osg::ref_ptr<osg::StateSet> ss = node.getOrCreateStateSet();
-  node.setName(_shape._id);
-  switch(_shape.getStateSetAction())
+  node.setName(_shape->_id);
+  switch(_shape->getStateSetAction())
   {
   case(stateSetAction::update):
    {
-    //its a drawable and not a cad file so we have to create a new drawable
-    if (_shape._type.compare("dxf") != 0 and (_shape._type.compare("stl") != 0))
+    //its a drawable and not a cad file so we have to update the drawable
+    //the drawables are only created again if their parameters have changed
+    if (_shape->_type.compare("dxf") != 0 and (_shape->_type.compare("stl") != 0))
     {
     osg::ref_ptr<osg::Drawable> draw = node.getDrawable(0);
-    draw->dirtyDisplayList();
-    if (_shape._type == "pipe")
+    if ((_shape->_type == "pipe") || (_shape->_type == "pipecylinder"))
     {
-      node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
-    }
-    else if (_shape._type == "pipecylinder")
-    {
-      node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
+      float rI = (_shape->_width.exp * _shape->_extra.exp) / 2;
+      float rO = (_shape->_width.exp) / 2;
+      Pipecylinder* pipe = dynamic_cast<Pipecylinder*>(draw.get());
+      if (pipe && pipe->hasRadii(rI, rO))
+      {
+        pipe->setLength(_shape->_length.exp);
+      }
+      else
+      {
+        node.removeDrawable(draw);
+        node.addDrawable(new Pipecylinder(rI, rO, _shape->_length.exp));
+      }
     }
-    else if (_shape._type == "spring")
+    else if (_shape->_type == "spring")
     {
-      node.removeDrawable(draw);
-      draw = new Spring(_shape._width.exp, _shape._height.exp, _shape._extra.exp, _shape._length.exp);
+      Spring* spring = dynamic_cast<Spring*>(draw.get());
+      if (spring)
+      {
+        spring->setParameters(_shape->_width.exp, _shape->_height.exp, _shape->_extra.exp, _shape->_length.exp);
+      }
+      else
+      {
+        node.removeDrawable(draw);
+        node.addDrawable(new Spring(_shape->_width.exp, _shape->_height.exp, _shape->_extra.exp, _shape->_length.exp));
+      }
     }
-    else if (_shape._type == "cylinder")
+    else if (_shape->_type == "cylinder")
     {
-      draw->setShape(new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
+      float radius = _shape->_width.exp / 2.0;
+      osg::Cylinder* cylinder = dynamic_cast<osg::Cylinder*>(draw->getShape());
+      if (!cylinder || cylinder->getRadius() != radius || cylinder->getHeight() != _shape->_length.exp)
+      {
+        draw->setShape(new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), radius, _shape->_length.exp));
+        draw->dirtyDisplayList();
+      }
     }
-    else if (_shape._type == "box")
+    else if (_shape->_type == "box")
     {
-      draw->setShape(new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp, _shape._height.exp, _shape._length.exp));
+      osg::Vec3f halfLengths(_shape->_width.exp / 2.0, _shape->_height.exp / 2.0, _shape->_length.exp / 2.0);
+      osg::Box* box = dynamic_cast<osg::Box*>(draw->getShape());
+      if (!box || box->getHalfLengths() != halfLengths)
+      {
+        draw->setShape(new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), _shape->_width.exp, _shape->_height.exp, _shape->_length.exp));
+        draw->dirtyDisplayList();
+      }
     }
-    else if (_shape._type == "cone")
+    else if (_shape->_type == "cone")
     {
-      draw->setShape(new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
+      float radius = _shape->_width.exp / 2.0;
+      osg::Cone* cone = dynamic_cast<osg::Cone*>(draw->getShape());
+      if (!cone || cone->getRadius() != radius || cone->getHeight() != _shape->_length.exp)
+      {
+        draw->setShape(new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), radius, _shape->_length.exp));
+        draw->dirtyDisplayList();
+      }
     }
-    else if (_shape._type == "sphere")
+    else if (_shape->_type == "sphere")
     {
-      draw->setShape(new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), _shape._length.exp / 2.0));
+      float radius = _shape->_length.exp / 2.0;
+      osg::Sphere* sphere = dynamic_cast<osg::Sphere*>(draw->getShape());
+      if (!sphere || sphere->getRadius() != radius)
+      {
+        draw->setShape(new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), radius));
+        draw->dirtyDisplayList();
+      }
     }
-    else
+    else if (!dynamic_cast<osg::Capsule*>(draw->getShape()))
     {
-      std::cout<<"Unknown type "<<_shape._type<<", we make a capsule."<<std::endl;
+      std::cout<<"Unknown type "<<_shape->_type<<", we make a capsule."<<std::endl;
       draw->setShape(new osg::Capsule(osg::Vec3f(0.0, 0.0, 0.0), 0.1, 0.5));
+      draw->dirtyDisplayList();
     }
     //std::cout<<"SHAPE "<<draw->getShape()->className()<<std::endl;
-    node.addDrawable(draw.get());
     }
     break;
    }//end case
@@ -556,7 +862,7 @@ void UpdateVisitor::apply(osg::Geode& node)
   case(stateSetAction::modify):
    {
      //apply texture
-     applyTexture(ss, _shape.getTextureImagePath());
+     applyTexture(ss, _shape->getTextureImagePath());
      break;
    }//end case
 
@@ -565,12 +871,21 @@ void UpdateVisitor::apply(osg::Geode& node)
 
   }//end switch
 
-  //set color
-  if (_shape._type.compare("dxf") != 0)
-    changeColor(ss, _shape._color[0].exp, _shape._color[1].exp, _shape._color[2].exp);
+  //set color and transparency, only if they differ from the material of the previous frame
+  osg::Material* material = dynamic_cast<osg::Material*>(ss->getAttribute(osg::StateAttribute::MATERIAL));
+  osg::Vec4f diffuse = material ? material->getDiffuse(osg::Material::FRONT) : osg::Vec4f();
+  float alpha = _shape->getTransparency() ? 1.0f - _shape->getTransparency() : 1.0f;
+  bool colorChanged = _shape->_type.compare("dxf") != 0
+      && (!material || osg::Vec3f(diffuse[0], diffuse[1], diffuse[2]) != osg::Vec3f(_shape->_color[0].exp / 255, _shape->_color[1].exp / 255, _shape->_color[2].exp / 255));
+  if (colorChanged || !material || diffuse[3] != alpha)
+  {
+    //set color
+    if (_shape->_type.compare("dxf") != 0)
+      changeColor(ss, _shape->_color[0].exp, _shape->_color[1].exp, _shape->_color[2].exp);
 
-  //set transparency
-  makeTransparent(node, _shape.getTransparency());
+    //set transparency
+    makeTransparent(node, _shape->getTransparency());
+  }
 
   node.setStateSet(ss);
   traverse(node);
@@ -658,7 +973,7 @@ osg::Image* UpdateVisitor::convertImage(const QImage& iImage)
  */
 void UpdateVisitor::makeTransparent(osg::Geode& node, float transpCoeff)
 {
-  if (_shape.getTransparency())
+  if (_shape->getTransparency())
       {
       node.getStateSet()->setMode( GL_BLEND, osg::StateAttribute::ON );
       node.getStateSet()->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
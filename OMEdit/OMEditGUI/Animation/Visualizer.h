@@ -38,6 +38,12 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <QImage>
 #include <osg/NodeVisitor>
@@ -74,7 +80,8 @@ class UpdateVisitor : public osg::NodeVisitor
   void changeColor(osg::StateSet* ss, float r, float g, float b);
   osg::Image* convertImage(const QImage& iImage);
 public:
-  ShapeObject _shape;
+  //! The shape to apply, it is not copied since the visitor is applied to every shape in every frame.
+  ShapeObject* _shape;
 };
 
 class InfoVisitor : public osg::NodeVisitor
@@ -103,8 +110,13 @@ class OSGScene
   std::string getPath() const;
   void setPath(const std::string path);
  private:
+  osg::ref_ptr<osg::Node> getCADNode(const std::string& fileName);
+  osg::ref_ptr<osg::Drawable> getDXFDrawable(const std::string& fileName);
   osg::ref_ptr<osg::Group> _rootNode;
   std::string _path;
+  //! The loaded stl and dxf meshes, keyed by file name and modification time. Every shape instance shares them.
+  std::unordered_map<std::string, osg::ref_ptr<osg::Node>> _cadNodeCache;
+  std::unordered_map<std::string, osg::ref_ptr<osg::Drawable>> _dxfDrawableCache;
 };
 
 class OMVisScene
@@ -148,6 +160,67 @@ public:
   rapidxml::xml_document<> _xmlDoc;
 };
 
+/*!
+ * \brief The VisualizerFrame struct
+ * The state of all the shapes at one visualization time.
+ * values holds the value of each result attribute handle and matrices the transformation of each shape.
+ */
+struct VisualizerFrame
+{
+  double time;
+  std::vector<float> values;
+  std::vector<osg::Matrix> matrices;
+};
+
+/*!
+ * \brief The FramePrefetcher class
+ * Computes the next frame of a result file animation on a background thread while the current frame is rendered.\n
+ * The frames are exchanged through a lock-free triple buffer, the GUI thread only swaps and applies them.
+ */
+class FramePrefetcher
+{
+ public:
+  FramePrefetcher();
+  ~FramePrefetcher();
+  FramePrefetcher(const FramePrefetcher& fp) = delete;
+  FramePrefetcher& operator=(const FramePrefetcher& fp) = delete;
+  void setUp(const std::vector<ShapeObject>& shapes, const std::vector<ResultAttributeHandle>& handles,
+             const double* timeValues, unsigned int numTimePoints);
+  void stop();
+  void prefetch(const double time);
+  const VisualizerFrame& getFrame(const double time);
+ private:
+  //! The number of attributes needed for the transformation of a shape.
+  static const int numGeometryAttributes = 22;
+  struct ShapeGeometry
+  {
+    //! The index of the result attribute handle or -1 if the attribute has the constant value.
+    int handles[numGeometryAttributes];
+    float values[numGeometryAttributes];
+    std::string type;
+  };
+  void computeFrame(const double time, VisualizerFrame& frame, unsigned int& timeIndex) const;
+  void run();
+
+  std::vector<ShapeGeometry> mShapeGeometries;
+  std::vector<const double*> mHandleValues;
+  const double* mpTimeValues;
+  unsigned int mNumTimePoints;
+  VisualizerFrame mFrames[3];
+  //! The frame used by the GUI thread.
+  int mFrontFrame;
+  //! The frame written by the prefetch thread.
+  int mBackFrame;
+  //! The frame exchanged between the threads. freshFrame is set when the prefetch thread has published a new frame.
+  std::atomic<int> mMiddleFrame;
+  std::atomic<double> mPrefetchTime;
+  std::atomic<bool> mStop;
+  unsigned int mTimeIndex;
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+};
+
 class VisualizerAbstract
 {
  public:
@@ -160,6 +233,7 @@ class VisualizerAbstract
   void setUpScene();
   virtual void initializeVisAttributes(const double time) = 0;
   virtual void updateVisAttributes(const double time) = 0;
+  virtual void prefetchVisAttributes(const double time) {Q_UNUSED(time);}
   void sceneUpdate();
   void modifyShape(std::string shapeName);
   virtual void simulate(TimeManager& omvm) = 0;
@@ -175,6 +249,8 @@ class VisualizerAbstract
   virtual void startVisualization();
   virtual void pauseVisualization();
 protected:
+  void applyFrame(const VisualizerFrame& frame, const std::vector<ResultAttributeHandle>& handles);
+
   const VisType _visType;
   OMVisualBase* mpOMVisualBase;
   OMVisScene* mpOMVisScene;
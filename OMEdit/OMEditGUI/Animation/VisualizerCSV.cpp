@@ -34,13 +34,16 @@
 #include "VisualizerCSV.h"
 
 VisualizerCSV::VisualizerCSV(const std::string& modelFile, const std::string& path)
-  : VisualizerAbstract(modelFile, path, VisType::CSV), mpCSVData(0)
+  : VisualizerAbstract(modelFile, path, VisType::CSV), mpCSVData(0), mVariableDataSets(), mAttributeHandles(),
+    mpTimeValues(nullptr), mNumTimePoints(0), mTimeIndex(0), mFramePrefetcher()
 {
 
 }
 
 VisualizerCSV::~VisualizerCSV()
 {
+  // the prefetch thread reads the columns of the CSV data.
+  mFramePrefetcher.stop();
   if (mpCSVData) {
     omc_free_csv_reader(mpCSVData);
   }
@@ -48,13 +51,15 @@ VisualizerCSV::~VisualizerCSV()
 
 void VisualizerCSV::initData()
 {
+  mFramePrefetcher.stop();
   VisualizerAbstract::initData();
   readCSV(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
-  double *time = read_csv_dataset(mpCSVData, "time");
-  if (time) {
-    mpTimeManager->setStartTime(time[0]);
-    mpTimeManager->setEndTime(time[mpCSVData->numsteps - 1]);
+  resolveVisAttributes();
+  if (mpTimeValues && mNumTimePoints > 0) {
+    mpTimeManager->setStartTime(mpTimeValues[0]);
+    mpTimeManager->setEndTime(mpTimeValues[mNumTimePoints - 1]);
   }
+  mFramePrefetcher.setUp(mpOMVisualBase->_shapes, mAttributeHandles, mpTimeValues, mNumTimePoints);
 }
 
 void VisualizerCSV::initializeVisAttributes(const double time)
@@ -74,7 +79,11 @@ void VisualizerCSV::readCSV(const std::string& modelFile, const std::string& pat
     std::string msg = "Could not find CSV file" + resFileName + ".";
     std::cout<<msg<<std::endl;
   } else {
-    // Read mat file.
+    // In case of reloading, free the previously read file.
+    if (mpCSVData) {
+      omc_free_csv_reader(mpCSVData);
+    }
+    // Read csv file.
     mpCSVData = read_csv(resFileName.c_str());
     // Check return value.
     if (!mpCSVData) {
@@ -84,73 +93,16 @@ void VisualizerCSV::readCSV(const std::string& modelFile, const std::string& pat
   }
 }
 
+/*!
+ * \brief VisualizerCSV::updateVisAttributes
+ * Updates the visualization attributes of all the shapes at the given time.\n
+ * The frame is usually already computed by the prefetch thread from the columns resolved by resolveVisAttributes.
+ * \param time
+ */
 void VisualizerCSV::updateVisAttributes(const double time)
 {
-  //std::cout<<"updateVisAttributes at "<<time <<std::endl;
-  // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
   try {
-    for (ShapeObject &shape : mpOMVisualBase->_shapes) {
-      //std::cout<<"shape "<<shape._id <<std::endl;
-
-      // Get the values for the scene graph objects
-      updateObjectAttributeCSV(&shape._length, time);
-      updateObjectAttributeCSV(&shape._width, time);
-      updateObjectAttributeCSV(&shape._height, time);
-
-      updateObjectAttributeCSV(&shape._lDir[0], time);
-      updateObjectAttributeCSV(&shape._lDir[1], time);
-      updateObjectAttributeCSV(&shape._lDir[2], time);
-
-      updateObjectAttributeCSV(&shape._wDir[0], time);
-      updateObjectAttributeCSV(&shape._wDir[1], time);
-      updateObjectAttributeCSV(&shape._wDir[2], time);
-
-      updateObjectAttributeCSV(&shape._r[0], time);
-      updateObjectAttributeCSV(&shape._r[1], time);
-      updateObjectAttributeCSV(&shape._r[2], time);
-
-      updateObjectAttributeCSV(&shape._rShape[0], time);
-      updateObjectAttributeCSV(&shape._rShape[1], time);
-      updateObjectAttributeCSV(&shape._rShape[2], time);
-
-      updateObjectAttributeCSV(&shape._T[0], time);
-      updateObjectAttributeCSV(&shape._T[1], time);
-      updateObjectAttributeCSV(&shape._T[2], time);
-      updateObjectAttributeCSV(&shape._T[3], time);
-      updateObjectAttributeCSV(&shape._T[4], time);
-      updateObjectAttributeCSV(&shape._T[5], time);
-      updateObjectAttributeCSV(&shape._T[6], time);
-      updateObjectAttributeCSV(&shape._T[7], time);
-      updateObjectAttributeCSV(&shape._T[8], time);
-
-      updateObjectAttributeCSV(&shape._color[0], time);
-      updateObjectAttributeCSV(&shape._color[1], time);
-      updateObjectAttributeCSV(&shape._color[2], time);
-
-      updateObjectAttributeCSV(&shape._specCoeff, time);
-      updateObjectAttributeCSV(&shape._extra, time);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
-    }
+    applyFrame(mFramePrefetcher.getFrame(time), mAttributeHandles);
   } catch (std::exception& ex) {
     std::string msg = "Error in VisualizerCSV::updateVisAttributes at time point " + std::to_string(time)
         + "\n" + std::string(ex.what());
@@ -158,6 +110,16 @@ void VisualizerCSV::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerCSV::prefetchVisAttributes
+ * Starts computing the visualization attributes of the next frame on the prefetch thread.
+ * \param time
+ */
+void VisualizerCSV::prefetchVisAttributes(const double time)
+{
+  mFramePrefetcher.prefetch(time);
+}
+
 void VisualizerCSV::updateScene(const double time)
 {
   mpTimeManager->updateTick();  //for real-time measurement
@@ -175,25 +137,90 @@ void VisualizerCSV::updateObjectAttributeCSV(ShapeObjectAttribute* attr, double
   }
 }
 
+/*!
+ * \brief VisualizerCSV::omcGetVarValue
+ * Returns the linearly interpolated value of the variable at the given time.
+ * \param varName
+ * \param time
+ * \return
+ */
 double VisualizerCSV::omcGetVarValue(const char* varName, double time)
 {
-  double *timeDataSet = read_csv_dataset(mpCSVData, "time");
-  for (int i = 0 ; i < mpCSVData->numsteps ; i++) {
-    if (timeDataSet[i] == time) {
-      double *varDataSet = read_csv_dataset(mpCSVData, varName);
-      if (varDataSet) {
-        return varDataSet[i];
-      } else {
-        std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
-      }
-    } else if ((time > timeDataSet[i]) && (i + 1 < mpCSVData->numsteps) && (time < timeDataSet[i + 1])) { // interpolate
-      double *varDataSet = read_csv_dataset(mpCSVData, varName);
-      if (varDataSet) {
-        return (varDataSet[i] + varDataSet[i + 1]) / 2;
-      } else {
-        std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
-      }
+  std::unordered_map<std::string, double*>::const_iterator it = mVariableDataSets.find(varName);
+  if (it == mVariableDataSets.end()) {
+    std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
+    return 0.0;
+  }
+  unsigned int index1 = mTimeIndex;
+  unsigned int index2 = 0;
+  double weight = 0.0;
+  findTimeInterval(mpTimeValues, mNumTimePoints, time, index1, index2, weight);
+  const double* varDataSet = it->second;
+  return varDataSet[index1] + weight * (varDataSet[index2] - varDataSet[index1]);
+}
+
+/*!
+ * \brief VisualizerCSV::resolveVisAttributes
+ * Indexes the columns of the CSV file by name and resolves the attributes of all the shapes once.
+ * Afterwards updateVisAttributes doesn't need to search the variables by name.
+ */
+void VisualizerCSV::resolveVisAttributes()
+{
+  mVariableDataSets.clear();
+  mAttributeHandles.clear();
+  mpTimeValues = nullptr;
+  mNumTimePoints = 0;
+  mTimeIndex = 0;
+  if (!mpCSVData) {
+    return;
+  }
+  // the data is stored column wise, see read_csv_dataset.
+  for (int i = 0 ; i < mpCSVData->numvars ; i++) {
+    mVariableDataSets.insert(std::make_pair(std::string(mpCSVData->variables[i]), mpCSVData->data + i * mpCSVData->numsteps));
+  }
+  std::unordered_map<std::string, double*>::const_iterator timeIt = mVariableDataSets.find("time");
+  if (timeIt != mVariableDataSets.end()) {
+    mpTimeValues = timeIt->second;
+    mNumTimePoints = mpCSVData->numsteps;
+  }
+
+  for (ShapeObject &shape : mpOMVisualBase->_shapes) {
+    resolveObjectAttributeCSV(&shape._length);
+    resolveObjectAttributeCSV(&shape._width);
+    resolveObjectAttributeCSV(&shape._height);
+    for (int i = 0 ; i < 3 ; i++) {
+      resolveObjectAttributeCSV(&shape._lDir[i]);
+      resolveObjectAttributeCSV(&shape._wDir[i]);
+      resolveObjectAttributeCSV(&shape._r[i]);
+      resolveObjectAttributeCSV(&shape._rShape[i]);
+      resolveObjectAttributeCSV(&shape._color[i]);
+    }
+    for (int i = 0 ; i < 9 ; i++) {
+      resolveObjectAttributeCSV(&shape._T[i]);
     }
+    resolveObjectAttributeCSV(&shape._specCoeff);
+    resolveObjectAttributeCSV(&shape._extra);
+  }
+}
+
+/*!
+ * \brief VisualizerCSV::resolveObjectAttributeCSV
+ * Resolves a single attribute to its column in the CSV file.
+ * \param attr
+ */
+void VisualizerCSV::resolveObjectAttributeCSV(ShapeObjectAttribute* attr)
+{
+  if (attr->isConst) {
+    return;
+  }
+  std::unordered_map<std::string, double*>::const_iterator it = mVariableDataSets.find(attr->cref);
+  if (it == mVariableDataSets.end() || mNumTimePoints == 0) {
+    std::cout<<"Did not get variable from result file. Variable name is "<<attr->cref<<std::endl;
+    attr->exp = 0.0;
+  } else {
+    ResultAttributeHandle handle;
+    handle.attr = attr;
+    handle.values = it->second;
+    mAttributeHandles.push_back(handle);
   }
-  return 0.0;
 }
@@ -36,6 +36,8 @@
 #include "Visualizer.h"
 #include "util/read_csv.h"
 
+#include <unordered_map>
+
 class VisualizerCSV : public VisualizerAbstract
 {
 public:
@@ -49,11 +51,20 @@ public:
   void readCSV(const std::string& modelFile, const std::string& path);
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
+  void prefetchVisAttributes(const double time) override;
   void updateScene(const double time) override;
   void updateObjectAttributeCSV(ShapeObjectAttribute* attr, double time);
   double omcGetVarValue(const char* varName, double time);
+  void resolveVisAttributes();
+  void resolveObjectAttributeCSV(ShapeObjectAttribute* attr);
 private:
   csv_data *mpCSVData;
+  std::unordered_map<std::string, double*> mVariableDataSets;
+  std::vector<ResultAttributeHandle> mAttributeHandles;
+  const double* mpTimeValues;
+  unsigned int mNumTimePoints;
+  unsigned int mTimeIndex;
+  FramePrefetcher mFramePrefetcher;
 };
 
 #endif // VISUALIZERCSV_H
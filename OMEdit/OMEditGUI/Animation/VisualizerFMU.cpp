@@ -35,15 +35,27 @@
 
 #include "VisualizerFMU.h"
 
+#include <algorithm>
+
+//! The maximum number of frames the simulation thread computes ahead of the visualization.
+static const std::size_t maxBufferedFrames = 8;
 
 VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& path)
     : VisualizerAbstract(modelFile, path, VisType::FMU),
       mpFMU(nullptr),
-      mpSimSettings(new SimSettingsFMU())
+      mpSimSettings(new SimSettingsFMU()),
+      mFMUAttributes(),
+      mValueReferences(),
+      mValues(),
+      mFrames(),
+      mFrameStep(0.0),
+      mLastUpdateRealTime(0.0),
+      mStopSimulation(true)
 {
 }
  VisualizerFMU::~VisualizerFMU()
  {
+   stopSimulationThread();
    if (mpFMU){
      free(mpFMU);
    }
@@ -52,6 +64,9 @@ VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& pa
 
 void VisualizerFMU::initData()
 {
+  // the simulation thread uses the FMU and the shapes are reallocated
+  stopSimulationThread();
+  mFrames.clear();
   VisualizerAbstract::initData();
   loadFMU(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
   mpSimSettings->setTend(mpTimeManager->getEndTime());
@@ -116,6 +131,8 @@ unsigned int VisualizerFMU::getVarReferencesForObjectAttribute(ShapeObjectAttrib
 int VisualizerFMU::setVarReferencesInVisAttributes()
 {
   int isOk(0);
+  mFMUAttributes.clear();
+  mValueReferences.clear();
 
   try
   {
@@ -154,6 +171,21 @@ int VisualizerFMU::setVarReferencesInVisAttributes()
       shape._T[7].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[7]);
       shape._T[8].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[8]);
 
+      // the attributes which are read from the FMU in every frame
+      ShapeObjectAttribute* attributes[] = {
+        &shape._length, &shape._width, &shape._height, &shape._lDir[0], &shape._lDir[1], &shape._lDir[2],
+        &shape._wDir[0], &shape._wDir[1], &shape._wDir[2], &shape._r[0], &shape._r[1], &shape._r[2],
+        &shape._rShape[0], &shape._rShape[1], &shape._rShape[2], &shape._T[0], &shape._T[1], &shape._T[2],
+        &shape._T[3], &shape._T[4], &shape._T[5], &shape._T[6], &shape._T[7], &shape._T[8]};
+      for (ShapeObjectAttribute* attr : attributes)
+      {
+        if (!attr->isConst)
+        {
+          mFMUAttributes.push_back(attr);
+          mValueReferences.push_back(attr->fmuValueRef);
+        }
+      }
+
       //shape.dumpVisAttributes();
       mpOMVisualBase->_shapes.at(i) = shape;
       ++i;
@@ -183,10 +215,11 @@ double VisualizerFMU::simulateStep(const double time)
   bool zeroCrossingEvent = mpFMU->checkForTriggeredEvent();
 
   // Handle any events
-  if (mpSimSettings->getIterateEvents() && (mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
+  if (mpSimSettings->getIterateEvents() && (*mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
   {
     mpFMU->handleEvents(mpSimSettings->getIntermediateResults());
   }
+  mpFMU->updateEventIndicators();
 
   // Updated next time step
   mpFMU->updateNextTimeStep(mpSimSettings->getHdef());
@@ -205,8 +238,14 @@ double VisualizerFMU::simulateStep(const double time)
   //fmi1_import_get_real(mpFMUl.mpFMU, &vr, 1, &value);
   //std::cout<<"value "<<value<<std::endl;
 
-  // integrate a step with euler
-  mpFMU->doEulerStep();
+  // integrate a step with the selected solver
+  mpFMU->doStep(mpSimSettings->getSolver(), mpSimSettings->getRelativeTolerance());
+
+  // shorten the step to the first zero crossing of an event indicator, the event is handled in the next step
+  if (mpSimSettings->getIterateEvents())
+  {
+    mpFMU->locateStateEvent(mpSimSettings->getSolver(), mpSimSettings->getRelativeTolerance());
+  }
 
   // Set states
   mpFMU->setContinuousStates();
@@ -219,6 +258,8 @@ double VisualizerFMU::simulateStep(const double time)
 
 void VisualizerFMU::initializeVisAttributes(const double time)
 {
+  stopSimulationThread();
+  mFrames.clear();
   mpFMU->initialize(mpSimSettings);
   std::cout<<"VisualizerFMU::loadFMU: FMU was successfully initialized."<<std::endl;
 
@@ -228,8 +269,49 @@ void VisualizerFMU::initializeVisAttributes(const double time)
   updateVisAttributes(mpTimeManager->getVisTime());
 }
 
+/*!
+ * \brief VisualizerFMU::updateVisAttributes
+ * Reads the visual attributes from the FMU and updates the scene.
+ * Only called while the simulation thread is stopped, e.g., after the initialization.
+ * \param time
+ */
 void VisualizerFMU::updateVisAttributes(const double time)
 {
+  Q_UNUSED(time);
+  VisualizerFrame frame;
+  readVisAttributes(frame);
+  applyVisAttributes(frame);
+}
+
+/*!
+ * \brief VisualizerFMU::readVisAttributes
+ * Reads the values of all the visual attributes from the FMU with a single call.
+ * \param frame
+ */
+void VisualizerFMU::readVisAttributes(VisualizerFrame& frame)
+{
+  mValues.resize(mValueReferences.size());
+  if (!mValueReferences.empty())
+  {
+    mpFMU->fmi_get_reals(mValueReferences.data(), mValueReferences.size(), mValues.data());
+  }
+  frame.time = mpFMU->getFMUData()->_tcur;
+  frame.values.assign(mValues.begin(), mValues.end());
+}
+
+/*!
+ * \brief VisualizerFMU::applyVisAttributes
+ * Sets the values of the frame in the visual attributes and updates the scene graph.
+ * \param frame
+ */
+void VisualizerFMU::applyVisAttributes(const VisualizerFrame& frame)
+{
+  for (std::size_t i = 0; i < mFMUAttributes.size(); ++i)
+  {
+    // the attribute might have been made constant by the user e.g., by changing the color of the shape.
+    if (!mFMUAttributes[i]->isConst)
+      mFMUAttributes[i]->exp = frame.values[i];
+  }
   // Update all shapes.
   rAndT rT;
   osg::ref_ptr<osg::Node> child = nullptr;
@@ -238,36 +320,6 @@ void VisualizerFMU::updateVisAttributes(const double time)
     size_t i = 0;
     for (auto& shape : mpOMVisualBase->_shapes)
     {
-      // Get the values for the scene graph objects
-      updateObjectAttributeFMU(&shape._length, mpFMU);
-      updateObjectAttributeFMU(&shape._width, mpFMU);
-      updateObjectAttributeFMU(&shape._height, mpFMU);
-
-      updateObjectAttributeFMU(&shape._lDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._wDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._r[0], mpFMU);
-      updateObjectAttributeFMU(&shape._r[1], mpFMU);
-      updateObjectAttributeFMU(&shape._r[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._rShape[0], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[1], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._T[0], mpFMU);
-      updateObjectAttributeFMU(&shape._T[1], mpFMU);
-      updateObjectAttributeFMU(&shape._T[2], mpFMU);
-      updateObjectAttributeFMU(&shape._T[3], mpFMU);
-      updateObjectAttributeFMU(&shape._T[4], mpFMU);
-      updateObjectAttributeFMU(&shape._T[5], mpFMU);
-      updateObjectAttributeFMU(&shape._T[6], mpFMU);
-      updateObjectAttributeFMU(&shape._T[7], mpFMU);
-      updateObjectAttributeFMU(&shape._T[8], mpFMU);
       rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
                 osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
                 osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
@@ -280,7 +332,7 @@ void VisualizerFMU::updateVisAttributes(const double time)
       assemblePokeMatrix(shape._mat, rT._T, rT._r);
 
       // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
+      mpUpdateVisitor->_shape = &shape;
 
       // Get the scene graph nodes and stuff.
       //mpOMVisScene->dumpOSGTreeDebug();
@@ -291,44 +343,134 @@ void VisualizerFMU::updateVisAttributes(const double time)
   }  // end try
   catch (std::exception& ex)
   {
-    std::string msg = "Error in VisualizerFMU::updateVisAttributes at time point " + std::to_string(time)
+    std::string msg = "Error in VisualizerFMU::updateVisAttributes at time point " + std::to_string(frame.time)
                                         + "\n" + std::string(ex.what());
     std::cout<<msg<<std::endl;
     throw(msg);
   }
 }
 
+/*!
+ * \brief VisualizerFMU::updateScene
+ * Shows the next frame of the simulation thread.\n
+ * The simulation runs ahead of the visualization, so the rendering isn't blocked by the integration.
+ * If the simulation is slower than the visualization, the visualization time waits for it.
+ * \param time
+ */
 void VisualizerFMU::updateScene(const double time)
 {
+  Q_UNUSED(time);
   mpTimeManager->updateTick(); //for real-time measurement
+  const double realTime = mpTimeManager->getRealTime();
+  const double simTime = mpTimeManager->getSimTime();
+
+  VisualizerFrame frame;
+  bool hasFrame = false;
+  {
+    std::lock_guard<std::mutex> lock(mFramesMutex);
+    mFrameStep = mpTimeManager->getHVisual() * mpTimeManager->getSpeedUp();
+    // take the next frame and skip the frames the visualization time has already passed
+    while (!mFrames.empty() && (!hasFrame || mFrames.front().time <= mpTimeManager->getVisTime()))
+    {
+      frame = std::move(mFrames.front());
+      mFrames.pop_front();
+      hasFrame = true;
+    }
+  }
+  mFramesCondition.notify_one();
+  if (!mSimulationThread.joinable())
+  {
+    startSimulationThread();
+  }
 
-  mpTimeManager->setSimTime(mpTimeManager->getVisTime());
-  double nextStep = mpTimeManager->getVisTime() + mpTimeManager->getHVisual();
+  if (hasFrame)
+  {
+    mpTimeManager->setSimTime(frame.time);
+    applyVisAttributes(frame);
+  }
+  // the visualization time continues from the last simulated frame
+  mpTimeManager->setVisTime(mpTimeManager->getSimTime());
+
+  /* The real-time factor is the simulated time shown per real time since the previous scene update.
+   * Intervals much longer than the update timer interval come from a pause and are not measured.
+   */
+  const double interval = realTime - mLastUpdateRealTime;
+  if (interval > 0.0 && interval < 10 * mpTimeManager->getUpdateSceneTimer()->interval() / 1000.0)
+  {
+    mpTimeManager->setRealTimeFactor((mpTimeManager->getSimTime() - simTime) / interval);
+  }
+  mLastUpdateRealTime = realTime;
+}
 
-  double vis1 = mpTimeManager->getRealTime();
-  while (mpTimeManager->getSimTime() < nextStep)
+/*!
+ * \brief VisualizerFMU::startSimulationThread
+ * Starts the simulation thread. The FMU must not be used by the GUI thread until stopSimulationThread() is called.
+ */
+void VisualizerFMU::startSimulationThread()
+{
+  stopSimulationThread();
   {
-    //std::cout<<"simulate "<<omvManager->_simTime<<" to "<<nextStep<<std::endl;
-    mpTimeManager->setSimTime(simulateStep(mpTimeManager->getSimTime()));
+    std::lock_guard<std::mutex> lock(mFramesMutex);
+    mFrameStep = mpTimeManager->getHVisual() * mpTimeManager->getSpeedUp();
+    mStopSimulation = false;
   }
-  mpTimeManager->updateTick();                     //for real-time measurement
-  mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / (mpTimeManager->getRealTime() - vis1));
-  updateVisAttributes(mpTimeManager->getVisTime());
+  mSimulationThread = std::thread(&VisualizerFMU::runSimulation, this);
 }
 
-// Todo pass by const ref
-void VisualizerFMU::updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper)
+/*!
+ * \brief VisualizerFMU::stopSimulationThread
+ * Stops the simulation thread. The frames which are already simulated are kept.
+ */
+void VisualizerFMU::stopSimulationThread()
 {
-  if (!attr->isConst)
   {
-    double a = attr->exp;
-    fmuWrapper->fmi_get_real(&attr->fmuValueRef, &a);
-    attr->exp = (float) a;
+    std::lock_guard<std::mutex> lock(mFramesMutex);
+    mStopSimulation = true;
+  }
+  mFramesCondition.notify_one();
+  if (mSimulationThread.joinable())
+  {
+    mSimulationThread.join();
+  }
+}
+
+/*!
+ * \brief VisualizerFMU::runSimulation
+ * The simulation thread. Simulates the FMU frame by frame until the end time and keeps up to maxBufferedFrames frames ahead.
+ */
+void VisualizerFMU::runSimulation()
+{
+  double time = mpFMU->getFMUData()->_tcur;
+  const double endTime = mpSimSettings->getTend();
+  while (time < endTime)
+  {
+    double frameTime;
+    {
+      std::unique_lock<std::mutex> lock(mFramesMutex);
+      mFramesCondition.wait(lock, [&] {return mStopSimulation || mFrames.size() < maxBufferedFrames;});
+      if (mStopSimulation)
+      {
+        return;
+      }
+      frameTime = std::min(time + mFrameStep, endTime);
+    }
+    while (time < frameTime)
+    {
+      time = simulateStep(time);
+    }
+    VisualizerFrame frame;
+    readVisAttributes(frame);
+    {
+      std::lock_guard<std::mutex> lock(mFramesMutex);
+      mFrames.push_back(std::move(frame));
+    }
   }
 }
 
 void VisualizerFMU::setSimulationSettings(double stepsize, Solver solver, bool iterateEvents)
 {
+  // the settings are used by the simulation thread, it is started again by the next scene update.
+  stopSimulationThread();
   mpSimSettings->setHdef(stepsize);
   mpSimSettings->setSolver(solver);
   mpSimSettings->setIterateEvents(iterateEvents);
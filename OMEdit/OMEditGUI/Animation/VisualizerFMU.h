@@ -41,6 +41,8 @@
 #include "Shapes.h"
 #include "TimeManager.h"
 
+#include <deque>
+
 class VisualizerFMU : public VisualizerAbstract
 {
  public:
@@ -60,14 +62,36 @@ class VisualizerFMU : public VisualizerAbstract
   double simulateStep(const double time);
   void updateVisAttributes(const double time) override;
   void updateScene(const double time = 0.0) override;
-  void updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper);
   void setSimulationSettings(double stepsize, Solver solver, bool iterateEvents);
  private:
+  void startSimulationThread();
+  void stopSimulationThread();
+  void runSimulation();
+  void readVisAttributes(VisualizerFrame& frame);
+  void applyVisAttributes(const VisualizerFrame& frame);
+
   std::shared_ptr<fmi_import_context_t> mpContext;
   jm_callbacks mCallbacks;
   fmi_version_enu_t mVersion;
   FMUWrapperAbstract* mpFMU;
   std::shared_ptr<SimSettingsFMU> mpSimSettings;
+  //! The attributes read from the FMU, the values of a frame are in the same order.
+  //! The pointers point into mpOMVisualBase->_shapes and are only used by the GUI thread in applyVisAttributes().
+  //! _shapes must not be reallocated while the simulation thread runs and setVarReferencesInVisAttributes() must be called after
+  //! it is reloaded, see initData().
+  std::vector<ShapeObjectAttribute*> mFMUAttributes;
+  std::vector<unsigned int> mValueReferences;
+  std::vector<double> mValues;
+  //! The frames simulated ahead of the visualization time by the simulation thread.
+  std::deque<VisualizerFrame> mFrames;
+  //! The simulation time between two frames.
+  double mFrameStep;
+  //! The real time of the previous scene update, used to measure the real-time factor.
+  double mLastUpdateRealTime;
+  bool mStopSimulation;
+  std::thread mSimulationThread;
+  std::mutex mFramesMutex;
+  std::condition_variable mFramesCondition;
 };
 
 
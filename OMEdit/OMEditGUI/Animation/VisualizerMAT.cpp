@@ -36,7 +36,11 @@
 
 VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& path)
   : VisualizerAbstract(modelFile, path, VisType::MAT),
-    _matReader()
+    _matReader(),
+    mAttributeHandles(),
+    mpTimeValues(nullptr),
+    mNumTimePoints(0),
+    mFramePrefetcher()
 {
 
 }
@@ -47,6 +51,8 @@ VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& pa
  */
 VisualizerMAT::~VisualizerMAT()
 {
+  // the prefetch thread reads the trajectories of the reader.
+  mFramePrefetcher.stop();
   if (_matReader.file) {
     omc_free_matlab4_reader(&_matReader);
   }
@@ -54,10 +60,13 @@ VisualizerMAT::~VisualizerMAT()
 
 void VisualizerMAT::initData()
 {
+  mFramePrefetcher.stop();
   VisualizerAbstract::initData();
   readMat(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
   mpTimeManager->setStartTime(omc_matlab4_startTime(&_matReader));
   mpTimeManager->setEndTime(omc_matlab4_stopTime(&_matReader));
+  resolveVisAttributes();
+  mFramePrefetcher.setUp(mpOMVisualBase->_shapes, mAttributeHandles, mpTimeValues, mNumTimePoints);
 }
 
 void VisualizerMAT::initializeVisAttributes(const double time)
@@ -79,6 +88,10 @@ void VisualizerMAT::readMat(const std::string& modelFile, const std::string& pat
   }
   else
   {
+    // In case of reloading, free the previously read file.
+    if (_matReader.file) {
+      omc_free_matlab4_reader(&_matReader);
+    }
     // Read mat file.
     auto ret = omc_new_matlab4_reader(resFileName.c_str(), &_matReader);
     // Check return value.
@@ -102,76 +115,17 @@ void VisualizerMAT::setSimulationSettings(const UserSimSettingsMAT& simSetMAT)
   mpTimeManager->setHVisual(newVal);
 }
 
+/*!
+ * \brief VisualizerMAT::updateVisAttributes
+ * Updates the visualization attributes of all the shapes at the given time.\n
+ * The frame is usually already computed by the prefetch thread from the trajectories resolved by resolveVisAttributes.
+ * \param time
+ */
 void VisualizerMAT::updateVisAttributes(const double time)
 {
-  //std::cout<<"updateVisAttributes at "<<time <<std::endl;
-  // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
-  ModelicaMatReader* tmpReaderPtr = &_matReader;
   try
   {
-    for (auto& shape : mpOMVisualBase->_shapes)
-    {
-      //std::cout<<"shape "<<shape._id <<std::endl;
-
-      // Get the values for the scene graph objects
-      updateObjectAttributeMAT(&shape._length, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._width, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._height, time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._lDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._wDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._r[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._rShape[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._T[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[2], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[3], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[4], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[5], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[6], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[7], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[8], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._color[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._specCoeff, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._extra, time, tmpReaderPtr);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
-    }
+    applyFrame(mFramePrefetcher.getFrame(time), mAttributeHandles);
   }
   catch (std::exception& ex)
   {
@@ -181,6 +135,16 @@ void VisualizerMAT::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerMAT::prefetchVisAttributes
+ * Starts computing the visualization attributes of the next frame on the prefetch thread.
+ * \param time
+ */
+void VisualizerMAT::prefetchVisAttributes(const double time)
+{
+  mFramePrefetcher.prefetch(time);
+}
+
 void VisualizerMAT::updateScene(const double time)
 {
   mpTimeManager->updateTick();  //for real-time measurement
@@ -210,3 +174,79 @@ double VisualizerMAT::omcGetVarValue(ModelicaMatReader* reader, const char* varN
     return val;
 }
 
+
+/*!
+ * \brief VisualizerMAT::resolveVisAttributes
+ * Resolves the attributes of all the shapes against the result file once.
+ * Afterwards updateVisAttributes doesn't need to search the variables by name.
+ */
+void VisualizerMAT::resolveVisAttributes()
+{
+  mAttributeHandles.clear();
+  mpTimeValues = nullptr;
+  mNumTimePoints = 0;
+  if (!_matReader.file)
+    return;
+  // The first variable of the result file is always the time.
+  mpTimeValues = omc_matlab4_read_vals(&_matReader, 1);
+  if (mpTimeValues)
+    mNumTimePoints = _matReader.nrows;
+
+  ModelicaMatReader* tmpReaderPtr = &_matReader;
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    resolveObjectAttributeMAT(&shape._length, tmpReaderPtr);
+    resolveObjectAttributeMAT(&shape._width, tmpReaderPtr);
+    resolveObjectAttributeMAT(&shape._height, tmpReaderPtr);
+
+    for (int i = 0; i < 3; ++i)
+    {
+      resolveObjectAttributeMAT(&shape._lDir[i], tmpReaderPtr);
+      resolveObjectAttributeMAT(&shape._wDir[i], tmpReaderPtr);
+      resolveObjectAttributeMAT(&shape._r[i], tmpReaderPtr);
+      resolveObjectAttributeMAT(&shape._rShape[i], tmpReaderPtr);
+      resolveObjectAttributeMAT(&shape._color[i], tmpReaderPtr);
+    }
+    for (int i = 0; i < 9; ++i)
+      resolveObjectAttributeMAT(&shape._T[i], tmpReaderPtr);
+
+    resolveObjectAttributeMAT(&shape._specCoeff, tmpReaderPtr);
+    resolveObjectAttributeMAT(&shape._extra, tmpReaderPtr);
+  }
+}
+
+/*!
+ * \brief VisualizerMAT::resolveObjectAttributeMAT
+ * Resolves a single attribute. Parameters are read once since they don't change over time,
+ * for the other variables the trajectory is stored in the attribute handles.
+ * \param attr
+ * \param reader
+ */
+void VisualizerMAT::resolveObjectAttributeMAT(ShapeObjectAttribute* attr, ModelicaMatReader* reader)
+{
+  if (attr->isConst)
+    return;
+  ModelicaMatVariable_t* var = omc_matlab4_find_var(reader, attr->cref.c_str());
+  if (var == nullptr)
+  {
+    std::cout<<"Did not get variable from result file. Variable name is "<<attr->cref<<std::endl;
+    attr->exp = 0.0;
+  }
+  else if (var->isParam || mNumTimePoints == 0)
+  {
+    double val = 0.0;
+    omc_matlab4_val(&val, reader, var, omc_matlab4_startTime(reader));
+    attr->exp = val;
+  }
+  else
+  {
+    const double* values = omc_matlab4_read_vals(reader, var->index);
+    if (values)
+    {
+      ResultAttributeHandle handle;
+      handle.attr = attr;
+      handle.values = values;
+      mAttributeHandles.push_back(handle);
+    }
+  }
+}
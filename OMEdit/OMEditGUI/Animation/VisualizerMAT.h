@@ -52,11 +52,18 @@ class VisualizerMAT : public VisualizerAbstract
   void setSimulationSettings(const UserSimSettingsMAT& simSetMAT);
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
+  void prefetchVisAttributes(const double time) override;
   void updateScene(const double time) override;
   void updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader);
   double omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time);
+  void resolveVisAttributes();
+  void resolveObjectAttributeMAT(ShapeObjectAttribute* attr, ModelicaMatReader* reader);
 private:
   ModelicaMatReader _matReader;
+  std::vector<ResultAttributeHandle> mAttributeHandles;
+  const double* mpTimeValues;
+  unsigned int mNumTimePoints;
+  FramePrefetcher mFramePrefetcher;
 };
 
 #endif // end VISUALIZERMAT_H
@@ -35,7 +35,7 @@
 #include "BitmapAnnotation.h"
 #include "Modeling/Commands.h"
 
-BitmapAnnotation::BitmapAnnotation(QString classFileName, QString annotation, GraphicsView *pGraphicsView)
+BitmapAnnotation::BitmapAnnotation(QString classFileName, const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   mpComponent = 0;
@@ -77,24 +77,35 @@ BitmapAnnotation::BitmapAnnotation(ShapeAnnotation *pShapeAnnotation, GraphicsVi
 
 void BitmapAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Bitmap.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief BitmapAnnotation::parseShapeAnnotation
+ * Reads the attributes of Bitmap from the parsed annotation values.
+ * \param list
+ */
+void BitmapAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
   if (list.size() < 5) {
     return;
   }
   // 4th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
+  AnnotationValue extentsList = list.at(3);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++) {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    QPointF extentPoint;
+    if (extentsList.at(i).toPointF(&extentPoint)) {
+      mExtents.replace(i, extentPoint);
+    }
   }
   // 5th item is the fileName
-  setFileName(StringHandler::removeFirstLastQuotes(list.at(4)));
+  setFileName(list.at(4).toUnquotedString());
   // 6th item is the imageSource
   if (list.size() >= 6) {
-    mImageSource = StringHandler::removeFirstLastQuotes(list.at(5));
+    mImageSource = list.at(5).toUnquotedString();
   }
   if (!mImageSource.isEmpty()) {
     mImage.loadFromData(QByteArray::fromBase64(mImageSource.toLatin1()));
@@ -121,6 +132,9 @@ void BitmapAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
+  if (isHiddenByLevelOfDetail(painter)) {
+    return;
+  }
   if (mVisible || !mDynamicVisible.isEmpty())
     drawBitmapAnnotaion(painter);
 }
@@ -200,7 +214,7 @@ void BitmapAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
  */
 void BitmapAnnotation::duplicate()
 {
-  BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mClassFileName, "", mpGraphicsView);
+  BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mClassFileName, AnnotationValue(), mpGraphicsView);
   pBitmapAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
@@ -43,12 +43,13 @@ class BitmapAnnotation : public ShapeAnnotation
   Q_OBJECT
 public:
   // Used for icon/diagram shape
-  BitmapAnnotation(QString classFileName, QString annotation, GraphicsView *pGraphicsView);
+  BitmapAnnotation(QString classFileName, const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   BitmapAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
   BitmapAnnotation(ShapeAnnotation *pShapeAnnotation, GraphicsView *pGraphicsView);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
@@ -35,7 +35,7 @@
 #include "EllipseAnnotation.h"
 #include "Modeling/Commands.h"
 
-EllipseAnnotation::EllipseAnnotation(QString annotation, GraphicsView *pGraphicsView)
+EllipseAnnotation::EllipseAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   // set the default values
@@ -75,25 +75,35 @@ EllipseAnnotation::EllipseAnnotation(ShapeAnnotation *pShapeAnnotation, Graphics
 
 void EllipseAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Ellipse.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief EllipseAnnotation::parseShapeAnnotation
+ * Reads the attributes of Ellipse from the parsed annotation values.
+ * \param list
+ */
+void EllipseAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11) {
     return;
   }
   // 9th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
+  AnnotationValue extentsList = list.at(8);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++) {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2) {
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    QPointF extentPoint;
+    if (extentsList.at(i).toPointF(&extentPoint)) {
+      mExtents.replace(i, extentPoint);
     }
   }
   // 10th item of the list contains the start angle.
-  mStartAngle = list.at(9).toFloat();
+  mStartAngle = list.at(9).toDouble();
   // 11th item of the list contains the end angle.
-  mEndAngle = list.at(10).toFloat();
+  mEndAngle = list.at(10).toDouble();
 }
 
 QRectF EllipseAnnotation::boundingRect() const
@@ -126,6 +136,9 @@ void EllipseAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
+  if (isHiddenByLevelOfDetail(painter)) {
+    return;
+  }
   if (mVisible || !mDynamicVisible.isEmpty()) {
     drawEllipseAnnotaion(painter);
   }
@@ -222,7 +235,7 @@ void EllipseAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
  */
 void EllipseAnnotation::duplicate()
 {
-  EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation("", mpGraphicsView);
+  EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(AnnotationValue(), mpGraphicsView);
   pEllipseAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
@@ -43,12 +43,13 @@ class EllipseAnnotation : public ShapeAnnotation
   Q_OBJECT
 public:
   // Used for icon/diagram shape
-  EllipseAnnotation(QString annotation, GraphicsView *pGraphicsView);
+  EllipseAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   EllipseAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
   EllipseAnnotation(ShapeAnnotation *pShapeAnnotation, GraphicsView *pGraphicsView);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
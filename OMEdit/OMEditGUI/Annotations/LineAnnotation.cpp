@@ -36,7 +36,7 @@
 #include "LineAnnotation.h"
 #include "Modeling/Commands.h"
 
-LineAnnotation::LineAnnotation(QString annotation, GraphicsView *pGraphicsView)
+LineAnnotation::LineAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   setLineType(LineAnnotation::ShapeType);
@@ -202,44 +202,47 @@ LineAnnotation::LineAnnotation(GraphicsView *pGraphicsView)
 
 void LineAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Line.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief LineAnnotation::parseShapeAnnotation
+ * Reads the attributes of Line from the parsed annotation values.
+ * \param list
+ */
+void LineAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
   if (list.size() < 10) {
     return;
   }
   mPoints.clear();
   // 4th item of list contains the points.
-  QStringList pointsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
-  foreach (QString point, pointsList) {
-    QStringList linePoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(point));
-    if (linePoints.size() >= 2) {
-      addPoint(QPointF(linePoints.at(0).toFloat(), linePoints.at(1).toFloat()));
+  AnnotationValue pointsList = list.at(3);
+  for (int i = 0 ; i < pointsList.size() ; i++) {
+    QPointF point;
+    if (pointsList.at(i).toPointF(&point)) {
+      addPoint(point);
     }
   }
   // 5th item of list contains the color.
-  QStringList colorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(4)));
-  if (colorList.size() >= 3) {
-    int red, green, blue = 0;
-    red = colorList.at(0).toInt();
-    green = colorList.at(1).toInt();
-    blue = colorList.at(2).toInt();
-    mLineColor = QColor (red, green, blue);
-  }
+  list.at(4).toColor(&mLineColor);
   // 6th item of list contains the Line Pattern.
-  mLinePattern = StringHandler::getLinePatternType(list.at(5));
+  mLinePattern = StringHandler::getLinePatternType(list.at(5).toString());
   // 7th item of list contains the Line thickness.
-  mLineThickness = list.at(6).toFloat();
+  mLineThickness = list.at(6).toDouble();
   // 8th item of list contains the Line Arrows.
-  QStringList arrowList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(7)));
+  AnnotationValue arrowList = list.at(7);
   if (arrowList.size() >= 2) {
-    mArrow.replace(0, StringHandler::getArrowType(arrowList.at(0)));
-    mArrow.replace(1, StringHandler::getArrowType(arrowList.at(1)));
+    mArrow.replace(0, StringHandler::getArrowType(arrowList.at(0).toString()));
+    mArrow.replace(1, StringHandler::getArrowType(arrowList.at(1).toString()));
   }
   // 9th item of list contains the Line Arrow Size.
-  mArrowSize = list.at(8).toFloat();
+  mArrowSize = list.at(8).toDouble();
   // 10th item of list contains the smooth.
-  mSmooth = StringHandler::getSmoothType(list.at(9));
+  mSmooth = StringHandler::getSmoothType(list.at(9).toString());
 }
 
 QPainterPath LineAnnotation::getShape() const
@@ -292,6 +295,9 @@ void LineAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *op
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
+  if (isHiddenByLevelOfDetail(painter)) {
+    return;
+  }
   if (mVisible || !mDynamicVisible.isEmpty()) {
     drawLineAnnotaion(painter);
   }
@@ -787,7 +793,7 @@ void LineAnnotation::updateConnectionAnnotation()
  */
 void LineAnnotation::duplicate()
 {
-  LineAnnotation *pLineAnnotation = new LineAnnotation("", mpGraphicsView);
+  LineAnnotation *pLineAnnotation = new LineAnnotation(AnnotationValue(), mpGraphicsView);
   pLineAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
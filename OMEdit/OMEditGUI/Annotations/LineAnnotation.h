@@ -53,7 +53,7 @@ public:
     ShapeType  /* Line is a custom shape. */
   };
   // Used for icon/diagram shape
-  LineAnnotation(QString annotation, GraphicsView *pGraphicsView);
+  LineAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   LineAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
@@ -67,6 +67,7 @@ public:
   // Used for non-existing class
   LineAnnotation(GraphicsView *pGraphicsView);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QPainterPath getShape() const;
   QRectF boundingRect() const;
   QPainterPath shape() const;
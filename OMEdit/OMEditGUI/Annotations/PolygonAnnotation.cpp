@@ -35,7 +35,7 @@
 #include "PolygonAnnotation.h"
 #include "Modeling/Commands.h"
 
-PolygonAnnotation::PolygonAnnotation(QString annotation, GraphicsView *pGraphicsView)
+PolygonAnnotation::PolygonAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   // set the default values
@@ -75,22 +75,25 @@ PolygonAnnotation::PolygonAnnotation(ShapeAnnotation *pShapeAnnotation, Graphics
 
 void PolygonAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Polygon.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief PolygonAnnotation::parseShapeAnnotation
+ * Reads the attributes of Polygon from the parsed annotation values.
+ * \param list
+ */
+void PolygonAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 10) {
     return;
   }
-  mPoints.clear();
   // 9th item of list contains the points.
-  QStringList pointsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
-  foreach (QString point, pointsList) {
-    QStringList polygonPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(point));
-    if (polygonPoints.size() >= 2) {
-      mPoints.append(QPointF(polygonPoints.at(0).toFloat(), polygonPoints.at(1).toFloat()));
-    }
-  }
+  mPoints = list.at(8).toPoints();
   /* The polygon is automatically closed, if the first and the last points are not identical. */
   if (mPoints.size() == 1) {
     mPoints.append(mPoints.first());
@@ -104,7 +107,7 @@ void PolygonAnnotation::parseShapeAnnotation(QString annotation)
     }
   }
   // 10th item of the list is smooth.
-  mSmooth = StringHandler::getSmoothType(list.at(9));
+  mSmooth = StringHandler::getSmoothType(list.at(9).toString());
 }
 
 QPainterPath PolygonAnnotation::getShape() const
@@ -158,6 +161,9 @@ void PolygonAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
+  if (isHiddenByLevelOfDetail(painter)) {
+    return;
+  }
   if (mVisible || !mDynamicVisible.isEmpty()) {
     drawPolygonAnnotaion(painter);
   }
@@ -274,7 +280,7 @@ void PolygonAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
  */
 void PolygonAnnotation::duplicate()
 {
-  PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation("", mpGraphicsView);
+  PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(AnnotationValue(), mpGraphicsView);
   pPolygonAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
@@ -43,12 +43,13 @@ class PolygonAnnotation : public ShapeAnnotation
   Q_OBJECT
 public:
   // Used for icon/diagram shape
-  PolygonAnnotation(QString annotation, GraphicsView *pGraphicsView);
+  PolygonAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   PolygonAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
   PolygonAnnotation(ShapeAnnotation *pShapeAnnotation, GraphicsView *pGraphicsView);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QPainterPath getShape() const;
   QRectF boundingRect() const;
   QPainterPath shape() const;
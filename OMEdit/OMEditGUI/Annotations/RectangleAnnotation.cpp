@@ -35,7 +35,7 @@
 #include "RectangleAnnotation.h"
 #include "Modeling/Commands.h"
 
-RectangleAnnotation::RectangleAnnotation(QString annotation, GraphicsView *pGraphicsView)
+RectangleAnnotation::RectangleAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   // set the default values
@@ -93,25 +93,35 @@ RectangleAnnotation::RectangleAnnotation(Component *pParent)
 
 void RectangleAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Rectangle.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief RectangleAnnotation::parseShapeAnnotation
+ * Reads the attributes of Rectangle from the parsed annotation values.
+ * \param list
+ */
+void RectangleAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11) {
     return;
   }
   // 9th item of the list contains the border pattern.
-  mBorderPattern = StringHandler::getBorderPatternType(list.at(8));
+  mBorderPattern = StringHandler::getBorderPatternType(list.at(8).toString());
   // 10th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(9)));
+  AnnotationValue extentsList = list.at(9);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++) {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2) {
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    QPointF extentPoint;
+    if (extentsList.at(i).toPointF(&extentPoint)) {
+      mExtents.replace(i, extentPoint);
     }
   }
   // 11th item of the list contains the corner radius.
-  mRadius = list.at(10).toFloat();
+  mRadius = list.at(10).toDouble();
 }
 
 QRectF RectangleAnnotation::boundingRect() const
@@ -133,6 +143,9 @@ void RectangleAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsIte
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
+  if (isHiddenByLevelOfDetail(painter)) {
+    return;
+  }
   if (mVisible || !mDynamicVisible.isEmpty()) {
     drawRectangleAnnotaion(painter);
   }
@@ -219,7 +232,7 @@ void RectangleAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
  */
 void RectangleAnnotation::duplicate()
 {
-  RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation("", mpGraphicsView);
+  RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(AnnotationValue(), mpGraphicsView);
   pRectangleAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
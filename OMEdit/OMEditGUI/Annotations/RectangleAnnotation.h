@@ -43,7 +43,7 @@ class RectangleAnnotation : public ShapeAnnotation
   Q_OBJECT
 public:
   // Used for icon/diagram shape
-  RectangleAnnotation(QString annotation, GraphicsView *pGraphicsView);
+  RectangleAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   RectangleAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
@@ -51,6 +51,7 @@ public:
   // Used for default component
   RectangleAnnotation(Component *pParent);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
@@ -69,35 +69,28 @@ void GraphicItem::setDefaults(ShapeAnnotation *pShapeAnnotation)
 
 /*!
   Parses the GraphicItem annotation values.
-  \param annotation - the annotation string.
+  \param annotation - the parsed annotation values.
   */
-void GraphicItem::parseShapeAnnotation(QString annotation)
+void GraphicItem::parseShapeAnnotation(const AnnotationValue &annotation)
 {
-  // parse the shape to get the list of attributes
-  QStringList list = StringHandler::getStrings(annotation);
-  if (list.size() < 3)
+  if (annotation.size() < 3)
     return;
   // if first item of list is true then the shape should be visible.
-  if (list.at(0).startsWith("{")) {
+  if (annotation.at(0).isArray()) {
     // DynamicSelect
-    QStringList args = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(0)));
-    if (args.count() > 0)
-      mVisible = args.at(0).contains("true");
-    if (args.count() > 1)
-      mDynamicVisible = args.at(1);  // variable name
+    AnnotationValue args = annotation.at(0);
+    if (args.size() > 0)
+      mVisible = args.at(0).toBool();
+    if (args.size() > 1)
+      mDynamicVisible = args.at(1).toString();  // variable name
   }
   else {
-    mVisible = list.at(0).contains("true");
+    mVisible = annotation.at(0).toBool();
   }
   // 2nd item is the origin
-  QStringList originList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(1)));
-  if (originList.size() >= 2)
-  {
-    mOrigin.setX(originList.at(0).toFloat());
-    mOrigin.setY(originList.at(1).toFloat());
-  }
+  annotation.at(1).toPointF(&mOrigin);
   // 3rd item is the rotation
-  mRotation = list.at(2).toFloat();
+  mRotation = annotation.at(2).toDouble();
 }
 
 /*!
@@ -176,40 +169,22 @@ void FilledShape::setDefaults(ShapeAnnotation *pShapeAnnotation)
 
 /*!
   Parses the FilledShape annotation values.
-  \param annotation - the annotation string.
+  \param annotation - the parsed annotation values.
   */
-void FilledShape::parseShapeAnnotation(QString annotation)
+void FilledShape::parseShapeAnnotation(const AnnotationValue &annotation)
 {
-  // parse the shape to get the list of attributes
-  QStringList list = StringHandler::getStrings(annotation);
-  if (list.size() < 8)
+  if (annotation.size() < 8)
     return;
   // 4th item of the list is the line color
-  QStringList colorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
-  if (colorList.size() >= 3)
-  {
-    int red, green, blue = 0;
-    red = colorList.at(0).toInt();
-    green = colorList.at(1).toInt();
-    blue = colorList.at(2).toInt();
-    mLineColor = QColor (red, green, blue);
-  }
+  annotation.at(3).toColor(&mLineColor);
   // 5th item of list contains the fill color.
-  QStringList fillColorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(4)));
-  if (fillColorList.size() >= 3)
-  {
-    int red, green, blue = 0;
-    red = fillColorList.at(0).toInt();
-    green = fillColorList.at(1).toInt();
-    blue = fillColorList.at(2).toInt();
-    mFillColor = QColor (red, green, blue);
-  }
+  annotation.at(4).toColor(&mFillColor);
   // 6th item of list contains the Line Pattern.
-  mLinePattern = StringHandler::getLinePatternType(list.at(5));
+  mLinePattern = StringHandler::getLinePatternType(annotation.at(5).toString());
   // 7th item of list contains the Fill Pattern.
-  mFillPattern = StringHandler::getFillPatternType(list.at(6));
+  mFillPattern = StringHandler::getFillPatternType(annotation.at(6).toString());
   // 8th item of list contains the thickness.
-  mLineThickness = list.at(7).toFloat();
+  mLineThickness = annotation.at(7).toDouble();
 }
 
 /*!
@@ -508,6 +483,24 @@ void ShapeAnnotation::applyLinePattern(QPainter *painter)
   painter->setPen(pen);
 }
 
+/*!
+ * \brief ShapeAnnotation::isHiddenByLevelOfDetail
+ * Checks if the shape of a Component is not drawn because the Component is too small on the screen.
+ * \param painter
+ * \return
+ */
+bool ShapeAnnotation::isHiddenByLevelOfDetail(QPainter *painter)
+{
+  if (!mpParentComponent) {
+    return false;
+  }
+  qreal deviceSize = mpParentComponent->getDeviceSize(this, painter);
+  if (dynamic_cast<TextAnnotation*>(this)) {
+    return Component::isTextHidden(deviceSize, painter);
+  }
+  return Component::isDrawnAsBox(deviceSize);
+}
+
 /*!
   Applies the shape fill pattern.
   \param painter - pointer to QPainter
@@ -775,22 +768,24 @@ QImage ShapeAnnotation::getImage()
 }
 
 /*!
-  Returns a dynamic value or null if no dynamic value exists
+  Returns a dynamic value or null if no dynamic value exists.
+  The value is taken at the time selected by the model widget time slider.
   */
 QVariant ShapeAnnotation::getDynamicValue(QString name)
+{
+  return getDynamicValue(name, mpParentComponent);
+}
+
+/*!
+  Returns a dynamic value of the Component or null if no dynamic value exists.
+  Used for the class shapes that are drawn by a SharedShapesItem.
+  */
+QVariant ShapeAnnotation::getDynamicValue(QString name, Component *pComponent)
 {
   QVariant dynamicValue; // isNull() per default
-  if (mpParentComponent) {
-    ModelWidget *pModelWidget = mpParentComponent->getGraphicsView()->getModelWidget();
-    if (!pModelWidget->getResultFileName().isEmpty()) {
-      QString fullName = pModelWidget->getResultFileName() + "." + mpParentComponent->getComponentInfo()->getName() + "." + name;
-      MainWindow *pMainWindow = MainWindow::instance();
-      VariablesTreeModel *pVariablesTreeModel = pMainWindow->getVariablesWidget()->getVariablesTreeModel();
-      VariablesTreeItem *pVariablesTreeItem = pVariablesTreeModel->findVariablesTreeItem(fullName, pVariablesTreeModel->getRootVariablesTreeItem());
-      if (pVariablesTreeItem != NULL) {
-        dynamicValue = pVariablesTreeItem->getValue(pVariablesTreeItem->getPreviousUnit(), pVariablesTreeItem->getUnit());
-      }
-    }
+  if (pComponent) {
+    ModelWidget *pModelWidget = pComponent->getGraphicsView()->getModelWidget();
+    dynamicValue = pModelWidget->getDynamicResultValue(pComponent, name);
   }
   return dynamicValue;
 }
@@ -974,6 +969,48 @@ void ShapeAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
   Q_UNUSED(pShapeAnnotation);
 }
 
+/*!
+ * \brief ShapeAnnotation::emitAdded
+ * Emits the added signal and notifies the Components which draw the class shape.
+ */
+void ShapeAnnotation::emitAdded()
+{
+  emit added();
+  emitShapeUpdatedForComponent();
+}
+
+/*!
+ * \brief ShapeAnnotation::emitChanged
+ * Emits the changed signal and notifies the Components which draw the class shape.
+ */
+void ShapeAnnotation::emitChanged()
+{
+  emit changed();
+  emitShapeUpdatedForComponent();
+}
+
+/*!
+ * \brief ShapeAnnotation::emitDeleted
+ * Emits the deleted signal and notifies the Components which draw the class shape.
+ */
+void ShapeAnnotation::emitDeleted()
+{
+  emit deleted();
+  emitShapeUpdatedForComponent();
+}
+
+/*!
+ * \brief ShapeAnnotation::emitShapeUpdatedForComponent
+ * The instances of a class draw its shapes through a SharedShapesItem.
+ * Instead of connecting every instance to every shape, the class LibraryTreeItem notifies the instances once.
+ */
+void ShapeAnnotation::emitShapeUpdatedForComponent()
+{
+  if (mpGraphicsView && !mpParentComponent && !mIsInheritedShape) {
+    mpGraphicsView->getModelWidget()->getLibraryTreeItem()->emitShapeUpdated();
+  }
+}
+
 /*!
  * \brief ShapeAnnotation::initUpdateVisible
  * Initialize optional DynamicSelect for the visible status
@@ -36,6 +36,7 @@
 #define SHAPEANNOTATION_H
 
 #include "Util/StringHandler.h"
+#include "Util/AnnotationParser.h"
 #include "Component/Transformation.h"
 
 #include <QGraphicsItem>
@@ -59,13 +60,15 @@ public:
   GraphicItem() {}
   void setDefaults();
   void setDefaults(ShapeAnnotation *pShapeAnnotation);
-  void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &annotation);
   QStringList getOMCShapeAnnotation();
   QStringList getShapeAnnotation();
   void setOrigin(QPointF origin) {mOrigin = origin;}
   QPointF getOrigin() {return mOrigin;}
   void setRotationAngle(qreal rotation) {mRotation = rotation;}
   qreal getRotation() {return mRotation;}
+  bool getVisible() {return mVisible;}
+  QString getDynamicVisible() {return mDynamicVisible;}
 protected:
   bool mVisible;
   QPointF mOrigin;
@@ -79,7 +82,7 @@ public:
   FilledShape() {}
   void setDefaults();
   void setDefaults(ShapeAnnotation *pShapeAnnotation);
-  void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &annotation);
   QStringList getOMCShapeAnnotation();
   QStringList getShapeAnnotation();
   void setLineColor(QColor color) {mLineColor = color;}
@@ -126,6 +129,7 @@ public:
   QRectF getBoundingRect() const;
   void applyLinePattern(QPainter *painter);
   void applyFillPattern(QPainter *painter);
+  bool isHiddenByLevelOfDetail(QPainter *painter);
   virtual void parseShapeAnnotation(QString annotation);
   virtual QString getOMCShapeAnnotation();
   virtual QString getShapeAnnotation();
@@ -177,6 +181,7 @@ public:
   void setImage(QImage image);
   QImage getImage();
   QVariant getDynamicValue(QString name);
+  QVariant getDynamicValue(QString name, Component *pComponent);
   void applyRotation(qreal angle);
   void adjustPointsWithOrigin();
   void adjustExtentsWithOrigin();
@@ -188,9 +193,9 @@ public:
   void adjustGeometries();
   virtual void setShapeFlags(bool enable);
   virtual void updateShape(ShapeAnnotation *pShapeAnnotation);
-  void emitAdded() {emit added();}
-  void emitChanged() {emit changed();}
-  void emitDeleted() {emit deleted();}
+  void emitAdded();
+  void emitChanged();
+  void emitDeleted();
   void emitPrepareGeometryChange() {prepareGeometryChange();}
 signals:
   void updateReferenceShapes();
@@ -259,6 +264,7 @@ protected:
   QList<CornerItem*> mCornerItemsList;
   QList<QVariant> mDynamicTextString; /* list of String() arguments */
   void initUpdateVisible();
+  void emitShapeUpdatedForComponent();
   virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent *pEvent);
   virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 };
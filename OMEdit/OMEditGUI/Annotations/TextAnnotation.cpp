@@ -45,7 +45,7 @@
  * \param inheritedShape
  * \param pGraphicsView - pointer to GraphicsView
  */
-TextAnnotation::TextAnnotation(QString annotation, GraphicsView *pGraphicsView)
+TextAnnotation::TextAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView)
   : ShapeAnnotation(false, pGraphicsView, 0)
 {
   mpComponent = 0;
@@ -109,47 +109,65 @@ TextAnnotation::TextAnnotation(Component *pParent)
  */
 void TextAnnotation::parseShapeAnnotation(QString annotation)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
   // parse the shape to get the list of attributes of Text.
-  QStringList list = StringHandler::getStrings(annotation);
+  AnnotationParser annotationParser(annotation);
+  parseShapeAnnotation(annotationParser.getRoot());
+}
+
+/*!
+ * \brief TextAnnotation::parseShapeAnnotation
+ * Reads the attributes of Text from the parsed annotation values.
+ * \param list
+ */
+void TextAnnotation::parseShapeAnnotation(const AnnotationValue &list)
+{
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11) {
     return;
   }
   // 9th item of the list contains the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
+  AnnotationValue extentsList = list.at(8);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++) {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    QPointF extentPoint;
+    if (extentsList.at(i).toPointF(&extentPoint)) {
+      mExtents.replace(i, extentPoint);
+    }
   }
   // 10th item of the list contains the textString.
-  if (list.at(9).startsWith("{")) {
+  if (list.at(9).isArray()) {
     // DynamicSelect
-    QStringList args = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(9)));
-    if (args.count() > 0)
-      mOriginalTextString = StringHandler::removeFirstLastQuotes(args.at(0));
-    if (args.count() > 1)
-      mDynamicTextString << args.at(1);  // variable name
-    if (args.count() > 2)
-      mDynamicTextString << args.at(2);  // significantDigits
+    AnnotationValue args = list.at(9);
+    if (args.size() > 0)
+      mOriginalTextString = args.at(0).toUnquotedString();
+    if (args.size() > 1)
+      mDynamicTextString << args.at(1).toString();  // variable name
+    if (args.size() > 2)
+      mDynamicTextString << args.at(2).toString();  // significantDigits
   }
   else {
-    mOriginalTextString = StringHandler::removeFirstLastQuotes(list.at(9));
+    mOriginalTextString = list.at(9).toUnquotedString();
   }
   mTextString = mOriginalTextString;
   initUpdateTextString();
   // 11th item of the list contains the fontSize.
-  mFontSize = list.at(10).toFloat();
+  mFontSize = list.at(10).toDouble();
   //Now comes the optional parameters; fontName and textStyle.
-  annotation = annotation.replace("{", "");
-  annotation = annotation.replace("}", "");
-  // parse the shape to get the list of attributes of Text Annotation.
-  list = StringHandler::getStrings(annotation);
-  int index = 19;
+  QList<AnnotationValue> optionalValues;
+  for (int i = 11 ; i < list.size() ; i++) {
+    // textStyle is an array of enumerations.
+    if (list.at(i).isArray()) {
+      for (int j = 0 ; j < list.at(i).size() ; j++) {
+        optionalValues.append(list.at(i).at(j));
+      }
+    } else {
+      optionalValues.append(list.at(i));
+    }
+  }
+  int index = 0;
   mTextStyles.clear();
-  while(index < list.size()) {
-    QString annotationValue = StringHandler::removeFirstLastQuotes(list.at(index));
+  while(index < optionalValues.size()) {
+    QString annotationValue = optionalValues.at(index).toUnquotedString();
     // check textStyles enumeration.
     if(annotationValue == "TextStyle.Bold") {
       mTextStyles.append(StringHandler::TextStyleBold);
@@ -220,6 +238,8 @@ void TextAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *op
     }
   } else if (mpComponent && mpComponent->getGraphicsView()->isRenderingLibraryPixmap()) {
     return;
+  } else if (isHiddenByLevelOfDetail(painter)) {
+    return;
   }
   if (mVisible || !mDynamicVisible.isEmpty()) {
     drawTextAnnotaion(painter);
@@ -232,6 +252,19 @@ void TextAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *op
  * \param painter
  */
 void TextAnnotation::drawTextAnnotaion(QPainter *painter)
+{
+  drawTextAnnotaion(painter, mpComponent, mTextString);
+}
+
+/*!
+ * \brief TextAnnotation::drawTextAnnotaion
+ * Draws the Text annotation as part of the Component.
+ * Also used by SharedShapesItem to draw the class text with the Component specific text string.
+ * \param painter
+ * \param pComponent - the Component the text belongs to or 0.
+ * \param textString - the text to draw.
+ */
+void TextAnnotation::drawTextAnnotaion(QPainter *painter, Component *pComponent, QString textString)
 {
   applyLinePattern(painter);
   /* Don't apply the fill patterns on Text shapes. */
@@ -241,8 +274,8 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
   // first we invert the painter since we have our coordinate system inverted.
   painter->scale(1.0, -1.0);
   painter->translate(0, dy);
-  mTextString = StringHandler::removeFirstLastQuotes(mTextString);
-  mTextString = StringHandler::unparse(QString("\"").append(mTextString).append("\""));
+  textString = StringHandler::removeFirstLastQuotes(textString);
+  textString = StringHandler::unparse(QString("\"").append(textString).append("\""));
   QFont font;
   if (mFontSize > 0) {
     font = QFont(mFontName, mFontSize, StringHandler::getFontWeight(mTextStyles), StringHandler::getFontItalic(mTextStyles));
@@ -259,7 +292,7 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
       font.setUnderline(true);
     }
     painter->setFont(font);
-    QRect fontBoundRect = painter->fontMetrics().boundingRect(boundingRect().toRect(), Qt::TextDontClip, mTextString);
+    QRect fontBoundRect = painter->fontMetrics().boundingRect(boundingRect().toRect(), Qt::TextDontClip, textString);
     float xFactor = boundingRect().width() / fontBoundRect.width();
     float yFactor = boundingRect().height() / fontBoundRect.height();
     /* Ticket:4256
@@ -269,7 +302,7 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
     float factor = (boundingRect().width() != 0 && xFactor < yFactor) ? xFactor : yFactor;
     QFont f = painter->font();
     qreal fontSizeFactor = f.pointSizeF()*factor;
-    if ((fontSizeFactor < 12) && mpComponent) {
+    if ((fontSizeFactor < 12) && pComponent) {
       f.setPointSizeF(12);
     } else if (fontSizeFactor <= 0) {
       f.setPointSizeF(1);
@@ -278,16 +311,16 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
     }
     painter->setFont(f);
   }
-  if (mpComponent) {
-    Component *pComponent = mpComponent->getRootParentComponent();
-    if (pComponent && pComponent->mTransformation.isValid()) {
-      QPointF extent1 = pComponent->mTransformation.getExtent1();
-      QPointF extent2 = pComponent->mTransformation.getExtent2();
-      qreal componentAngle = StringHandler::getNormalizedAngle(pComponent->mTransformation.getRotateAngle());
+  if (pComponent) {
+    Component *pRootComponent = pComponent->getRootParentComponent();
+    if (pRootComponent && pRootComponent->mTransformation.isValid()) {
+      QPointF extent1 = pRootComponent->mTransformation.getExtent1();
+      QPointF extent2 = pRootComponent->mTransformation.getExtent2();
+      qreal componentAngle = StringHandler::getNormalizedAngle(pRootComponent->mTransformation.getRotateAngle());
       qreal shapeAngle = StringHandler::getNormalizedAngle(getRotation());
       // if shape has its own angle
       if (shapeAngle > 0) {
-        shapeAngle = StringHandler::getNormalizedAngle(pComponent->mTransformation.getRotateAngle() + getRotation());
+        shapeAngle = StringHandler::getNormalizedAngle(pRootComponent->mTransformation.getRotateAngle() + getRotation());
         if (shapeAngle == 180) {
           painter->scale(-1.0, -1.0);
           painter->translate(dx, dy);
@@ -323,10 +356,10 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
     }
   }
   // draw the font
-  if (mpComponent) {
-    painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, mTextString);
+  if (pComponent) {
+    painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, textString);
   } else if (boundingRect().width() > 0 && boundingRect().height() > 0) {
-    painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, mTextString);
+    painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, textString);
   }
 }
 
@@ -449,13 +482,15 @@ void TextAnnotation::initUpdateTextString()
 
 /*!
  * \brief TextAnnotation::updateTextStringHelper
- * Helper function for TextAnnotation::updateTextString()
+ * Helper function for TextAnnotation::getComponentTextString()
  * \param regExp
+ * \param pComponent
+ * \param pTextString - the text in which the variables are replaced.
  */
-void TextAnnotation::updateTextStringHelper(QRegExp regExp)
+void TextAnnotation::updateTextStringHelper(QRegExp regExp, Component *pComponent, QString *pTextString)
 {
   int pos = 0;
-  while ((pos = regExp.indexIn(mTextString, pos)) != -1) {
+  while ((pos = regExp.indexIn(*pTextString, pos)) != -1) {
     QString variable = regExp.cap(0);
     if ((!variable.isEmpty()) && (variable.compare("%%") != 0) && (variable.compare("%name") != 0) && (variable.compare("%class") != 0)) {
       variable.remove("%");
@@ -464,18 +499,18 @@ void TextAnnotation::updateTextStringHelper(QRegExp regExp)
         /* Ticket:4204
          * If we have extend component then call Component::getParameterDisplayString from root component.
          */
-        if (mpComponent->getComponentType() == Component::Extend) {
-          textValue = mpComponent->getRootParentComponent()->getParameterDisplayString(variable);
+        if (pComponent->getComponentType() == Component::Extend) {
+          textValue = pComponent->getRootParentComponent()->getParameterDisplayString(variable);
         } else {
-          textValue = mpComponent->getRootParentComponent()->getParameterDisplayString(variable);
+          textValue = pComponent->getRootParentComponent()->getParameterDisplayString(variable);
         }
         if (!textValue.isEmpty()) {
-          mTextString.replace(pos, regExp.matchedLength(), textValue);
+          pTextString->replace(pos, regExp.matchedLength(), textValue);
         } else { /* if the value of %\\W* is empty then remove the % sign. */
-          mTextString.replace(pos, 1, "");
+          pTextString->replace(pos, 1, "");
         }
       } else { /* if there is just alone % then remove it. Because if you want to print % then use %%. */
-        mTextString.replace(pos, 1, "");
+        pTextString->replace(pos, 1, "");
       }
     }
     pos += regExp.matchedLength();
@@ -483,27 +518,45 @@ void TextAnnotation::updateTextStringHelper(QRegExp regExp)
 }
 
 /*!
- * \brief TextAnnotation::updateTextString
- * Updates the text to display.
+ * \brief TextAnnotation::getDynamicTextString
+ * Gets the value of the DynamicSelect variable of the textString attribute for the Component.
+ * \param pComponent
+ * \param pTextString - set to the value.
+ * \return false if there is no DynamicSelect or its variable has no value.
  */
-void TextAnnotation::updateTextString()
+bool TextAnnotation::getDynamicTextString(Component *pComponent, QString *pTextString)
 {
-  /* optional DynamicSelect of textString attribute */
   QVariant dynamicValue; // isNull() per default
   if (mDynamicTextString.count() > 0) {
-    dynamicValue = getDynamicValue(mDynamicTextString.at(0).toString());
+    dynamicValue = getDynamicValue(mDynamicTextString.at(0).toString(), pComponent);
   }
-  if (!dynamicValue.isNull()) {
-    mTextString = dynamicValue.toString();
-    if (mTextString.isEmpty()) {
-      /* use variable name as default value if result not found */
-      mTextString = mDynamicTextString.at(0).toString();
-    }
-    else if (mDynamicTextString.count() > 1) {
-      int digits = mDynamicTextString.at(1).toInt();
-      mTextString = QString::number(mTextString.toDouble(), 'g', digits);
-    }
-    return;
+  if (dynamicValue.isNull()) {
+    return false;
+  }
+  *pTextString = dynamicValue.toString();
+  if (pTextString->isEmpty()) {
+    /* use variable name as default value if result not found */
+    *pTextString = mDynamicTextString.at(0).toString();
+  }
+  else if (mDynamicTextString.count() > 1) {
+    int digits = mDynamicTextString.at(1).toInt();
+    *pTextString = QString::number(pTextString->toDouble(), 'g', digits);
+  }
+  return true;
+}
+
+/*!
+ * \brief TextAnnotation::getComponentTextString
+ * Returns the text to display for the Component.
+ * \param pComponent
+ * \return
+ */
+QString TextAnnotation::getComponentTextString(Component *pComponent)
+{
+  QString textString;
+  /* optional DynamicSelect of textString attribute */
+  if (getDynamicTextString(pComponent, &textString)) {
+    return textString;
   }
   /* alternatively use model provided value */
   /* From Modelica Spec 32revision2,
@@ -516,27 +569,37 @@ void TextAnnotation::updateTextString()
    * - %name replaced by the name of the component (i.e. the identifier for it in in the enclosing class).
    * - %class replaced by the name of the class.
    */
-  mTextString = mOriginalTextString;
-  if (!mTextString.contains("%")) {
-    return;
+  textString = mOriginalTextString;
+  if (!textString.contains("%")) {
+    return textString;
   }
   if (mOriginalTextString.toLower().contains("%name")) {
-    mTextString.replace(QRegExp("%name"), mpComponent->getName());
+    textString.replace(QRegExp("%name"), pComponent->getName());
   }
   if (mOriginalTextString.toLower().contains("%class")) {
-    mTextString.replace(QRegExp("%class"), mpComponent->getLibraryTreeItem()->getNameStructure());
+    textString.replace(QRegExp("%class"), pComponent->getLibraryTreeItem()->getNameStructure());
   }
-  if (!mTextString.contains("%")) {
-    return;
+  if (!textString.contains("%")) {
+    return textString;
   }
   /* handle variables now */
-  updateTextStringHelper(QRegExp("(%%|%\\w*)"));
+  updateTextStringHelper(QRegExp("(%%|%\\w*)"), pComponent, &textString);
   /* call again with non-word characters so invalid % can be removed. */
-  updateTextStringHelper(QRegExp("(%%|%\\W*)"));
+  updateTextStringHelper(QRegExp("(%%|%\\W*)"), pComponent, &textString);
   /* handle %% */
   if (mOriginalTextString.toLower().contains("%%")) {
-    mTextString.replace(QRegExp("%%"), "%");
+    textString.replace(QRegExp("%%"), "%");
   }
+  return textString;
+}
+
+/*!
+ * \brief TextAnnotation::updateTextString
+ * Updates the text to display.
+ */
+void TextAnnotation::updateTextString()
+{
+  mTextString = getComponentTextString(mpComponent);
 }
 
 /*!
@@ -545,7 +608,7 @@ void TextAnnotation::updateTextString()
  */
 void TextAnnotation::duplicate()
 {
-  TextAnnotation *pTextAnnotation = new TextAnnotation("", mpGraphicsView);
+  TextAnnotation *pTextAnnotation = new TextAnnotation(AnnotationValue(), mpGraphicsView);
   pTextAnnotation->updateShape(this);
   QPointF gridStep(mpGraphicsView->mCoOrdinateSystem.getHorizontalGridStep() * 5,
                    mpGraphicsView->mCoOrdinateSystem.getVerticalGridStep() * 5);
@@ -43,7 +43,7 @@ class TextAnnotation : public ShapeAnnotation
   Q_OBJECT
 public:
   // Used for icon/diagram shape
-  TextAnnotation(QString annotation, GraphicsView *pGraphicsView);
+  TextAnnotation(const AnnotationValue &annotation, GraphicsView *pGraphicsView);
   // Used for shape inside a component
   TextAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
   // Used for icon/diagram inherited shape
@@ -51,18 +51,22 @@ public:
   // Used for default component
   TextAnnotation(Component *pParent);
   void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationValue &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
   void drawTextAnnotaion(QPainter *painter);
+  void drawTextAnnotaion(QPainter *painter, Component *pComponent, QString textString);
   QString getOMCShapeAnnotation();
   QString getShapeAnnotation();
   void updateShape(ShapeAnnotation *pShapeAnnotation);
+  QString getComponentTextString(Component *pComponent);
+  bool getDynamicTextString(Component *pComponent, QString *pTextString);
 private:
   Component *mpComponent;
 
   void initUpdateTextString();
-  void updateTextStringHelper(QRegExp regExp);
+  void updateTextStringHelper(QRegExp regExp, Component *pComponent, QString *pTextString);
 public slots:
   void updateTextString();
   void duplicate();
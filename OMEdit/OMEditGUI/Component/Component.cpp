@@ -41,6 +41,8 @@
 #include <QMessageBox>
 #include <QMenu>
 #include <QDockWidget>
+#include <QFontMetricsF>
+#include <limits>
 
 /*!
  * \class ComponentInfo
@@ -425,9 +427,182 @@ bool ComponentInfo::isModiferClassRecord(QString modifierName, Component *pCompo
   return result;
 }
 
+/*!
+ * \class SharedShapesItem
+ * \brief Draws the class shapes for a Component.
+ * Instead of cloning them for every Component the item paints the shapes of the class GraphicsView directly.
+ * The Component specific texts and DynamicSelect visibility are kept by the item and applied while painting.
+ */
+/*!
+ * \brief SharedShapesItem::SharedShapesItem
+ * \param pParent
+ */
+SharedShapesItem::SharedShapesItem(Component *pParent)
+  : QGraphicsItem(pParent), mpComponent(pParent)
+{
+  setAcceptedMouseButtons(0);
+  connect(mpComponent, SIGNAL(displayTextChanged()), SLOT(updateTextStrings()));
+}
+
+/*!
+ * \brief SharedShapesItem::addShape
+ * Adds the class shape to the list of shared shapes.
+ * The item is not connected to the shape. The class LibraryTreeItem notifies the Component when its shapes are updated.
+ * \param pShapeAnnotation
+ * \sa Component::handleShapeUpdated()
+ */
+void SharedShapesItem::addShape(ShapeAnnotation *pShapeAnnotation)
+{
+  prepareGeometryChange();
+  mShapesList.append(pShapeAnnotation);
+  updateBoundingRect();
+}
+
+/*!
+ * \brief SharedShapesItem::getShapesList
+ * Returns the shared shapes which still exist in their class.
+ * The shapes are owned by the class GraphicsView and are deleted when it is cleared e.g., on reload.
+ * \return
+ */
+QList<ShapeAnnotation*> SharedShapesItem::getShapesList() const
+{
+  QList<ShapeAnnotation*> shapes;
+  foreach (QPointer<ShapeAnnotation> pShapeAnnotation, mShapesList) {
+    if (pShapeAnnotation && pShapeAnnotation->scene()) {
+      shapes.append(pShapeAnnotation);
+    }
+  }
+  return shapes;
+}
+
+QRectF SharedShapesItem::boundingRect() const
+{
+  return mBoundingRect;
+}
+
+/*!
+ * \brief SharedShapesItem::paint
+ * Paints the shared shapes with their origin and rotation.
+ * The shapes which are deleted from their class i.e., not part of any scene are skipped.
+ * The texts are drawn with the Component specific text string.
+ * \param painter
+ * \param option
+ * \param widget
+ */
+void SharedShapesItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+  // the level of detail of all the shapes is decided from one device size.
+  qreal deviceSize = mpComponent->getDeviceSize(this, painter);
+  if (Component::isDrawnAsBox(deviceSize)) {
+    return;
+  }
+  //! @note We don't show the texts of the Components when rendering the Library Icons. See TextAnnotation::paint().
+  bool textHidden = mpComponent->getGraphicsView()->isRenderingLibraryPixmap() || Component::isTextHidden(deviceSize, painter);
+  foreach (QPointer<ShapeAnnotation> pShapeAnnotation, mShapesList) {
+    if (!pShapeAnnotation || !pShapeAnnotation->scene() || !mVisibleHash.value(pShapeAnnotation, true)) {
+      continue;
+    }
+    TextAnnotation *pTextAnnotation = dynamic_cast<TextAnnotation*>(pShapeAnnotation.data());
+    if (pTextAnnotation && (textHidden || (!pTextAnnotation->getVisible() && pTextAnnotation->getDynamicVisible().isEmpty()))) {
+      continue;
+    }
+    painter->save();
+    painter->translate(pShapeAnnotation->getOrigin());
+    painter->rotate(pShapeAnnotation->getRotation());
+    if (pTextAnnotation) {
+      pTextAnnotation->drawTextAnnotaion(painter, mpComponent, mTextStringsHash.value(pTextAnnotation, pTextAnnotation->getTextString()));
+    } else {
+      pShapeAnnotation->paint(painter, option, widget);
+    }
+    painter->restore();
+  }
+}
+
+/*!
+ * \brief SharedShapesItem::updateShapes
+ * Updates the item when a shared shape is added back, changed or deleted in its class.
+ */
+void SharedShapesItem::updateShapes()
+{
+  prepareGeometryChange();
+  updateBoundingRect();
+  updateTextStrings();
+}
+
+/*!
+ * \brief SharedShapesItem::updateDynamicSelect
+ * Updates the DynamicSelect attributes of the shared shapes to the time selected by the model widget time slider.\n
+ * An attribute whose variable has no value at that time is left unchanged.
+ * \sa ModelWidget::dynamicResultsTimeChanged()
+ */
+void SharedShapesItem::updateDynamicSelect()
+{
+  foreach (QPointer<ShapeAnnotation> pShapeAnnotation, mShapesList) {
+    if (!pShapeAnnotation) {
+      continue;
+    }
+    if (!pShapeAnnotation->getDynamicVisible().isEmpty()) {
+      QVariant dynamicValue = pShapeAnnotation->getDynamicValue(pShapeAnnotation->getDynamicVisible(), mpComponent);
+      if (!dynamicValue.isNull()) {
+        mVisibleHash.insert(pShapeAnnotation, dynamicValue.toBool());
+      }
+    }
+    TextAnnotation *pTextAnnotation = dynamic_cast<TextAnnotation*>(pShapeAnnotation.data());
+    QString textString;
+    if (pTextAnnotation && pTextAnnotation->getDynamicTextString(mpComponent, &textString)) {
+      mTextStringsHash.insert(pTextAnnotation, textString);
+    }
+  }
+  update();
+}
+
+/*!
+ * \brief SharedShapesItem::updateBoundingRect
+ * Updates the bounding rectangle of the item from the shared shapes.
+ * Callers must call prepareGeometryChange() before.
+ */
+void SharedShapesItem::updateBoundingRect()
+{
+  mBoundingRect = QRectF();
+  foreach (QPointer<ShapeAnnotation> pShapeAnnotation, mShapesList) {
+    if (!pShapeAnnotation || !pShapeAnnotation->scene()) {
+      continue;
+    }
+    QTransform transform;
+    transform.translate(pShapeAnnotation->getOrigin().x(), pShapeAnnotation->getOrigin().y());
+    transform.rotate(pShapeAnnotation->getRotation());
+    mBoundingRect |= transform.mapRect(pShapeAnnotation->boundingRect());
+  }
+}
+
+/*!
+ * \brief SharedShapesItem::updateTextStrings
+ * Slot activated when the Component's displayTextChanged SIGNAL is raised.\n
+ * Updates the Component specific texts i.e., %name, %class, %parameter and DynamicSelect values, and the DynamicSelect visibility.
+ */
+void SharedShapesItem::updateTextStrings()
+{
+  mTextStringsHash.clear();
+  mVisibleHash.clear();
+  foreach (QPointer<ShapeAnnotation> pShapeAnnotation, mShapesList) {
+    if (!pShapeAnnotation) {
+      continue;
+    }
+    if (!pShapeAnnotation->getDynamicVisible().isEmpty()) {
+      QVariant dynamicValue = pShapeAnnotation->getDynamicValue(pShapeAnnotation->getDynamicVisible(), mpComponent);
+      mVisibleHash.insert(pShapeAnnotation, dynamicValue.isNull() ? pShapeAnnotation->getVisible() : dynamicValue.toBool());
+    }
+    TextAnnotation *pTextAnnotation = dynamic_cast<TextAnnotation*>(pShapeAnnotation.data());
+    if (pTextAnnotation) {
+      mTextStringsHash.insert(pTextAnnotation, pTextAnnotation->getComponentTextString(mpComponent));
+    }
+  }
+  update();
+}
+
 Component::Component(QString name, LibraryTreeItem *pLibraryTreeItem, QString annotation, QPointF position, ComponentInfo *pComponentInfo,
                      GraphicsView *pGraphicsView)
-  : QGraphicsItem(0), mpReferenceComponent(0), mpParentComponent(0)
+  : QGraphicsItem(0), mpReferenceComponent(0), mpParentComponent(0), mpSharedShapesItem(0)
 {
   setZValue(2000);
   mpLibraryTreeItem = pLibraryTreeItem;
@@ -485,6 +660,7 @@ Component::Component(QString name, LibraryTreeItem *pLibraryTreeItem, QString an
     connect(mpLibraryTreeItem, SIGNAL(loadedForComponent()), SLOT(handleLoaded()));
     connect(mpLibraryTreeItem, SIGNAL(unLoadedForComponent()), SLOT(handleUnloaded()));
     connect(mpLibraryTreeItem, SIGNAL(shapeAddedForComponent()), SLOT(handleShapeAdded()));
+    connect(mpLibraryTreeItem, SIGNAL(shapeUpdatedForComponent()), SLOT(handleShapeUpdated()));
     connect(mpLibraryTreeItem, SIGNAL(componentAddedForComponent()), SLOT(handleComponentAdded()));
   }
   connect(this, SIGNAL(transformHasChanged()), SLOT(updatePlacementAnnotation()));
@@ -497,7 +673,7 @@ Component::Component(QString name, LibraryTreeItem *pLibraryTreeItem, QString an
 }
 
 Component::Component(LibraryTreeItem *pLibraryTreeItem, Component *pParentComponent)
-  : QGraphicsItem(pParentComponent), mpReferenceComponent(0), mpParentComponent(pParentComponent)
+  : QGraphicsItem(pParentComponent), mpReferenceComponent(0), mpParentComponent(pParentComponent), mpSharedShapesItem(0)
 {
   mpLibraryTreeItem = pLibraryTreeItem;
   mpComponentInfo = mpParentComponent->getComponentInfo();
@@ -527,12 +703,13 @@ Component::Component(LibraryTreeItem *pLibraryTreeItem, Component *pParentCompon
     connect(mpLibraryTreeItem, SIGNAL(loadedForComponent()), SLOT(handleLoaded()));
     connect(mpLibraryTreeItem, SIGNAL(unLoadedForComponent()), SLOT(handleUnloaded()));
     connect(mpLibraryTreeItem, SIGNAL(shapeAddedForComponent()), SLOT(handleShapeAdded()));
+    connect(mpLibraryTreeItem, SIGNAL(shapeUpdatedForComponent()), SLOT(handleShapeUpdated()));
     connect(mpLibraryTreeItem, SIGNAL(componentAddedForComponent()), SLOT(handleComponentAdded()));
   }
 }
 
 Component::Component(Component *pComponent, Component *pParentComponent, Component *pRootParentComponent)
-  : QGraphicsItem(pRootParentComponent), mpReferenceComponent(pComponent), mpParentComponent(pParentComponent)
+  : QGraphicsItem(pRootParentComponent), mpReferenceComponent(pComponent), mpParentComponent(pParentComponent), mpSharedShapesItem(0)
 {
   mpLibraryTreeItem = mpReferenceComponent->getLibraryTreeItem();
   mpComponentInfo = mpReferenceComponent->getComponentInfo();
@@ -559,6 +736,7 @@ Component::Component(Component *pComponent, Component *pParentComponent, Compone
     connect(mpLibraryTreeItem, SIGNAL(loadedForComponent()), SLOT(handleLoaded()));
     connect(mpLibraryTreeItem, SIGNAL(unLoadedForComponent()), SLOT(handleUnloaded()));
     connect(mpLibraryTreeItem, SIGNAL(shapeAddedForComponent()), SLOT(handleShapeAdded()));
+    connect(mpLibraryTreeItem, SIGNAL(shapeUpdatedForComponent()), SLOT(handleShapeUpdated()));
     connect(mpLibraryTreeItem, SIGNAL(componentAddedForComponent()), SLOT(handleComponentAdded()));
   }
   connect(mpReferenceComponent, SIGNAL(added()), SLOT(referenceComponentAdded()));
@@ -568,7 +746,7 @@ Component::Component(Component *pComponent, Component *pParentComponent, Compone
 }
 
 Component::Component(Component *pComponent, GraphicsView *pGraphicsView)
-  : QGraphicsItem(0), mpReferenceComponent(pComponent), mpParentComponent(0)
+  : QGraphicsItem(0), mpReferenceComponent(pComponent), mpParentComponent(0), mpSharedShapesItem(0)
 {
   setZValue(2000);
   mpLibraryTreeItem = mpReferenceComponent->getLibraryTreeItem();
@@ -620,7 +798,7 @@ Component::Component(Component *pComponent, GraphicsView *pGraphicsView)
 }
 
 Component::Component(ComponentInfo *pComponentInfo, Component *pParentComponent)
-  : QGraphicsItem(pParentComponent), mpReferenceComponent(0), mpParentComponent(pParentComponent)
+  : QGraphicsItem(pParentComponent), mpReferenceComponent(0), mpParentComponent(pParentComponent), mpSharedShapesItem(0)
 {
   mpLibraryTreeItem = 0;
   mpComponentInfo = pComponentInfo;
@@ -772,20 +950,75 @@ QRectF Component::itemsBoundingRect()
   foreach (Component *pComponent, mComponentsList) {
     rect |= pComponent->itemsBoundingRect();
   }
-  foreach (QGraphicsItem *item, mShapesList) {
-    rect |= item->sceneBoundingRect();
+  if (mpSharedShapesItem) {
+    rect |= mpSharedShapesItem->sceneBoundingRect();
   }
   return rect;
 }
 
+/*!
+ * \brief Component::paint
+ * Draws a simple box in place of the shapes when the Component is too small on the screen.
+ * \param painter
+ * \param option
+ * \param widget
+ */
 void Component::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-  Q_UNUSED(painter);
   Q_UNUSED(option);
   Q_UNUSED(widget);
   if (mTransformation.isValid()) {
     setVisible(mTransformation.getVisible());
   }
+  if (!mpParentComponent && isDrawnAsBox(getDeviceSize(this, painter))) {
+    painter->setPen(QPen(QBrush(QColor(128, 128, 128)), 0));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(boundingRect());
+  }
+}
+
+/*!
+ * \brief Component::isDrawnAsBox
+ * Checks if the root Component is so small on the screen that it is drawn as a simple box instead of its shapes.
+ * \param deviceSize - the size of the root Component on the screen. See Component::getDeviceSize().
+ * \return
+ */
+bool Component::isDrawnAsBox(qreal deviceSize)
+{
+  // size in pixels below which the shapes are not distinguishable anymore.
+  return deviceSize < 8;
+}
+
+/*!
+ * \brief Component::isTextHidden
+ * Checks if the root Component is so small on the screen that its texts are not legible.
+ * The texts are hidden once the whole Component is smaller than one line of text of the painter font.
+ * \param deviceSize - the size of the root Component on the screen. See Component::getDeviceSize().
+ * \param painter
+ * \return
+ */
+bool Component::isTextHidden(qreal deviceSize, QPainter *painter)
+{
+  return deviceSize < QFontMetricsF(painter->font()).height();
+}
+
+/*!
+ * \brief Component::getDeviceSize
+ * Returns the larger side in device coordinates of the root Component, using the painter of pItem.
+ * The level of detail is not reduced when the library pixmaps are rendered.
+ * \param pItem
+ * \param painter
+ * \return
+ */
+qreal Component::getDeviceSize(const QGraphicsItem *pItem, QPainter *painter)
+{
+  Component *pRootComponent = getRootParentComponent();
+  if (pRootComponent->getGraphicsView()->isRenderingLibraryPixmap()) {
+    return std::numeric_limits<qreal>::max();
+  }
+  QTransform transform = pRootComponent->itemTransform(pItem) * painter->worldTransform();
+  QRectF rectangle = transform.mapRect(pRootComponent->boundingRect());
+  return qMax(rectangle.width(), rectangle.height());
 }
 
 Component* Component::getRootParentComponent()
@@ -797,6 +1030,20 @@ Component* Component::getRootParentComponent()
   return pComponent;
 }
 
+/*!
+ * \brief Component::getShapesList
+ * Returns the class shapes drawn by the Component.
+ * The shapes are owned by the class and are only returned if they still exist.
+ * \return
+ */
+QList<ShapeAnnotation*> Component::getShapesList()
+{
+  if (mpSharedShapesItem) {
+    return mpSharedShapesItem->getShapesList();
+  }
+  return QList<ShapeAnnotation*>();
+}
+
 /*!
  * \brief Component::getCoOrdinateSystem
  * \return
@@ -1068,12 +1315,12 @@ void Component::removeChildren()
     delete pComponent;
   }
   mComponentsList.clear();
-  foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
-    pShapeAnnotation->setParentItem(0);
-    mpGraphicsView->removeItem(pShapeAnnotation);
-    delete pShapeAnnotation;
+  if (mpSharedShapesItem) {
+    mpSharedShapesItem->setParentItem(0);
+    mpGraphicsView->removeItem(mpSharedShapesItem);
+    delete mpSharedShapesItem;
+    mpSharedShapesItem = 0;
   }
-  mShapesList.clear();
 }
 
 void Component::emitAdded()
@@ -1217,6 +1464,18 @@ void Component::shapeDeleted()
   }
 }
 
+/*!
+ * \brief Component::updateDynamicSelect
+ * Updates the DynamicSelect attributes of the class shapes to the time selected by the model widget time slider.
+ * \sa ModelWidget::dynamicResultsTimeChanged()
+ */
+void Component::updateDynamicSelect()
+{
+  if (mpSharedShapesItem) {
+    mpSharedShapesItem->updateDynamicSelect();
+  }
+}
+
 /*!
  * \brief Component::renameComponentInConnections
  * Called when OMCProxy::renameComponentInClass() is used. Updates the components name in connections list.\n
@@ -1421,6 +1680,7 @@ void Component::createClassInheritedComponents()
 /*!
  * \brief Component::createClassShapes
  * Creates a class shapes.
+ * The shapes are not copied. They are drawn by a SharedShapesItem together with the Component specific texts.
  */
 void Component::createClassShapes()
 {
@@ -1436,21 +1696,15 @@ void Component::createClassShapes()
         pGraphicsView = mpLibraryTreeItem->getModelWidget()->getDiagramGraphicsView();
       }
     }
+    if (pGraphicsView->getShapesList().isEmpty()) {
+      return;
+    }
+    // the shapes belong to the class GraphicsView so they are only referenced by the SharedShapesItem.
+    mpSharedShapesItem = new SharedShapesItem(this);
     foreach (ShapeAnnotation *pShapeAnnotation, pGraphicsView->getShapesList()) {
-      if (dynamic_cast<LineAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new LineAnnotation(pShapeAnnotation, this));
-      } else if (dynamic_cast<PolygonAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new PolygonAnnotation(pShapeAnnotation, this));
-      } else if (dynamic_cast<RectangleAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new RectangleAnnotation(pShapeAnnotation, this));
-      } else if (dynamic_cast<EllipseAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new EllipseAnnotation(pShapeAnnotation, this));
-      } else if (dynamic_cast<TextAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new TextAnnotation(pShapeAnnotation, this));
-      } else if (dynamic_cast<BitmapAnnotation*>(pShapeAnnotation)) {
-        mShapesList.append(new BitmapAnnotation(pShapeAnnotation, this));
-      }
+      mpSharedShapesItem->addShape(pShapeAnnotation);
     }
+    mpSharedShapesItem->updateTextStrings();
   }
 }
 
@@ -1814,6 +2068,21 @@ void Component::handleUnloaded()
   pComponent->updateConnections();
 }
 
+/*!
+ * \brief Component::handleShapeUpdated
+ * Slot activated when a shape of Component's class is added back, changed or deleted and LibraryTreeItem::shapeUpdatedForComponent() SIGNAL is raised.
+ */
+void Component::handleShapeUpdated()
+{
+  if (mpSharedShapesItem) {
+    mpSharedShapesItem->updateShapes();
+  }
+  showNonExistingOrDefaultComponentIfNeeded();
+  if (mpGraphicsView->getViewType() == StringHandler::Icon) {
+    mpGraphicsView->getModelWidget()->getLibraryTreeItem()->handleIconUpdated();
+  }
+}
+
 /*!
  * \brief Component::handleShapeAdded
  * Slot activated when a new shape is added to Component's class and LibraryTreeItem::shapeAdded() SIGNAL is raised.
@@ -2035,6 +2304,16 @@ void Component::componentCommentHasChanged()
  */
 void Component::componentNameHasChanged()
 {
+  QString oldName = mpGraphicsView->updateComponentName(this);
+  // Icon and Diagram connectors share the ComponentInfo so update the components hash of the other view as well.
+  if (!oldName.isEmpty()) {
+    ModelWidget *pModelWidget = mpGraphicsView->getModelWidget();
+    if (mpGraphicsView->getViewType() == StringHandler::Icon && pModelWidget->getDiagramGraphicsView()) {
+      pModelWidget->getDiagramGraphicsView()->updateComponentsNames(oldName);
+    } else if (mpGraphicsView->getViewType() == StringHandler::Diagram && pModelWidget->getIconGraphicsView()) {
+      pModelWidget->getIconGraphicsView()->updateComponentsNames(oldName);
+    }
+  }
   updateToolTip();
   displayTextChangedRecursive();
   update();
@@ -47,6 +47,8 @@
 #include "Annotations/TextAnnotation.h"
 #include "Annotations/BitmapAnnotation.h"
 
+#include <QPointer>
+
 class OMCProxy;
 class GraphicsScene;
 class GraphicsView;
@@ -57,6 +59,7 @@ class EllipseAnnotation;
 class TextAnnotation;
 class BitmapAnnotation;
 class LibraryTreeItem;
+class Component;
 
 class ComponentInfo : public QObject
 {
@@ -161,6 +164,30 @@ private:
   bool isModiferClassRecord(QString modifierName, Component *pComponent);
 };
 
+class SharedShapesItem : public QObject, public QGraphicsItem
+{
+  Q_OBJECT
+  Q_INTERFACES(QGraphicsItem)
+public:
+  SharedShapesItem(Component *pParent);
+  void addShape(ShapeAnnotation *pShapeAnnotation);
+  QList<ShapeAnnotation*> getShapesList() const;
+  QRectF boundingRect() const;
+  void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
+  void updateShapes();
+  void updateDynamicSelect();
+private:
+  Component *mpComponent;
+  QList<QPointer<ShapeAnnotation> > mShapesList;
+  QRectF mBoundingRect;
+  // the Component specific texts and DynamicSelect visibility of the shared shapes.
+  QHash<ShapeAnnotation*, QString> mTextStringsHash;
+  QHash<ShapeAnnotation*, bool> mVisibleHash;
+  void updateBoundingRect();
+public slots:
+  void updateTextStrings();
+};
+
 class Component : public QObject, public QGraphicsItem
 {
   Q_OBJECT
@@ -184,6 +211,9 @@ public:
   QRectF boundingRect() const;
   QRectF itemsBoundingRect();
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
+  qreal getDeviceSize(const QGraphicsItem *pItem, QPainter *painter);
+  static bool isDrawnAsBox(qreal deviceSize);
+  static bool isTextHidden(qreal deviceSize, QPainter *painter);
   LibraryTreeItem* getLibraryTreeItem() {return mpLibraryTreeItem;}
   QString getName() {return mpComponentInfo->getName();}
   GraphicsView* getGraphicsView() {return mpGraphicsView;}
@@ -205,7 +235,7 @@ public:
   QAction* getViewDocumentationAction() {return mpViewDocumentationAction;}
   QAction* getSubModelAttributesAction() {return mpSubModelAttributesAction;}
   ComponentInfo* getComponentInfo() {return mpComponentInfo;}
-  QList<ShapeAnnotation*> getShapesList() {return mShapesList;}
+  QList<ShapeAnnotation*> getShapesList();
   QList<Component*> getInheritedComponentsList() {return mInheritedComponentsList;}
   QList<Component*> getComponentsList() {return mComponentsList;}
   void setOldScenePosition(QPointF oldScenePosition) {mOldScenePosition = oldScenePosition;}
@@ -234,6 +264,7 @@ public:
   void shapeAdded();
   void shapeUpdated();
   void shapeDeleted();
+  void updateDynamicSelect();
   void renameComponentInConnections(QString newName);
   void insertInterfacePoint(QString interfaceName, QString position, QString angle321, int dimensions, QString causality, QString domain);
   void removeInterfacePoint(QString interfaceName);
@@ -275,7 +306,7 @@ private:
   qreal mXFactor;
   qreal mYFactor;
   QList<Component*> mInheritedComponentsList;
-  QList<ShapeAnnotation*> mShapesList;
+  SharedShapesItem *mpSharedShapesItem;
   QList<Component*> mComponentsList;
   QPointF mOldScenePosition;
   QPointF mOldPosition;
@@ -312,6 +343,7 @@ public slots:
   void handleLoaded();
   void handleUnloaded();
   void handleShapeAdded();
+  void handleShapeUpdated();
   void handleComponentAdded();
   void referenceComponentAdded();
   void referenceComponentTransformHasChanged();
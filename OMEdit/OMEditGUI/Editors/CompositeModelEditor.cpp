@@ -300,6 +300,7 @@ void CompositeModelEditor::setCompositeModelName(QString name)
 bool CompositeModelEditor::addSubModel(Component *pComponent)
 {
   pComponent->getComponentInfo()->setName(pComponent->getName().remove("."));
+  pComponent->getGraphicsView()->updateComponentName(pComponent);
   QDomElement subModels = getSubModelsElement();
   if (!subModels.isNull()) {
     QDomElement subModel = mXmlDocument.createElement("SubModel");
@@ -349,6 +349,16 @@ ModelicaHighlighter::ModelicaHighlighter(ModelicaEditorPage *pModelicaEditorPage
 {
   mpModelicaEditorPage = pModelicaEditorPage;
   mpPlainTextEdit = pPlainTextEdit;
+  // keywords
+  mKeywords << "algorithm" << "and" << "annotation" << "assert" << "block" << "break" << "class" << "connect" << "connector" << "constant"
+            << "constrainedby" << "der" << "discrete" << "each" << "else" << "elseif" << "elsewhen" << "encapsulated" << "end"
+            << "enumeration" << "equation" << "expandable" << "extends" << "external" << "false" << "final" << "flow" << "for"
+            << "function" << "if" << "import" << "impure" << "in" << "initial" << "inner" << "input" << "loop" << "model" << "not"
+            << "operator" << "or" << "outer" << "output" << "optimization" << "package" << "parameter" << "partial" << "protected"
+            << "public" << "pure" << "record" << "redeclare" << "replaceable" << "return" << "stream" << "then" << "true" << "type"
+            << "when" << "while" << "within";
+  // Modelica types
+  mTypes << "String" << "Integer" << "Boolean" << "Real";
   initializeSettings();
 }
 
@@ -361,8 +371,6 @@ void ModelicaHighlighter::initializeSettings()
   mpPlainTextEdit->document()->setDefaultFont(font);
   mpPlainTextEdit->setTabStopWidth(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getTabSizeSpinBox()->value() * QFontMetrics(font).width(QLatin1Char(' ')));
   // set color highlighting
-  mHighlightingRules.clear();
-  HighlightingRule rule;
   mTextFormat.setForeground(mpModelicaEditorPage->getColor("Text"));
   mKeywordFormat.setForeground(mpModelicaEditorPage->getColor("Keyword"));
   mTypeFormat.setForeground(mpModelicaEditorPage->getColor("Type"));
@@ -370,104 +378,56 @@ void ModelicaHighlighter::initializeSettings()
   mMultiLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
   mFunctionFormat.setForeground(mpModelicaEditorPage->getColor("Function"));
   mQuotationFormat.setForeground(mpModelicaEditorPage->getColor("Quotes"));
-  // Priority: keyword > func() > ident > number. Yes, the order matters :)
   mNumberFormat.setForeground(mpModelicaEditorPage->getColor("Number"));
-  rule.mPattern = QRegExp("[0-9][0-9]*([.][0-9]*)?([eE][+-]?[0-9]*)?");
-  rule.mFormat = mNumberFormat;
-  mHighlightingRules.append(rule);
-  rule.mPattern = QRegExp("\\b[A-Za-z_][A-Za-z0-9_]*");
-  rule.mFormat = mTextFormat;
-  mHighlightingRules.append(rule);
-  // functions
-  rule.mPattern = QRegExp("\\b[A-Za-z0-9_]+(?=\\()");
-  rule.mFormat = mFunctionFormat;
-  mHighlightingRules.append(rule);
-  // keywords
-  QStringList keywordPatterns;
-  keywordPatterns << "\\balgorithm\\b"
-                  << "\\band\\b"
-                  << "\\bannotation\\b"
-                  << "\\bassert\\b"
-                  << "\\bblock\\b"
-                  << "\\bbreak\\b"
-                  << "\\bBoolean\\b"
-                  << "\\bclass\\b"
-                  << "\\bconnect\\b"
-                  << "\\bconnector\\b"
-                  << "\\bconstant\\b"
-                  << "\\bconstrainedby\\b"
-                  << "\\bder\\b"
-                  << "\\bdiscrete\\b"
-                  << "\\beach\\b"
-                  << "\\belse\\b"
-                  << "\\belseif\\b"
-                  << "\\belsewhen\\b"
-                  << "\\bencapsulated\\b"
-                  << "\\bend\\b"
-                  << "\\benumeration\\b"
-                  << "\\bequation\\b"
-                  << "\\bexpandable\\b"
-                  << "\\bextends\\b"
-                  << "\\bexternal\\b"
-                  << "\\bfalse\\b"
-                  << "\\bfinal\\b"
-                  << "\\bflow\\b"
-                  << "\\bfor\\b"
-                  << "\\bfunction\\b"
-                  << "\\bif\\b"
-                  << "\\bimport\\b"
-                  << "\\bimpure\\b"
-                  << "\\bin\\b"
-                  << "\\binitial\\b"
-                  << "\\binner\\b"
-                  << "\\binput\\b"
-                  << "\\bloop\\b"
-                  << "\\bmodel\\b"
-                  << "\\bnot\\b"
-                  << "\\boperator\\b"
-                  << "\\bor\\b"
-                  << "\\bouter\\b"
-                  << "\\boutput\\b"
-                  << "\\boptimization\\b"
-                  << "\\bpackage\\b"
-                  << "\\bparameter\\b"
-                  << "\\bpartial\\b"
-                  << "\\bprotected\\b"
-                  << "\\bpublic\\b"
-                  << "\\bpure\\b"
-                  << "\\brecord\\b"
-                  << "\\bredeclare\\b"
-                  << "\\breplaceable\\b"
-                  << "\\breturn\\b"
-                  << "\\bstream\\b"
-                  << "\\bthen\\b"
-                  << "\\btrue\\b"
-                  << "\\btype\\b"
-                  << "\\bwhen\\b"
-                  << "\\bwhile\\b"
-                  << "\\bwithin\\b";
-  foreach (const QString &pattern, keywordPatterns) {
-    rule.mPattern = QRegExp(pattern);
-    rule.mFormat = mKeywordFormat;
-    mHighlightingRules.append(rule);
+}
+
+/*!
+ * \brief ModelicaHighlighter::indexOfAnnotation
+ * Returns the index of the annotation keyword as a whole word in text or -1.
+ * \param text
+ * \return
+ */
+int ModelicaHighlighter::indexOfAnnotation(const QString &text)
+{
+  static const QLatin1String annotation("annotation");
+  static const int annotationLength = 10;
+  int index = text.indexOf(annotation);
+  while (index >= 0) {
+    int endIndex = index + annotationLength;
+    if ((index == 0 || !(text[index - 1].isLetterOrNumber() || text[index - 1] == '_')) &&
+        (endIndex == text.length() || !(text[endIndex].isLetterOrNumber() || text[endIndex] == '_'))) {
+      return index;
+    }
+    index = text.indexOf(annotation, endIndex);
   }
-  // Modelica types
-  QStringList typePatterns;
-  typePatterns << "\\bString\\b"
-               << "\\bInteger\\b"
-               << "\\bBoolean\\b"
-               << "\\bReal\\b";
-  foreach (const QString &pattern, typePatterns) {
-    rule.mPattern = QRegExp(pattern);
-    rule.mFormat = mTypeFormat;
-    mHighlightingRules.append(rule);
+  return -1;
+}
+
+/*!
+ * \brief ModelicaHighlighter::highlightWord
+ * Highlights the identifier text[startIndex, endIndex) as keyword, type, function call or plain text.
+ * Priority: type > keyword > func() > ident.
+ * \param text
+ * \param startIndex
+ * \param endIndex
+ */
+void ModelicaHighlighter::highlightWord(const QString &text, int startIndex, int endIndex)
+{
+  // wraps the characters of text without copying them.
+  const QString word = QString::fromRawData(text.constData() + startIndex, endIndex - startIndex);
+  if (mTypes.contains(word)) {
+    setFormat(startIndex, endIndex - startIndex, mTypeFormat);
+  } else if (mKeywords.contains(word)) {
+    setFormat(startIndex, endIndex - startIndex, mKeywordFormat);
+  } else if (endIndex < text.length() && text[endIndex] == '(') {
+    setFormat(startIndex, endIndex - startIndex, mFunctionFormat);
   }
 }
 
 /*!
  * \brief ModelicaTextHighlighter::highlightMultiLine
- * Highlights the multilines text.
- * Quoted text or multiline comments.
+ * Highlights the block in a single pass.
+ * Identifiers, keywords, types, numbers, quoted text and comments. Multiline comments and quotes are carried in the block state.
  * \param text
  */
 void ModelicaHighlighter::highlightMultiLine(const QString &text)
@@ -481,8 +441,8 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
   if (pPreviousTextBlockUserData) {
     foldingState = pPreviousTextBlockUserData->foldingState();
   }
-  QRegExp annotationRegExp("\\bannotation\\b");
-  int annotationIndex = annotationRegExp.indexIn(text);
+  int annotationIndex = indexOfAnnotation(text);
+  bool matchParenthesesCommentsQuotes = mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked();
   // store parentheses info
   Parentheses parentheses;
   TextBlockUserData *pTextBlockUserData = BaseEditorDocumentLayout::userData(currentBlock());
@@ -527,10 +487,48 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
         } else if (text[index] == '"') {
           startIndex = index;
           blockState = 3;
+        } else if (text[index].isLetter() || text[index] == '_') {
+          // identifiers, keywords and types
+          int wordEndIndex = index + 1;
+          while (wordEndIndex < text.length() && (text[wordEndIndex].isLetterOrNumber() || text[wordEndIndex] == '_')) {
+            wordEndIndex++;
+          }
+          highlightWord(text, index, wordEndIndex);
+          // check for annotation start
+          if (!foldingState && wordEndIndex - index == 10 && text.midRef(index, 10) == QLatin1String("annotation")) {
+            // if we just have annotation keyword in the line or annotation keyword is followed by '(' or space.
+            if (wordEndIndex == text.length() || text[wordEndIndex] == '(' || text[wordEndIndex] == ' ') {
+              foldingState = true;
+            }
+          }
+          index = wordEndIndex - 1;
+        } else if (text[index].isDigit()) {
+          // numbers e.g., 1, 1.5, 1.5e-3
+          int numberEndIndex = index + 1;
+          while (numberEndIndex < text.length() && text[numberEndIndex].isDigit()) {
+            numberEndIndex++;
+          }
+          if (numberEndIndex < text.length() && text[numberEndIndex] == '.') {
+            numberEndIndex++;
+            while (numberEndIndex < text.length() && text[numberEndIndex].isDigit()) {
+              numberEndIndex++;
+            }
+          }
+          if (numberEndIndex < text.length() && (text[numberEndIndex] == 'e' || text[numberEndIndex] == 'E')) {
+            numberEndIndex++;
+            if (numberEndIndex < text.length() && (text[numberEndIndex] == '+' || text[numberEndIndex] == '-')) {
+              numberEndIndex++;
+            }
+            while (numberEndIndex < text.length() && text[numberEndIndex].isDigit()) {
+              numberEndIndex++;
+            }
+          }
+          setFormat(index, numberEndIndex - index, mNumberFormat);
+          index = numberEndIndex - 1;
         }
     }
     // if no single line comment, no multi line comment and no quotes then store the parentheses
-    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked())) {
+    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || matchParenthesesCommentsQuotes)) {
       if (text[index] == '(' || text[index] == '{' || text[index] == '[') {
         parentheses.append(Parenthesis(Parenthesis::Opened, text[index], index));
       } else if (text[index] == ')' || text[index] == '}' || text[index] == ']') {
@@ -564,21 +562,6 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
       } else if (pTextBlockUserData && startIndex < annotationIndex) {  // if we have annotation word before quote or comment block is starting then fold.
         pTextBlockUserData->setFoldingIndent(1);
       }
-    } else {
-      // if no single line comment, no multi line comment and no quotes then check for annotation start
-      if (blockState < 1 || blockState > 3) {
-        if (text[index] == 'a' && index+9<text.length() && text[index+1] == 'n' && text[index+2] == 'n' && text[index+3] == 'o'
-            && text[index+4] == 't' && text[index+5] == 'a' && text[index+6] == 't' && text[index+7] == 'i' && text[index+8] == 'o'
-            && text[index+9] == 'n') {
-          if (index+9 == text.length() - 1) { // if we just have annotation keyword in the line
-            index = index + 8;
-            foldingState = true;
-          } else if (index+10<text.length() && (text[index+10] == '(' || text[index+10] == ' ')) { // if annotation keyword is followed by '(' or space.
-            index = index + 9;
-            foldingState = true;
-          }
-        }
-      }
     }
     index++;
   }
@@ -619,16 +602,7 @@ void ModelicaHighlighter::highlightBlock(const QString &text)
   if (pTextBlockUserData) {
     pTextBlockUserData->setFoldingState(false);
   }
-  setFormat(0, text.length(), mpModelicaEditorPage->getColor("Text"));
-  foreach (const HighlightingRule &rule, mHighlightingRules) {
-    QRegExp expression(rule.mPattern);
-    int index = expression.indexIn(text);
-    while (index >= 0) {
-      int length = expression.matchedLength();
-      setFormat(index, length, rule.mFormat);
-      index = expression.indexIn(text, index + length);
-    }
-  }
+  setFormat(0, text.length(), mTextFormat);
   highlightMultiLine(text);
 }
 
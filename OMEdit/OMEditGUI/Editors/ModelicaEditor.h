@@ -80,14 +80,12 @@ public:
 protected:
   virtual void highlightBlock(const QString &text);
 private:
+  static int indexOfAnnotation(const QString &text);
+  void highlightWord(const QString &text, int startIndex, int endIndex);
   ModelicaEditorPage *mpModelicaEditorPage;
   QPlainTextEdit *mpPlainTextEdit;
-  struct HighlightingRule
-  {
-    QRegExp mPattern;
-    QTextCharFormat mFormat;
-  };
-  QVector<HighlightingRule> mHighlightingRules;
+  QSet<QString> mKeywords;
+  QSet<QString> mTypes;
   QTextCharFormat mTextFormat;
   QTextCharFormat mKeywordFormat;
   QTextCharFormat mTypeFormat;
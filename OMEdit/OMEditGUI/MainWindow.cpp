@@ -352,7 +352,7 @@ void MainWindow::setUpMainWindow()
   if (OptionsDialog::instance()->getGeneralSettingsPage()->getPreserveUserCustomizations())
   {
     restoreGeometry(pSettings->value("application/geometry").toByteArray());
-    bool restoreMessagesWidget = !MessagesWidget::instance()->getMessagesTextBrowser()->toPlainText().isEmpty();
+    bool restoreMessagesWidget = MessagesWidget::instance()->getMessagesModel()->rowCount() > 0;
     restoreState(pSettings->value("application/windowState").toByteArray());
     pSettings->beginGroup("algorithmicDebugger");
     /* restore stackframes list and locals columns width */
@@ -718,12 +718,33 @@ void MainWindow::instantiateModel(LibraryTreeItem *pLibraryTreeItem)
   if (OptionsDialog::instance()->getMessagesPage()->getResetMessagesNumberBeforeSimulationCheckBox()->isChecked()) {
     MessagesWidget::instance()->resetMessagesNumber();
   }
-  QString instantiateModelResult = mpOMCProxy->instantiateModel(pLibraryTreeItem->getNameStructure());
+  // instantiating can take long so don't wait for it.
+  OMCCommand *pOMCCommand = mpOMCProxy->instantiateModelAsync(pLibraryTreeItem->getNameStructure());
+  if (pOMCCommand) {
+    pOMCCommand->setProperty("className", pLibraryTreeItem->getNameStructure());
+    connect(pOMCCommand, SIGNAL(finished(QString)), SLOT(instantiateModelFinished(QString)));
+  } else {
+    hideProgressBar();
+    mpStatusBar->clearMessage();
+  }
+}
+
+/*!
+ * \brief MainWindow::instantiateModelFinished
+ * Slot activated when the instantiateModel command sent by MainWindow::instantiateModel(LibraryTreeItem*) is finished.
+ * \param result
+ */
+void MainWindow::instantiateModelFinished(QString result)
+{
+  QString className = sender()->property("className").toString();
+  QString instantiateModelResult = StringHandler::unparse(result);
+  mpOMCProxy->printMessagesStringInternal();
+  mpLibraryWidget->getLibraryTreeModel()->loadDependentLibraries(mpOMCProxy->getClassNames());
   if (!instantiateModelResult.isEmpty()) {
     MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
-                                                tr("Instantiation of %1 completed successfully.").arg(pLibraryTreeItem->getNameStructure()),
+                                                tr("Instantiation of %1 completed successfully.").arg(className),
                                                 Helper::scriptingKind, Helper::notificationLevel));
-    QString windowTitle = QString(Helper::instantiateModel).append(" - ").append(pLibraryTreeItem->getNameStructure());
+    QString windowTitle = QString(Helper::instantiateModel).append(" - ").append(className);
     InformationDialog *pInformationDialog = new InformationDialog(windowTitle, instantiateModelResult, true, this);
     pInformationDialog->show();
   }
@@ -750,12 +771,33 @@ void MainWindow::checkModel(LibraryTreeItem *pLibraryTreeItem)
   if (OptionsDialog::instance()->getMessagesPage()->getResetMessagesNumberBeforeSimulationCheckBox()->isChecked()) {
     MessagesWidget::instance()->resetMessagesNumber();
   }
-  QString checkModelResult = mpOMCProxy->checkModel(pLibraryTreeItem->getNameStructure());
+  // checking can take long so don't wait for it.
+  OMCCommand *pOMCCommand = mpOMCProxy->checkModelAsync(pLibraryTreeItem->getNameStructure());
+  if (pOMCCommand) {
+    pOMCCommand->setProperty("className", pLibraryTreeItem->getNameStructure());
+    connect(pOMCCommand, SIGNAL(finished(QString)), SLOT(checkModelFinished(QString)));
+  } else {
+    hideProgressBar();
+    mpStatusBar->clearMessage();
+  }
+}
+
+/*!
+ * \brief MainWindow::checkModelFinished
+ * Slot activated when the checkModel command sent by MainWindow::checkModel(LibraryTreeItem*) is finished.
+ * \param result
+ */
+void MainWindow::checkModelFinished(QString result)
+{
+  QString className = sender()->property("className").toString();
+  QString checkModelResult = StringHandler::unparse(result);
+  mpOMCProxy->printMessagesStringInternal();
+  mpLibraryWidget->getLibraryTreeModel()->loadDependentLibraries(mpOMCProxy->getClassNames());
   if (!checkModelResult.isEmpty()) {
     MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
-                                                tr("Check of %1 completed successfully.").arg(pLibraryTreeItem->getNameStructure()),
+                                                tr("Check of %1 completed successfully.").arg(className),
                                                 Helper::scriptingKind, Helper::notificationLevel));
-    QString windowTitle = QString(Helper::checkModel).append(" - ").append(pLibraryTreeItem->getNameStructure());
+    QString windowTitle = QString(Helper::checkModel).append(" - ").append(className);
     InformationDialog *pInformationDialog = new InformationDialog(windowTitle, checkModelResult, false, this);
     pInformationDialog->show();
   }
@@ -778,7 +820,26 @@ void MainWindow::checkAllModels(LibraryTreeItem *pLibraryTreeItem)
   // show the progress bar
   mpProgressBar->setRange(0, 0);
   showProgressBar();
-  QString checkAllModelsResult = mpOMCProxy->checkAllModelsRecursive(pLibraryTreeItem->getNameStructure());
+  // checking can take long so don't wait for it.
+  OMCCommand *pOMCCommand = mpOMCProxy->checkAllModelsRecursiveAsync(pLibraryTreeItem->getNameStructure());
+  if (pOMCCommand) {
+    connect(pOMCCommand, SIGNAL(finished(QString)), SLOT(checkAllModelsFinished(QString)));
+  } else {
+    hideProgressBar();
+    mpStatusBar->clearMessage();
+  }
+}
+
+/*!
+ * \brief MainWindow::checkAllModelsFinished
+ * Slot activated when the checkAllModelsRecursive command sent by MainWindow::checkAllModels(LibraryTreeItem*) is finished.
+ * \param result
+ */
+void MainWindow::checkAllModelsFinished(QString result)
+{
+  QString checkAllModelsResult = StringHandler::unparse(result);
+  mpOMCProxy->printMessagesStringInternal();
+  mpLibraryWidget->getLibraryTreeModel()->loadDependentLibraries(mpOMCProxy->getClassNames());
   if (!checkAllModelsResult.isEmpty()) {
     MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, checkAllModelsResult, Helper::scriptingKind,
                                                 Helper::notificationLevel));
@@ -1414,8 +1475,13 @@ void MainWindow::loadSystemLibrary()
       if (pAction->text().compare("OpenModelica") == 0) {
         pLibraryTreeModel->createLibraryTreeItem(pAction->text(), pLibraryTreeModel->getRootLibraryTreeItem(), true, true, true);
         pLibraryTreeModel->checkIfAnyNonExistingClassLoaded();
-      } else if (mpOMCProxy->loadModel(pAction->text())) {
-        mpLibraryWidget->getLibraryTreeModel()->loadDependentLibraries(mpOMCProxy->getClassNames());
+      } else {
+        // loading a library can take long so don't wait for it.
+        OMCCommand *pOMCCommand = mpOMCProxy->loadModelAsync(pAction->text());
+        if (pOMCCommand) {
+          connect(pOMCCommand, SIGNAL(finished(QString)), SLOT(loadSystemLibraryFinished(QString)));
+          return;
+        }
       }
       mpStatusBar->clearMessage();
       hideProgressBar();
@@ -1423,6 +1489,22 @@ void MainWindow::loadSystemLibrary()
   }
 }
 
+/*!
+ * \brief MainWindow::loadSystemLibraryFinished
+ * Slot activated when the loadModel command sent by MainWindow::loadSystemLibrary is finished.
+ * \param result
+ */
+void MainWindow::loadSystemLibraryFinished(QString result)
+{
+  bool loaded = StringHandler::unparseBool(result);
+  mpOMCProxy->printMessagesStringInternal();
+  if (loaded) {
+    mpLibraryWidget->getLibraryTreeModel()->loadDependentLibraries(mpOMCProxy->getClassNames());
+  }
+  mpStatusBar->clearMessage();
+  hideProgressBar();
+}
+
 /*!
  * \brief MainWindow::writeOutputFileData
  * Writes the output data from stdout file and adds it to MessagesWidget.
@@ -477,6 +477,10 @@ private slots:
   void cleanWorkingDirectory();
   void pushTraceabilityInformation();
   void queryTraceabilityInformation();
+  void loadSystemLibraryFinished(QString result);
+  void instantiateModelFinished(QString result);
+  void checkModelFinished(QString result);
+  void checkAllModelsFinished(QString result);
 private:
   void createActions();
   void createToolbars();
@@ -42,6 +42,8 @@
 #include "ModelicaClassDialog.h"
 #include "Git/GitCommands.h"
 
+#include <QCryptographicHash>
+
 ItemDelegate::ItemDelegate(QObject *pParent, bool drawRichText, bool drawGrid)
   : QItemDelegate(pParent)
 {
@@ -632,6 +634,10 @@ void LibraryTreeItem::moveChild(int from, int to)
  */
 void LibraryTreeItem::addInheritedClass(LibraryTreeItem *pLibraryTreeItem)
 {
+  // the inherited class might already be added when the icon of the class is read from the disk cache.
+  if (mInheritedClasses.contains(pLibraryTreeItem)) {
+    return;
+  }
   mInheritedClasses.append(pLibraryTreeItem);
   connect(pLibraryTreeItem, SIGNAL(loaded(LibraryTreeItem*)), this, SLOT(handleLoaded(LibraryTreeItem*)), Qt::UniqueConnection);
   connect(pLibraryTreeItem, SIGNAL(unLoaded()), this, SLOT(handleUnloaded()), Qt::UniqueConnection);
@@ -815,9 +821,14 @@ void LibraryTreeItem::handleLoaded(LibraryTreeItem *pLibraryTreeItem)
     }
     mpModelWidget->reDrawModelWidgetInheritedClasses();
     // load new icon for the class.
-    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this, false);
     // update the icon in the libraries browser view.
     pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
+  } else {
+    // the icon of the class is read from the disk cache so load it again.
+    LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+    pLibraryTreeModel->loadLibraryTreeItemPixmap(this);
+    pLibraryTreeModel->updateLibraryTreeItem(this);
   }
   emit loaded(this);
 }
@@ -832,9 +843,14 @@ void LibraryTreeItem::handleUnloaded()
     mpModelWidget->reDrawModelWidgetInheritedClasses();
     MainWindow *pMainWindow = MainWindow::instance();
     // load new icon for the class.
-    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this, false);
     // update the icon in the libraries browser view.
     pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
+  } else {
+    // the icon of the class is read from the disk cache so load it again.
+    LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+    pLibraryTreeModel->loadLibraryTreeItemPixmap(this);
+    pLibraryTreeModel->updateLibraryTreeItem(this);
   }
   emit unLoaded();
 }
@@ -897,7 +913,7 @@ void LibraryTreeItem::handleIconUpdated()
 {
   MainWindow *pMainWindow = MainWindow::instance();
   // load new icon for the class.
-  pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+  pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this, false);
   // update the icon in the libraries browser view.
   pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
   emit iconUpdated();
@@ -986,6 +1002,7 @@ LibraryTreeModel::LibraryTreeModel(LibraryWidget *pLibraryWidget)
 {
   mpLibraryWidget = pLibraryWidget;
   mpRootLibraryTreeItem = new LibraryTreeItem;
+  mPixmapCacheTrimmed = false;
 }
 
 /*!
@@ -1123,9 +1140,11 @@ Qt::ItemFlags LibraryTreeModel::flags(const QModelIndex &index) const
 
 /*!
  * \brief LibraryTreeModel::findLibraryTreeItem
- * Finds the LibraryTreeItem based on the name and case sensitivity.
+ * Finds the LibraryTreeItem based on the name and case sensitivity.\n
+ * Uses the name index so the lookup doesn't depend on the number of loaded classes.
  * \param name
- * \param pLibraryTreeItem
+ * \param pLibraryTreeItem - if given then only the items under it are considered.
+ * \param caseSensitivity
  * \return
  */
 LibraryTreeItem* LibraryTreeModel::findLibraryTreeItem(const QString &name, LibraryTreeItem *pLibraryTreeItem,
@@ -1137,9 +1156,18 @@ LibraryTreeItem* LibraryTreeModel::findLibraryTreeItem(const QString &name, Libr
   if (pLibraryTreeItem->getNameStructure().compare(name, caseSensitivity) == 0) {
     return pLibraryTreeItem;
   }
-  for (int i = pLibraryTreeItem->childrenSize(); --i >= 0; ) {
-    if (LibraryTreeItem *item = findLibraryTreeItem(name, pLibraryTreeItem->childAt(i), caseSensitivity)) {
-      return item;
+  if (caseSensitivity == Qt::CaseSensitive) {
+    LibraryTreeItem *pFoundLibraryTreeItem = mLibraryTreeItemsHash.value(name, 0);
+    if (pFoundLibraryTreeItem && isLibraryTreeItemInSubTree(pFoundLibraryTreeItem, pLibraryTreeItem)) {
+      return pFoundLibraryTreeItem;
+    }
+  } else {
+    QMultiHash<QString, LibraryTreeItem*>::const_iterator iterator = mLibraryTreeItemsCaseInsensitiveHash.constFind(name.toLower());
+    while (iterator != mLibraryTreeItemsCaseInsensitiveHash.constEnd() && iterator.key().compare(name.toLower()) == 0) {
+      if (isLibraryTreeItemInSubTree(iterator.value(), pLibraryTreeItem)) {
+        return iterator.value();
+      }
+      ++iterator;
     }
   }
   return 0;
@@ -1147,7 +1175,8 @@ LibraryTreeItem* LibraryTreeModel::findLibraryTreeItem(const QString &name, Libr
 
 /*!
  * \brief LibraryTreeModel::findLibraryTreeItem
- * Finds the LibraryTreeItem based on the Regular Expression.
+ * Finds the LibraryTreeItem based on the Regular Expression.\n
+ * Only the range of the sorted name index that starts with the name of pLibraryTreeItem is matched against the regular expression.
  * \param regExp
  * \param pLibraryTreeItem
  * \return
@@ -1160,9 +1189,12 @@ LibraryTreeItem* LibraryTreeModel::findLibraryTreeItem(const QRegExp &regExp, Li
   if (pLibraryTreeItem->getNameStructure().contains(regExp)) {
     return pLibraryTreeItem;
   }
-  for (int i = pLibraryTreeItem->childrenSize(); --i >= 0; ) {
-    if (LibraryTreeItem *item = findLibraryTreeItem(regExp, pLibraryTreeItem->childAt(i))) {
-      return item;
+  const QString prefix = pLibraryTreeItem->getNameStructure();
+  QMap<QString, LibraryTreeItem*>::const_iterator iterator = mLibraryTreeItemsMap.lowerBound(prefix);
+  for (; iterator != mLibraryTreeItemsMap.constEnd() && iterator.key().startsWith(prefix) ; ++iterator) {
+    if (iterator.value() != pLibraryTreeItem && iterator.key().contains(regExp)
+        && isLibraryTreeItemInSubTree(iterator.value(), pLibraryTreeItem)) {
+      return iterator.value();
     }
   }
   return 0;
@@ -1198,7 +1230,10 @@ LibraryTreeItem* LibraryTreeModel::findLibraryTreeItemOneLevel(const QString &na
  */
 LibraryTreeItem* LibraryTreeModel::findNonExistingLibraryTreeItem(const QString &name, Qt::CaseSensitivity caseSensitivity) const
 {
-  foreach (LibraryTreeItem *pLibraryTreeItem, mNonExistingLibraryTreeItemsList) {
+  if (caseSensitivity == Qt::CaseSensitive) {
+    return mNonExistingLibraryTreeItemsHash.value(name, 0);
+  }
+  foreach (LibraryTreeItem *pLibraryTreeItem, mNonExistingLibraryTreeItemsHash) {
     if (pLibraryTreeItem->getNameStructure().compare(name, caseSensitivity) == 0) {
       return pLibraryTreeItem;
     }
@@ -1206,6 +1241,86 @@ LibraryTreeItem* LibraryTreeModel::findNonExistingLibraryTreeItem(const QString
   return 0;
 }
 
+/*!
+ * \brief LibraryTreeModel::addNonExistingLibraryTreeItem
+ * Adds the LibraryTreeItem to the non existing classes.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::addNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem)
+{
+  mNonExistingLibraryTreeItemsHash.insert(pLibraryTreeItem->getNameStructure(), pLibraryTreeItem);
+}
+
+/*!
+ * \brief LibraryTreeModel::removeNonExistingLibraryTreeItem
+ * Removes the LibraryTreeItem from the non existing classes.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::removeNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem)
+{
+  if (mNonExistingLibraryTreeItemsHash.value(pLibraryTreeItem->getNameStructure(), 0) == pLibraryTreeItem) {
+    mNonExistingLibraryTreeItemsHash.remove(pLibraryTreeItem->getNameStructure());
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::addLibraryTreeItemToIndex
+ * Adds the LibraryTreeItem and its children to the name index used by findLibraryTreeItem.\n
+ * Must be called whenever a LibraryTreeItem is inserted in the tree or its name structure is changed.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::addLibraryTreeItemToIndex(LibraryTreeItem *pLibraryTreeItem)
+{
+  const QString nameStructure = pLibraryTreeItem->getNameStructure();
+  mLibraryTreeItemsHash.insert(nameStructure, pLibraryTreeItem);
+  mLibraryTreeItemsCaseInsensitiveHash.insert(nameStructure.toLower(), pLibraryTreeItem);
+  mLibraryTreeItemsMap.insert(nameStructure, pLibraryTreeItem);
+  for (int i = 0 ; i < pLibraryTreeItem->childrenSize() ; i++) {
+    addLibraryTreeItemToIndex(pLibraryTreeItem->childAt(i));
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::removeLibraryTreeItemFromIndex
+ * Removes the LibraryTreeItem and its children from the name index used by findLibraryTreeItem.\n
+ * Must be called whenever a LibraryTreeItem is removed from the tree or before its name structure is changed.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::removeLibraryTreeItemFromIndex(LibraryTreeItem *pLibraryTreeItem)
+{
+  const QString nameStructure = pLibraryTreeItem->getNameStructure();
+  if (mLibraryTreeItemsHash.value(nameStructure, 0) == pLibraryTreeItem) {
+    mLibraryTreeItemsHash.remove(nameStructure);
+    mLibraryTreeItemsMap.remove(nameStructure);
+  }
+  mLibraryTreeItemsCaseInsensitiveHash.remove(nameStructure.toLower(), pLibraryTreeItem);
+  for (int i = 0 ; i < pLibraryTreeItem->childrenSize() ; i++) {
+    removeLibraryTreeItemFromIndex(pLibraryTreeItem->childAt(i));
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::isLibraryTreeItemInSubTree
+ * Checks if pLibraryTreeItem is pSubTreeLibraryTreeItem or one of its descendants.
+ * \param pLibraryTreeItem
+ * \param pSubTreeLibraryTreeItem
+ * \return
+ */
+bool LibraryTreeModel::isLibraryTreeItemInSubTree(LibraryTreeItem *pLibraryTreeItem,
+                                                  const LibraryTreeItem *pSubTreeLibraryTreeItem) const
+{
+  if (pSubTreeLibraryTreeItem == mpRootLibraryTreeItem) {
+    return true;
+  }
+  while (pLibraryTreeItem) {
+    if (pLibraryTreeItem == pSubTreeLibraryTreeItem) {
+      return true;
+    }
+    pLibraryTreeItem = pLibraryTreeItem->parent();
+  }
+  return false;
+}
+
 /*!
  * \brief LibraryTreeModel::libraryTreeItemIndex
  * Finds the QModelIndex attached to LibraryTreeItem.
@@ -1354,17 +1469,19 @@ void LibraryTreeModel::createLibraryTreeItems(QFileInfo fileInfo, LibraryTreeIte
  */
 void LibraryTreeModel::checkIfAnyNonExistingClassLoaded()
 {
-  int i = 0;
-  while(i < mNonExistingLibraryTreeItemsList.size()) {
-    LibraryTreeItem *pLibraryTreeItem = mNonExistingLibraryTreeItemsList.at(i);
-    if (!pLibraryTreeItem->isNonExisting()) {
-      removeNonExistingLibraryTreeItem(pLibraryTreeItem);
-      pLibraryTreeItem->emitLoaded();
-      i = 0;  //Restart iteration
+  QList<LibraryTreeItem*> loadedLibraryTreeItems;
+  QHash<QString, LibraryTreeItem*>::iterator iterator = mNonExistingLibraryTreeItemsHash.begin();
+  while (iterator != mNonExistingLibraryTreeItemsHash.end()) {
+    if (!iterator.value()->isNonExisting()) {
+      loadedLibraryTreeItems.append(iterator.value());
+      iterator = mNonExistingLibraryTreeItemsHash.erase(iterator);
     } else {
-      i++;
+      ++iterator;
     }
   }
+  foreach (LibraryTreeItem *pLibraryTreeItem, loadedLibraryTreeItems) {
+    pLibraryTreeItem->emitLoaded();
+  }
 }
 
 /*!
@@ -1507,11 +1624,20 @@ LibraryTreeItem* LibraryTreeModel::getContainingFileParentLibraryTreeItem(Librar
 /*!
  * \brief LibraryTreeModel::loadLibraryTreeItemPixmap
  * Loads a pixmap for LibraryTreeItem
- * The pixmap is based on Modelica class icon representation
+ * The pixmap is based on Modelica class icon representation.\n
+ * If useDiskCache is true and the class is not opened then the pixmaps rendered in a previous session are reused.
  * \param pLibraryTreeItem
+ * \param useDiskCache
  */
-void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem)
+void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem, bool useDiskCache)
 {
+  QString cacheKey;
+  if (useDiskCache && !pLibraryTreeItem->getModelWidget()) {
+    cacheKey = getLibraryTreeItemPixmapCacheKey(pLibraryTreeItem);
+    if (!cacheKey.isEmpty() && readLibraryTreeItemPixmapFromCache(pLibraryTreeItem, cacheKey)) {
+      return;
+    }
+  }
   if (!pLibraryTreeItem->getModelWidget()) {
     showModelWidget(pLibraryTreeItem, false);
   }
@@ -1560,6 +1686,222 @@ void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeIt
     pLibraryTreeItem->setPixmap(QPixmap());
     pLibraryTreeItem->setDragPixmap(QPixmap());
   }
+  if (!cacheKey.isEmpty()) {
+    writeLibraryTreeItemPixmapToCache(pLibraryTreeItem, cacheKey);
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::getLibraryTreeItemPixmapCacheKey
+ * Returns the key used to store the pixmaps of the LibraryTreeItem in the disk cache.\n
+ * The key is made of the class name, the file path and modification time of the class, of its top level class and of all
+ * the inherited and connector classes drawn in its icon, the OpenModelica version and the library icon size.
+ * Returns an empty string if the pixmaps of the class can't be cached e.g., the class or one of its referenced classes is not saved.
+ * \param pLibraryTreeItem
+ * \return
+ */
+QString LibraryTreeModel::getLibraryTreeItemPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem)
+{
+  if (pLibraryTreeItem->getLibraryType() != LibraryTreeItem::Modelica || !pLibraryTreeItem->isSaved()) {
+    return "";
+  }
+  QFileInfo fileInfo(pLibraryTreeItem->getFileName());
+  if (pLibraryTreeItem->getFileName().isEmpty() || !fileInfo.isFile()) {
+    return "";
+  }
+  // the icon might inherit from the classes of the same library so also use the top level class file.
+  LibraryTreeItem *pTopLevelLibraryTreeItem = pLibraryTreeItem;
+  while (pTopLevelLibraryTreeItem->parent() && !pTopLevelLibraryTreeItem->parent()->isRootItem()) {
+    pTopLevelLibraryTreeItem = pTopLevelLibraryTreeItem->parent();
+  }
+  QFileInfo topLevelFileInfo(pTopLevelLibraryTreeItem->getFileName());
+  if (mPixmapCacheOMCVersion.isEmpty()) {
+    mPixmapCacheOMCVersion = MainWindow::instance()->getOMCProxy()->getVersion();
+  }
+  int libraryIconSize = OptionsDialog::instance()->getGeneralSettingsPage()->getLibraryIconSizeSpinBox()->value();
+  QStringList keyList;
+  keyList << pLibraryTreeItem->getNameStructure() << fileInfo.absoluteFilePath() << fileInfo.lastModified().toString(Qt::ISODate)
+          << topLevelFileInfo.absoluteFilePath() << topLevelFileInfo.lastModified().toString(Qt::ISODate)
+          << mPixmapCacheOMCVersion << QString::number(libraryIconSize);
+  QSet<LibraryTreeItem*> visitedItems;
+  visitedItems.insert(pLibraryTreeItem);
+  if (!addReferencedClassesToPixmapCacheKey(pLibraryTreeItem, &keyList, &visitedItems)) {
+    return "";
+  }
+  return QString(QCryptographicHash::hash(keyList.join("|").toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+/*!
+ * \brief LibraryTreeModel::addReferencedClassesToPixmapCacheKey
+ * Adds the name, file path and modification time of the classes drawn in the icon of the LibraryTreeItem to the disk cache key.
+ * These are the inherited classes and the classes of the connector components, found recursively.\n
+ * If the class is not opened then its inherited classes are added to it the same way as ModelWidget::getModelInheritedClasses does
+ * so that the icon read from the disk cache is updated when an inherited class is loaded, unloaded or changed.
+ * \param pLibraryTreeItem
+ * \param pKeyList
+ * \param pVisitedItems - the classes already added to the key. Avoids cyclic loops.
+ * \return false if one of the referenced classes can't be cached.
+ */
+bool LibraryTreeModel::addReferencedClassesToPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem, QStringList *pKeyList,
+                                                            QSet<LibraryTreeItem*> *pVisitedItems)
+{
+  QList<LibraryTreeItem*> referencedClasses;
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  if (pLibraryTreeItem->getModelWidget()) {
+    referencedClasses = pLibraryTreeItem->getInheritedClasses();
+    foreach (Component *pComponent, pLibraryTreeItem->getModelWidget()->getIconGraphicsView()->getComponentsList()) {
+      if (pComponent->getLibraryTreeItem()) {
+        referencedClasses.append(pComponent->getLibraryTreeItem());
+      }
+    }
+  } else {
+    foreach (QString inheritedClass, pOMCProxy->getInheritedClasses(pLibraryTreeItem->getNameStructure())) {
+      if (pOMCProxy->isBuiltinType(inheritedClass) || inheritedClass.compare(pLibraryTreeItem->getNameStructure()) == 0) {
+        continue;
+      }
+      LibraryTreeItem *pInheritedLibraryTreeItem = findLibraryTreeItem(inheritedClass);
+      if (!pInheritedLibraryTreeItem) {
+        pInheritedLibraryTreeItem = createNonExistingLibraryTreeItem(inheritedClass);
+      }
+      pLibraryTreeItem->addInheritedClass(pInheritedLibraryTreeItem);
+      referencedClasses.append(pInheritedLibraryTreeItem);
+    }
+    // only the connector components are drawn in the icon. See ModelWidget::drawModelIconComponents.
+    QList<ComponentInfo*> componentInfoList = pOMCProxy->getComponents(pLibraryTreeItem->getNameStructure());
+    foreach (ComponentInfo *pComponentInfo, componentInfoList) {
+      if (pOMCProxy->isBuiltinType(pComponentInfo->getClassName())) {
+        continue;
+      }
+      LibraryTreeItem *pComponentLibraryTreeItem = findLibraryTreeItem(pComponentInfo->getClassName());
+      if (!pComponentLibraryTreeItem) {
+        // we can't tell if a class that is not loaded is a connector so keep its name in the key.
+        *pKeyList << pComponentInfo->getClassName();
+      } else if (pComponentLibraryTreeItem->isConnector()) {
+        referencedClasses.append(pComponentLibraryTreeItem);
+      }
+    }
+    qDeleteAll(componentInfoList);
+  }
+  foreach (LibraryTreeItem *pReferencedLibraryTreeItem, referencedClasses) {
+    if (pVisitedItems->contains(pReferencedLibraryTreeItem)) {
+      continue;
+    }
+    pVisitedItems->insert(pReferencedLibraryTreeItem);
+    if (pReferencedLibraryTreeItem->isNonExisting()) {
+      *pKeyList << pReferencedLibraryTreeItem->getNameStructure();
+      continue;
+    }
+    if (pReferencedLibraryTreeItem->getLibraryType() != LibraryTreeItem::Modelica || !pReferencedLibraryTreeItem->isSaved()) {
+      return false;
+    }
+    QFileInfo fileInfo(pReferencedLibraryTreeItem->getFileName());
+    if (pReferencedLibraryTreeItem->getFileName().isEmpty() || !fileInfo.isFile()) {
+      return false;
+    }
+    *pKeyList << pReferencedLibraryTreeItem->getNameStructure() << fileInfo.absoluteFilePath()
+              << fileInfo.lastModified().toString(Qt::ISODate);
+    if (!addReferencedClassesToPixmapCacheKey(pReferencedLibraryTreeItem, pKeyList, pVisitedItems)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief LibraryTreeModel::getLibraryTreeItemPixmapCacheDirectory
+ * Returns the directory of the library icons disk cache.\n
+ * The cache is trimmed the first time it is used in a session.
+ * \return
+ */
+QString LibraryTreeModel::getLibraryTreeItemPixmapCacheDirectory()
+{
+  QString cacheDirectory = QString("%1libraryIconsCache").arg(Utilities::tempDirectory());
+  if (!QDir().exists(cacheDirectory)) {
+    QDir().mkpath(cacheDirectory);
+  }
+  if (!mPixmapCacheTrimmed) {
+    mPixmapCacheTrimmed = true;
+    trimLibraryTreeItemPixmapCache(cacheDirectory);
+  }
+  return cacheDirectory;
+}
+
+/*!
+ * \brief LibraryTreeModel::trimLibraryTreeItemPixmapCache
+ * Removes the oldest pixmaps from the disk cache so it does not grow beyond 64 MB.\n
+ * The keys of the modified classes change so their old pixmaps are never written again and are removed first.
+ * \param cacheDirectory
+ */
+void LibraryTreeModel::trimLibraryTreeItemPixmapCache(const QString &cacheDirectory)
+{
+  const qint64 maximumCacheSize = 64 * 1024 * 1024;
+  qint64 cacheSize = 0;
+  // the files are sorted by modification time, newest first.
+  QFileInfoList cacheFiles = QDir(cacheDirectory).entryInfoList(QStringList() << "*.png", QDir::Files, QDir::Time);
+  foreach (QFileInfo cacheFileInfo, cacheFiles) {
+    cacheSize += cacheFileInfo.size();
+    if (cacheSize > maximumCacheSize) {
+      QFile::remove(cacheFileInfo.absoluteFilePath());
+    }
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::readLibraryTreeItemPixmapFromCache
+ * Reads the library and drag pixmaps of the LibraryTreeItem from the disk cache.\n
+ * An empty cache file means that the class has no icon annotation.
+ * \param pLibraryTreeItem
+ * \param cacheKey
+ * \return true if the pixmaps are found in the cache.
+ */
+bool LibraryTreeModel::readLibraryTreeItemPixmapFromCache(LibraryTreeItem *pLibraryTreeItem, const QString &cacheKey)
+{
+  QString cacheDirectory = getLibraryTreeItemPixmapCacheDirectory();
+  QFileInfo libraryPixmapFileInfo(QString("%1/%2.png").arg(cacheDirectory).arg(cacheKey));
+  QFileInfo dragPixmapFileInfo(QString("%1/%2_drag.png").arg(cacheDirectory).arg(cacheKey));
+  if (!libraryPixmapFileInfo.exists() || !dragPixmapFileInfo.exists()) {
+    return false;
+  }
+  if (libraryPixmapFileInfo.size() == 0) {
+    pLibraryTreeItem->setPixmap(QPixmap());
+    pLibraryTreeItem->setDragPixmap(QPixmap());
+    return true;
+  }
+  QPixmap libraryPixmap, dragPixmap;
+  if (!libraryPixmap.load(libraryPixmapFileInfo.absoluteFilePath(), "PNG") || !dragPixmap.load(dragPixmapFileInfo.absoluteFilePath(), "PNG")) {
+    return false;
+  }
+  pLibraryTreeItem->setPixmap(libraryPixmap);
+  pLibraryTreeItem->setDragPixmap(dragPixmap);
+  return true;
+}
+
+/*!
+ * \brief LibraryTreeModel::writeLibraryTreeItemPixmapToCache
+ * Writes the library and drag pixmaps of the LibraryTreeItem to the disk cache.
+ * \param pLibraryTreeItem
+ * \param cacheKey
+ */
+void LibraryTreeModel::writeLibraryTreeItemPixmapToCache(LibraryTreeItem *pLibraryTreeItem, const QString &cacheKey)
+{
+  QString cacheDirectory = getLibraryTreeItemPixmapCacheDirectory();
+  QString libraryPixmapFileName = QString("%1/%2.png").arg(cacheDirectory).arg(cacheKey);
+  QString dragPixmapFileName = QString("%1/%2_drag.png").arg(cacheDirectory).arg(cacheKey);
+  if (pLibraryTreeItem->getPixmap().isNull()) {
+    QFile libraryPixmapFile(libraryPixmapFileName);
+    QFile dragPixmapFile(dragPixmapFileName);
+    if (libraryPixmapFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      libraryPixmapFile.close();
+    }
+    if (dragPixmapFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      dragPixmapFile.close();
+    }
+  } else {
+    /* write the drag pixmap first so a partially written entry is never considered as a valid one. */
+    if (pLibraryTreeItem->getDragPixmap().save(dragPixmapFileName, "PNG")) {
+      pLibraryTreeItem->getPixmap().save(libraryPixmapFileName, "PNG");
+    }
+  }
 }
 
 /*!
@@ -1817,6 +2159,7 @@ bool LibraryTreeModel::unloadLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem,
     // remove the LibraryTreeItem from Libraries Browser
     row = pLibraryTreeItem->row();
     beginRemoveRows(libraryTreeItemIndex(pLibraryTreeItem), row, row);
+    removeLibraryTreeItemFromIndex(pLibraryTreeItem);
     pLibraryTreeItem->parent()->removeChild(pLibraryTreeItem);
     endRemoveRows();
     if (pNextLibraryTreeItem) {
@@ -2297,6 +2640,7 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(QString name, Libra
       row = pParentLibraryTreeItem->childrenSize();
     }
     pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+    addLibraryTreeItemToIndex(pLibraryTreeItem);
     if (load) {
       // create library tree items
       createLibraryTreeItems(pLibraryTreeItem);
@@ -2328,6 +2672,7 @@ void LibraryTreeModel::createNonExistingLibraryTreeItem(LibraryTreeItem *pLibrar
   QModelIndex index = libraryTreeItemIndex(pParentLibraryTreeItem);
   beginInsertRows(index, row, row);
   pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+  addLibraryTreeItemToIndex(pLibraryTreeItem);
   endInsertRows();
   pLibraryTreeItem->setNonExisting(false);
 }
@@ -2375,6 +2720,7 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(LibraryTreeItem::Li
     row = pParentLibraryTreeItem->childrenSize();
   }
   pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+  addLibraryTreeItemToIndex(pLibraryTreeItem);
   return pLibraryTreeItem;
 }
 
@@ -2407,6 +2753,7 @@ void LibraryTreeModel::unloadClassHelper(LibraryTreeItem *pLibraryTreeItem, Libr
   // notify the inherits classes
   pLibraryTreeItem->emitUnLoaded();
   addNonExistingLibraryTreeItem(pLibraryTreeItem);
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
 }
 
@@ -2442,6 +2789,7 @@ void LibraryTreeModel::unloadFileHelper(LibraryTreeItem *pLibraryTreeItem, Libra
     }
     pLibraryTreeItem->getModelWidget()->deleteLater();
   }
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
   pLibraryTreeItem->deleteLater();
 }
@@ -2478,6 +2826,7 @@ void LibraryTreeModel::deleteFileHelper(LibraryTreeItem *pLibraryTreeItem, Libra
     }
     pLibraryTreeItem->getModelWidget()->deleteLater();
   }
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
   QFileInfo fileInfo(pLibraryTreeItem->getFileName());
   // delete the file/folder
@@ -3495,28 +3844,56 @@ void LibraryWidget::openModelicaFile(QString fileName, QString encoding, bool sh
       pMessageBox->setStandardButtons(QMessageBox::Ok);
       pMessageBox->exec();
     } else { // if no conflicting model found then just load the file simply
-      // load the file in OMC
-      if (MainWindow::instance()->getOMCProxy()->loadFile(fileName, encoding)) {
-        // create library tree nodes for loaded models
-        int progressvalue = 0;
-        if (showProgress) {
-          MainWindow::instance()->getProgressBar()->setRange(0, classesList.size());
-          MainWindow::instance()->showProgressBar();
-        }
-        foreach (QString model, classesList) {
-          mpLibraryTreeModel->createLibraryTreeItem(model, mpLibraryTreeModel->getRootLibraryTreeItem(), true, false, true);
-          mpLibraryTreeModel->checkIfAnyNonExistingClassLoaded();
-          if (showProgress) {
-            MainWindow::instance()->getProgressBar()->setValue(++progressvalue);
-          }
-        }
-        MainWindow::instance()->addRecentFile(fileName, encoding);
-        mpLibraryTreeModel->loadDependentLibraries(MainWindow::instance()->getOMCProxy()->getClassNames());
-        if (showProgress) {
-          MainWindow::instance()->hideProgressBar();
-        }
+      // load the file in OMC. Loading a library can take long so don't wait for it.
+      OMCCommand *pOMCCommand = MainWindow::instance()->getOMCProxy()->loadFileAsync(fileName, encoding);
+      if (pOMCCommand) {
+        pOMCCommand->setProperty("fileName", fileName);
+        pOMCCommand->setProperty("encoding", encoding);
+        pOMCCommand->setProperty("showProgress", showProgress);
+        pOMCCommand->setProperty("classesList", classesList);
+        connect(pOMCCommand, SIGNAL(finished(QString)), SLOT(loadModelicaFileFinished(QString)));
+        return;
+      }
+    }
+  }
+  if (showProgress) {
+    MainWindow::instance()->getStatusBar()->clearMessage();
+  }
+}
+
+/*!
+ * \brief LibraryWidget::loadModelicaFileFinished
+ * Slot activated when the loadFile command sent by LibraryWidget::openModelicaFile is finished.\n
+ * Creates the LibraryTreeItems for the loaded classes.
+ * \param result
+ */
+void LibraryWidget::loadModelicaFileFinished(QString result)
+{
+  QString fileName = sender()->property("fileName").toString();
+  QString encoding = sender()->property("encoding").toString();
+  bool showProgress = sender()->property("showProgress").toBool();
+  QStringList classesList = sender()->property("classesList").toStringList();
+  bool loaded = StringHandler::unparseBool(result);
+  MainWindow::instance()->getOMCProxy()->printMessagesStringInternal();
+  if (loaded) {
+    // create library tree nodes for loaded models
+    int progressvalue = 0;
+    if (showProgress) {
+      MainWindow::instance()->getProgressBar()->setRange(0, classesList.size());
+      MainWindow::instance()->showProgressBar();
+    }
+    foreach (QString model, classesList) {
+      mpLibraryTreeModel->createLibraryTreeItem(model, mpLibraryTreeModel->getRootLibraryTreeItem(), true, false, true);
+      mpLibraryTreeModel->checkIfAnyNonExistingClassLoaded();
+      if (showProgress) {
+        MainWindow::instance()->getProgressBar()->setValue(++progressvalue);
       }
     }
+    MainWindow::instance()->addRecentFile(fileName, encoding);
+    mpLibraryTreeModel->loadDependentLibraries(MainWindow::instance()->getOMCProxy()->getClassNames());
+    if (showProgress) {
+      MainWindow::instance()->hideProgressBar();
+    }
   }
   if (showProgress) {
     MainWindow::instance()->getStatusBar()->clearMessage();
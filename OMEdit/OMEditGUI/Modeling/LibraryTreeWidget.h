@@ -152,6 +152,7 @@ public:
   void emitLoaded();
   void emitUnLoaded();
   void emitShapeAdded(ShapeAnnotation *pShapeAnnotation, GraphicsView *pGraphicsView);
+  void emitShapeUpdated() {emit shapeUpdatedForComponent();}
   void emitComponentAdded(Component *pComponent);
   void emitConnectionAdded(LineAnnotation *pConnectionLineAnnotation) {emit connectionAdded(pConnectionLineAnnotation);}
   void emitCoOrdinateSystemUpdated(GraphicsView *pGraphicsView) {emit coOrdinateSystemUpdated(pGraphicsView);}
@@ -186,6 +187,7 @@ signals:
   void unLoadedForComponent();
   void shapeAdded(ShapeAnnotation *pShapeAnnotation, GraphicsView *pGraphicsView);
   void shapeAddedForComponent();
+  void shapeUpdatedForComponent();
   void componentAdded(Component *pComponent);
   void componentAddedForComponent();
   void connectionAdded(LineAnnotation *pConnectionLineAnnotation);
@@ -242,14 +244,16 @@ public:
   LibraryTreeItem* createLibraryTreeItem(LibraryTreeItem::LibraryType type, QString name, QString nameStructure, QString path, bool isSaved,
                                          LibraryTreeItem *pParentLibraryTreeItem, int row = -1);
   void checkIfAnyNonExistingClassLoaded();
-  void addNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem) {mNonExistingLibraryTreeItemsList.append(pLibraryTreeItem);}
-  void removeNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem) {mNonExistingLibraryTreeItemsList.removeOne(pLibraryTreeItem);}
+  void addNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem);
+  void removeNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem);
+  void addLibraryTreeItemToIndex(LibraryTreeItem *pLibraryTreeItem);
+  void removeLibraryTreeItemFromIndex(LibraryTreeItem *pLibraryTreeItem);
   void updateLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem);
   void updateLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem);
   void updateLibraryTreeItemClassTextManually(LibraryTreeItem *pLibraryTreeItem, QString contents);
   void readLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem);
   LibraryTreeItem* getContainingFileParentLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem);
-  void loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem);
+  void loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem, bool useDiskCache = true);
   void loadDependentLibraries(QStringList libraries);
   LibraryTreeItem* getLibraryTreeItemFromFile(QString fileName, int lineNumber);
   void showModelWidget(LibraryTreeItem *pLibraryTreeItem, bool show = true);
@@ -268,7 +272,13 @@ public:
 private:
   LibraryWidget *mpLibraryWidget;
   LibraryTreeItem *mpRootLibraryTreeItem;
-  QList<LibraryTreeItem*> mNonExistingLibraryTreeItemsList;
+  QHash<QString, LibraryTreeItem*> mNonExistingLibraryTreeItemsHash;
+  QHash<QString, LibraryTreeItem*> mLibraryTreeItemsHash;
+  QMultiHash<QString, LibraryTreeItem*> mLibraryTreeItemsCaseInsensitiveHash;
+  QMap<QString, LibraryTreeItem*> mLibraryTreeItemsMap;
+  QString mPixmapCacheOMCVersion;
+  bool mPixmapCacheTrimmed;
+  bool isLibraryTreeItemInSubTree(LibraryTreeItem *pLibraryTreeItem, const LibraryTreeItem *pSubTreeLibraryTreeItem) const;
   QModelIndex libraryTreeItemIndexHelper(const LibraryTreeItem *pLibraryTreeItem, const LibraryTreeItem *pParentLibraryTreeItem,
                                          const QModelIndex &parentIndex) const;
   LibraryTreeItem* getLibraryTreeItemFromFileHelper(LibraryTreeItem *pLibraryTreeItem, QString fileName, int lineNumber);
@@ -289,6 +299,12 @@ private:
   void unloadFileChildren(LibraryTreeItem *pLibraryTreeItem);
   void deleteFileHelper(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pParentLibraryTreeItem);
   void deleteFileChildren(LibraryTreeItem *pLibraryTreeItem);
+  QString getLibraryTreeItemPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem);
+  bool addReferencedClassesToPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem, QStringList *pKeyList, QSet<LibraryTreeItem*> *pVisitedItems);
+  QString getLibraryTreeItemPixmapCacheDirectory();
+  void trimLibraryTreeItemPixmapCache(const QString &cacheDirectory);
+  bool readLibraryTreeItemPixmapFromCache(LibraryTreeItem *pLibraryTreeItem, const QString &cacheKey);
+  void writeLibraryTreeItemPixmapToCache(LibraryTreeItem *pLibraryTreeItem, const QString &cacheKey);
 protected:
   Qt::DropActions supportedDropActions() const;
 };
@@ -418,6 +434,8 @@ private:
   bool saveTotalLibraryTreeItemHelper(LibraryTreeItem *pLibraryTreeItem);
 public slots:
   void searchClasses();
+private slots:
+  void loadModelicaFileFinished(QString result);
 };
 
 #endif // LIBRARYTREEWIDGET_H
@@ -40,6 +40,12 @@
 
 #include <QMenu>
 #include <QMessageBox>
+#include <QClipboard>
+#include <QTextDocumentFragment>
+#include <QFontMetrics>
+#include <QStyle>
+
+#include <algorithm>
 
 /*!
  * \class MessageItem
@@ -84,6 +90,274 @@ QString MessageItem::getLocation()
       .arg(QString::number(mColumnEnd));
 }
 
+/*!
+ * \class MessageEntry
+ * \brief Compact form of a message that is kept in the MessagesModel.
+ * The message is stored as plain text. The class name is set when the message refers to a loaded class.
+ */
+/*!
+ * \brief MessageEntry::getHeading
+ * Returns the heading of the message i.e., the number, time, kind and type.
+ * \return
+ */
+QString MessageEntry::getHeading() const
+{
+  return QString("[%1] %2 %3 %4")
+      .arg(QString::number(mNumber))
+      .arg(mTime)
+      .arg(StringHandler::getErrorKindString(mErrorKind))
+      .arg(StringHandler::getErrorTypeDisplayString(mErrorType));
+}
+
+/*!
+ * \brief MessageEntry::getText
+ * Returns the heading and the complete message.
+ * \return
+ */
+QString MessageEntry::getText() const
+{
+  return QString("%1\n%2").arg(getHeading()).arg(mMessage);
+}
+
+/*!
+ * \class MessagesModel
+ * \brief A list model for the messages.
+ * The messages are kept in a ring buffer. When the maximum number of messages is reached the oldest message is overwritten.
+ * The view only asks for the data of the visible rows.
+ * The size of the word wrapped message is computed once and cached in the MessageEntry until the font or the width of the view changes.
+ */
+/*!
+ * \brief MessagesModel::MessagesModel
+ * \param pParent
+ */
+MessagesModel::MessagesModel(QObject *pParent)
+  : QAbstractListModel(pParent)
+{
+  mFirstMessageEntry = 0;
+  mMessageEntriesCount = 0;
+  mMaximumMessages = 0;
+  mWidth = 0;
+  mTextMargin = 0;
+}
+
+/*!
+ * \brief MessagesModel::rowCount
+ * Returns the number of messages.
+ * \param parent
+ * \return
+ */
+int MessagesModel::rowCount(const QModelIndex &parent) const
+{
+  if (parent.isValid()) {
+    return 0;
+  }
+  return mMessageEntriesCount;
+}
+
+/*!
+ * \brief MessagesModel::data
+ * Returns the data stored under the given role for the message referred to by the index.
+ * \param index
+ * \param role
+ * \return
+ */
+QVariant MessagesModel::data(const QModelIndex &index, int role) const
+{
+  if (!index.isValid() || index.row() < 0 || index.row() >= mMessageEntriesCount) {
+    return QVariant();
+  }
+  const MessageEntry &messageEntry = getMessageEntry(index.row());
+  switch (role) {
+    case Qt::DisplayRole:
+      return messageEntry.getText();
+    case Qt::SizeHintRole:
+      if (mWidth <= 0) {
+        return QVariant();
+      }
+      if (!messageEntry.mSizeHint.isValid()) {
+        QFontMetrics fontMetrics(mFont);
+        QRect textRect = fontMetrics.boundingRect(QRect(0, 0, qMax(mWidth - 2 * mTextMargin, 1), 0), Qt::TextWordWrap, messageEntry.getText());
+        messageEntry.mSizeHint = QSize(mWidth, textRect.height() + 2 * mTextMargin);
+      }
+      return messageEntry.mSizeHint;
+    case Qt::ToolTipRole:
+      if (messageEntry.mClassName.isEmpty()) {
+        return messageEntry.getText();
+      } else {
+        return QString("%1\n\n%2").arg(messageEntry.getText())
+            .arg(tr("Double click to open %1 at line %2.").arg(messageEntry.mClassName).arg(messageEntry.mLineNumber));
+      }
+    case Qt::ForegroundRole:
+      switch (messageEntry.mErrorType) {
+        case StringHandler::Warning:
+          return mWarningColor;
+        case StringHandler::OMError:
+          return mErrorColor;
+        case StringHandler::Notification:
+        default:
+          return mNotificationColor;
+      }
+    default:
+      return QVariant();
+  }
+}
+
+/*!
+ * \brief MessagesModel::setMaximumMessages
+ * Sets the maximum number of messages. 0 means unlimited.
+ * If there are more messages then the oldest messages are removed.
+ * \param maximumMessages
+ */
+void MessagesModel::setMaximumMessages(int maximumMessages)
+{
+  if (mMaximumMessages == maximumMessages) {
+    return;
+  }
+  linearizeMessageEntries();
+  if (maximumMessages > 0 && mMessageEntriesCount > maximumMessages) {
+    int removeCount = mMessageEntriesCount - maximumMessages;
+    beginRemoveRows(QModelIndex(), 0, removeCount - 1);
+    mMessageEntries.remove(0, removeCount);
+    mMessageEntriesCount = mMessageEntries.size();
+    endRemoveRows();
+  }
+  mMaximumMessages = maximumMessages;
+}
+
+/*!
+ * \brief MessagesModel::setColors
+ * Sets the colors used for notifications, warnings and errors.
+ * \param notificationColor
+ * \param warningColor
+ * \param errorColor
+ */
+void MessagesModel::setColors(const QColor &notificationColor, const QColor &warningColor, const QColor &errorColor)
+{
+  mNotificationColor = notificationColor;
+  mWarningColor = warningColor;
+  mErrorColor = errorColor;
+  if (mMessageEntriesCount > 0) {
+    emit dataChanged(index(0), index(mMessageEntriesCount - 1));
+  }
+}
+
+/*!
+ * \brief MessagesModel::setTextLayout
+ * Sets the font and the width used to word wrap the messages.
+ * The cached sizes are recomputed only if the font or the width is changed.
+ * \param font
+ * \param width
+ * \param textMargin - the margin the delegate leaves around the text.
+ */
+void MessagesModel::setTextLayout(const QFont &font, int width, int textMargin)
+{
+  if (mFont == font && mWidth == width && mTextMargin == textMargin) {
+    return;
+  }
+  mFont = font;
+  mWidth = width;
+  mTextMargin = textMargin;
+  for (int i = 0 ; i < mMessageEntries.size() ; i++) {
+    mMessageEntries[i].mSizeHint = QSize();
+  }
+}
+
+/*!
+ * \brief MessagesModel::addMessageEntry
+ * Adds the message at the end. If the buffer is full then the oldest message is replaced.
+ * \param messageEntry
+ */
+void MessagesModel::addMessageEntry(const MessageEntry &messageEntry)
+{
+  if (mMaximumMessages > 0 && mMessageEntriesCount >= mMaximumMessages) {
+    beginRemoveRows(QModelIndex(), 0, 0);
+    mFirstMessageEntry = (mFirstMessageEntry + 1) % mMessageEntries.size();
+    mMessageEntriesCount--;
+    endRemoveRows();
+    beginInsertRows(QModelIndex(), mMessageEntriesCount, mMessageEntriesCount);
+    mMessageEntries[(mFirstMessageEntry + mMessageEntriesCount) % mMessageEntries.size()] = messageEntry;
+    mMessageEntriesCount++;
+    endInsertRows();
+  } else {
+    // the buffer is only rotated once it is full so appending keeps the order.
+    linearizeMessageEntries();
+    beginInsertRows(QModelIndex(), mMessageEntriesCount, mMessageEntriesCount);
+    mMessageEntries.append(messageEntry);
+    mMessageEntriesCount++;
+    endInsertRows();
+  }
+}
+
+/*!
+ * \brief MessagesModel::clearMessageEntries
+ * Removes all the messages.
+ */
+void MessagesModel::clearMessageEntries()
+{
+  beginResetModel();
+  mMessageEntries.clear();
+  mFirstMessageEntry = 0;
+  mMessageEntriesCount = 0;
+  endResetModel();
+}
+
+/*!
+ * \brief MessagesModel::linearizeMessageEntries
+ * Rotates the ring buffer so that the oldest message is at the start.
+ */
+void MessagesModel::linearizeMessageEntries()
+{
+  if (mFirstMessageEntry != 0) {
+    std::rotate(mMessageEntries.begin(), mMessageEntries.begin() + mFirstMessageEntry, mMessageEntries.end());
+    mFirstMessageEntry = 0;
+  }
+}
+
+/*!
+ * \class MessagesProxyModel
+ * \brief Filters the messages by type and by the filter regular expression.
+ */
+/*!
+ * \brief MessagesProxyModel::MessagesProxyModel
+ * \param pParent
+ */
+MessagesProxyModel::MessagesProxyModel(QObject *pParent)
+  : QSortFilterProxyModel(pParent)
+{
+  mErrorTypeFilter = StringHandler::NoOMError;
+}
+
+/*!
+ * \brief MessagesProxyModel::setErrorTypeFilter
+ * Shows only the messages of errorType. StringHandler::NoOMError shows all messages.
+ * \param errorType
+ */
+void MessagesProxyModel::setErrorTypeFilter(StringHandler::OpenModelicaErrors errorType)
+{
+  mErrorTypeFilter = errorType;
+  invalidateFilter();
+}
+
+/*!
+ * \brief MessagesProxyModel::filterAcceptsRow
+ * Filters the messages based on the message type and the filter regular expression.
+ * \param sourceRow
+ * \param sourceParent
+ * \return
+ */
+bool MessagesProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+  Q_UNUSED(sourceParent);
+  const MessageEntry &messageEntry = static_cast<MessagesModel*>(sourceModel())->getMessageEntry(sourceRow);
+  if (mErrorTypeFilter != StringHandler::NoOMError && messageEntry.mErrorType != mErrorTypeFilter) {
+    return false;
+  }
+  if (filterRegExp().isEmpty()) {
+    return true;
+  }
+  return messageEntry.mMessage.contains(filterRegExp()) || messageEntry.getHeading().contains(filterRegExp());
+}
+
 /*!
  * \class MessagesWidget
  * \brief Shows warnings, notifications and error messages.
@@ -117,39 +391,70 @@ MessagesWidget::MessagesWidget(QWidget *pParent)
   : QWidget(pParent)
 {
   mMessageNumber = 1;
-  mpMessagesTextBrowser = new QTextBrowser;
-  mpMessagesTextBrowser->setOpenLinks(false);
-  mpMessagesTextBrowser->setOpenExternalLinks(false);
+  // messages model and filter
+  mpMessagesModel = new MessagesModel(this);
+  mpMessagesProxyModel = new MessagesProxyModel(this);
+  mpMessagesProxyModel->setDynamicSortFilter(true);
+  mpMessagesProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
+  mpMessagesProxyModel->setSourceModel(mpMessagesModel);
+  mpFilterTextBox = new QLineEdit;
+  mpFilterTextBox->setPlaceholderText(tr("Filter Messages"));
+  connect(mpFilterTextBox, SIGNAL(returnPressed()), SLOT(filterMessages()));
+  connect(mpFilterTextBox, SIGNAL(textChanged(QString)), SLOT(filterMessages()));
+  mpErrorTypeFilterComboBox = new QComboBox;
+  mpErrorTypeFilterComboBox->addItem(tr("All"), StringHandler::NoOMError);
+  mpErrorTypeFilterComboBox->addItem(StringHandler::getErrorTypeDisplayString(StringHandler::Notification), StringHandler::Notification);
+  mpErrorTypeFilterComboBox->addItem(StringHandler::getErrorTypeDisplayString(StringHandler::Warning), StringHandler::Warning);
+  mpErrorTypeFilterComboBox->addItem(StringHandler::getErrorTypeDisplayString(StringHandler::OMError), StringHandler::OMError);
+  connect(mpErrorTypeFilterComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterMessages()));
+  /* messages view. The messages are word wrapped so the rows have different heights.
+   * The height of each row is cached in the model so a relayout does not measure the messages again.
+   */
+  mpMessagesListView = new QListView;
+  mpMessagesListView->setModel(mpMessagesProxyModel);
+  mpMessagesListView->setUniformItemSizes(false);
+  mpMessagesListView->setWordWrap(true);
+  mpMessagesListView->setResizeMode(QListView::Adjust);
+  mpMessagesListView->setLayoutMode(QListView::Batched);
+  mpMessagesListView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+  mpMessagesListView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  mpMessagesListView->viewport()->installEventFilter(this);
   // since the QFrame::StyledPanel is not a grey rectangle around it so we need to put it in a QFrame.
-  mpMessagesTextBrowser->setFrameStyle(QFrame::NoFrame);
-  QFrame *pMessagesTextBrowserFrame = new QFrame;
-  pMessagesTextBrowserFrame->setFrameStyle(QFrame::StyledPanel);
-  mpMessagesTextBrowser->setContextMenuPolicy(Qt::CustomContextMenu);
-  connect(mpMessagesTextBrowser, SIGNAL(anchorClicked(QUrl)), SLOT(openErrorMessageClass(QUrl)));
-  connect(mpMessagesTextBrowser, SIGNAL(customContextMenuRequested(QPoint)), SLOT(showContextMenu(QPoint)));
+  mpMessagesListView->setFrameStyle(QFrame::NoFrame);
+  QFrame *pMessagesListViewFrame = new QFrame;
+  pMessagesListViewFrame->setFrameStyle(QFrame::StyledPanel);
+  mpMessagesListView->setContextMenuPolicy(Qt::CustomContextMenu);
+  connect(mpMessagesListView, SIGNAL(doubleClicked(QModelIndex)), SLOT(openErrorMessageClass(QModelIndex)));
+  connect(mpMessagesListView, SIGNAL(customContextMenuRequested(QPoint)), SLOT(showContextMenu(QPoint)));
+  // scroll to the most recent message once per event loop iteration instead of once per message.
+  mScrollToBottomTimer.setSingleShot(true);
+  mScrollToBottomTimer.setInterval(0);
+  connect(&mScrollToBottomTimer, SIGNAL(timeout()), mpMessagesListView, SLOT(scrollToBottom()));
   applyMessagesSettings();
   // create actions
   mpSelectAllAction = new QAction(tr("Select All"), this);
   mpSelectAllAction->setShortcut(QKeySequence("Ctrl+a"));
   mpSelectAllAction->setStatusTip(tr("Selects all the Messages"));
-  connect(mpSelectAllAction, SIGNAL(triggered()), mpMessagesTextBrowser, SLOT(selectAll()));
+  connect(mpSelectAllAction, SIGNAL(triggered()), mpMessagesListView, SLOT(selectAll()));
   mpCopyAction = new QAction(QIcon(":/Resources/icons/copy.svg"), Helper::copy, this);
   mpCopyAction->setShortcut(QKeySequence("Ctrl+c"));
   mpCopyAction->setStatusTip(tr("Copy the Message"));
-  connect(mpCopyAction, SIGNAL(triggered()), mpMessagesTextBrowser, SLOT(copy()));
+  connect(mpCopyAction, SIGNAL(triggered()), SLOT(copyMessages()));
   mpClearAllAction = new QAction(tr("Clear All"), this);
   mpClearAllAction->setStatusTip(tr("clears the Messages Browser"));
   connect(mpClearAllAction, SIGNAL(triggered()), SLOT(clearMessages()));
-  // set layout for MessagesTextBrowser frame
-  QVBoxLayout *pMessagesTextBrowserLayout = new QVBoxLayout;
-  pMessagesTextBrowserLayout->setContentsMargins(0, 0, 0, 0);
-  pMessagesTextBrowserLayout->addWidget(mpMessagesTextBrowser);
-  pMessagesTextBrowserFrame->setLayout(pMessagesTextBrowserLayout);
+  // set layout for MessagesListView frame
+  QGridLayout *pMessagesListViewLayout = new QGridLayout;
+  pMessagesListViewLayout->setContentsMargins(0, 0, 0, 0);
+  pMessagesListViewLayout->addWidget(mpFilterTextBox, 0, 0);
+  pMessagesListViewLayout->addWidget(mpErrorTypeFilterComboBox, 0, 1);
+  pMessagesListViewLayout->addWidget(mpMessagesListView, 1, 0, 1, 2);
+  pMessagesListViewFrame->setLayout(pMessagesListViewLayout);
   // Main Layout
   QHBoxLayout *pMainLayout = new QHBoxLayout;
   pMainLayout->setContentsMargins(0, 0, 0, 0);
   pMainLayout->setSpacing(1);
-  pMainLayout->addWidget(pMessagesTextBrowserFrame);
+  pMainLayout->addWidget(pMessagesListViewFrame);
   setLayout(pMainLayout);
 }
 
@@ -160,25 +465,43 @@ void MessagesWidget::applyMessagesSettings()
 {
   MessagesPage *pMessagesPage = OptionsDialog::instance()->getMessagesPage();
   // set the output size
-  mpMessagesTextBrowser->document()->setMaximumBlockCount(pMessagesPage->getOutputSizeSpinBox()->value());
+  mpMessagesModel->setMaximumMessages(pMessagesPage->getOutputSizeSpinBox()->value());
   // set the font
   QString fontFamily = pMessagesPage->getFontFamilyComboBox()->currentFont().family();
   double fontSize = pMessagesPage->getFontSizeSpinBox()->value();
   QFont font(fontFamily);
   font.setPointSizeF(fontSize);
-  mpMessagesTextBrowser->setFont(font);
-  // set the messages color by setting the style sheet
-  QString messagesCSS = QString(".notification {color: %1}"
-                                ".warning {color: %2}"
-                                ".error {color: %3}")
-      .arg(OptionsDialog::instance()->getMessagesPage()->getNotificationColor().name())
-      .arg(OptionsDialog::instance()->getMessagesPage()->getWarningColor().name())
-      .arg(OptionsDialog::instance()->getMessagesPage()->getErrorColor().name());
-  mpMessagesTextBrowser->document()->setDefaultStyleSheet(messagesCSS);
-  // move the cursor to end.
-  QTextCursor textCursor = mpMessagesTextBrowser->textCursor();
-  textCursor.movePosition(QTextCursor::End);
-  mpMessagesTextBrowser->setTextCursor(textCursor);
+  mpMessagesListView->setFont(font);
+  updateTextLayout();
+  // set the messages color
+  mpMessagesModel->setColors(pMessagesPage->getNotificationColor(), pMessagesPage->getWarningColor(), pMessagesPage->getErrorColor());
+  // move to the most recent message.
+  mScrollToBottomTimer.start();
+}
+
+/*!
+ * \brief MessagesWidget::updateTextLayout
+ * Passes the font and the width of the view to the model so that it can compute the size of the word wrapped messages.
+ */
+void MessagesWidget::updateTextLayout()
+{
+  int textMargin = mpMessagesListView->style()->pixelMetric(QStyle::PM_FocusFrameHMargin, 0, mpMessagesListView) + 1;
+  mpMessagesModel->setTextLayout(mpMessagesListView->font(), mpMessagesListView->viewport()->width(), textMargin);
+}
+
+/*!
+ * \brief MessagesWidget::eventFilter
+ * Updates the size of the messages when the view is resized.
+ * \param pObject
+ * \param pEvent
+ * \return
+ */
+bool MessagesWidget::eventFilter(QObject *pObject, QEvent *pEvent)
+{
+  if (pObject == mpMessagesListView->viewport() && pEvent->type() == QEvent::Resize) {
+    updateTextLayout();
+  }
+  return QWidget::eventFilter(pObject, pEvent);
 }
 
 /*!
@@ -187,105 +510,68 @@ void MessagesWidget::applyMessagesSettings()
   */
 void MessagesWidget::addGUIMessage(MessageItem messageItem)
 {
-  // move the cursor down before adding message.
-  QTextCursor textCursor = mpMessagesTextBrowser->textCursor();
-  textCursor.movePosition(QTextCursor::End);
-  mpMessagesTextBrowser->setTextCursor(textCursor);
-  // set the CSS class depending on message type
-  QString messageCSSClass;
-  switch (messageItem.getErrorType()) {
-    case StringHandler::Warning:
-      messageCSSClass = "warning";
-      break;
-    case StringHandler::OMError:
-      messageCSSClass = "error";
-      break;
-    case StringHandler::Notification:
-    default:
-      messageCSSClass = "notification";
-      break;
-  }
-  QString linkFormat = QString("[%1: %2]: <a href=\"omeditmessagesbrowser:///%3?lineNumber=%4\">%5</a>");
-  QString errorMessage;
+  MessageEntry messageEntry;
+  messageEntry.mNumber = mMessageNumber;
+  messageEntry.mTime = messageItem.getTime();
+  messageEntry.mErrorKind = messageItem.getErrorKind();
+  messageEntry.mErrorType = messageItem.getErrorType();
+  messageEntry.mLineNumber = messageItem.getLineStart().toInt();
   QString message;
   if(messageItem.getMessageItemType()== MessageItem::Modelica) {
-    // if message already have tags then just use it.
+    // if message have tags then only keep the text.
     if (Qt::mightBeRichText(messageItem.getMessage())) {
-      message = messageItem.getMessage();
+      message = QTextDocumentFragment::fromHtml(messageItem.getMessage()).toPlainText();
     } else {
-      message = Qt::convertFromPlainText(messageItem.getMessage()).remove("<p>").remove("</p>");
+      message = messageItem.getMessage();
     }
   } else if(messageItem.getMessageItemType()== MessageItem::CompositeModel) {
     message = messageItem.getMessage().remove("<p>").remove("</p>");
   }
+  QString locationFormat = QString("[%1: %2]: %3");
   if (messageItem.getFileName().isEmpty()) { // if custom error message
-    errorMessage = message;
+    messageEntry.mMessage = message;
   } else if (messageItem.getMessageItemType()== MessageItem::CompositeModel ||
              MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->findLibraryTreeItem(messageItem.getFileName())) {
-    // If the class is only loaded in AST via loadString then create link for the error message.
-    errorMessage = linkFormat.arg(messageItem.getFileName())
-        .arg(messageItem.getLocation())
-        .arg(messageItem.getFileName())
-        .arg(messageItem.getLineStart())
-        .arg(message);
+    // If the class is only loaded in AST via loadString then link the error message with the class.
+    messageEntry.mClassName = messageItem.getFileName();
+    messageEntry.mMessage = locationFormat.arg(messageItem.getFileName()).arg(messageItem.getLocation()).arg(message);
   } else {
     // Find the class name using the file name and line number.
     LibraryTreeItem *pLibraryTreeItem;
     pLibraryTreeItem = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->getLibraryTreeItemFromFile(messageItem.getFileName(),
-                                                                                                                     messageItem.getLineStart().toInt());
+                                                                                                                     messageEntry.mLineNumber);
     if (pLibraryTreeItem) {
-      errorMessage = linkFormat.arg(pLibraryTreeItem->getNameStructure())
-          .arg(messageItem.getLocation())
-          .arg(pLibraryTreeItem->getNameStructure())
-          .arg(messageItem.getLineStart())
-          .arg(message);
+      messageEntry.mClassName = pLibraryTreeItem->getNameStructure();
+      messageEntry.mMessage = locationFormat.arg(pLibraryTreeItem->getNameStructure()).arg(messageItem.getLocation()).arg(message);
     } else {
       // otherwise display filename to user where error occurred.
-      errorMessage = QString("[%1: %2]: %3")
-          .arg(messageItem.getFileName())
-          .arg(messageItem.getLocation())
-          .arg(message);
+      messageEntry.mMessage = locationFormat.arg(messageItem.getFileName()).arg(messageItem.getLocation()).arg(message);
     }
   }
-  QString errorString = QString("<div class=\"%1\">"
-                                "<b>[%2] %3 %4 %5</b><br>"
-                                "%6"
-                                "</div><br>")
-      .arg(messageCSSClass)
-      .arg(QString::number(mMessageNumber))
-      .arg(QTime::currentTime().toString())
-      .arg(StringHandler::getErrorKindString(messageItem.getErrorKind()))
-      .arg(StringHandler::getErrorTypeDisplayString(messageItem.getErrorType()))
-      .arg(errorMessage);
-  mpMessagesTextBrowser->insertHtml(errorString);
+  mpMessagesModel->addMessageEntry(messageEntry);
   mMessageNumber++;
-  // move the cursor down after adding message.
-  textCursor.movePosition(QTextCursor::End);
-  mpMessagesTextBrowser->setTextCursor(textCursor);
+  // move to the most recent message.
+  mScrollToBottomTimer.start();
   emit MessageAdded();
 }
 
 /*!
  * \brief MessagesWidget::openErrorMessageClass
- * Slot activated when a link e.g., "<a href="omeditmessagesbrowser:///className?lineNumber=4></a>" is clicked from MessagesWidget.\n
- * Parses the url and loads the Modelica class with the line selected.
- * \param url - the url that is clicked
+ * Slot activated when a message is double clicked in MessagesWidget.\n
+ * Loads the Modelica class of the message with the line selected.
+ * \param index - the index of the message that is double clicked
  */
-void MessagesWidget::openErrorMessageClass(QUrl url)
+void MessagesWidget::openErrorMessageClass(const QModelIndex &index)
 {
-  if (url.scheme() != "omeditmessagesbrowser") {
-    /*! @todo Write error-message?! */
+  QModelIndex sourceIndex = mpMessagesProxyModel->mapToSource(index);
+  if (!sourceIndex.isValid()) {
     return;
   }
-  QString className = url.path();
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
-  QUrlQuery query(url);
-  int lineNumber = query.queryItemValue("lineNumber").toInt();
-#else /* Qt4 */
-  int lineNumber = url.queryItemValue("lineNumber").toInt();
-#endif
-  if (className.startsWith("/")) {
-    className.remove(0, 1);
+  const MessageEntry &messageEntry = mpMessagesModel->getMessageEntry(sourceIndex.row());
+  QString className = messageEntry.mClassName;
+  int lineNumber = messageEntry.mLineNumber;
+  if (className.isEmpty()) {
+    return;
   }
   // find the class that has the error
   LibraryTreeItem *pLibraryTreeItem = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->findLibraryTreeItem(className);
@@ -320,7 +606,40 @@ void MessagesWidget::showContextMenu(QPoint point)
   menu.addAction(mpSelectAllAction);
   menu.addAction(mpCopyAction);
   menu.addAction(mpClearAllAction);
-  menu.exec(mpMessagesTextBrowser->viewport()->mapToGlobal(point));
+  menu.exec(mpMessagesListView->viewport()->mapToGlobal(point));
+}
+
+/*!
+ * \brief MessagesWidget::copyMessages
+ * Copies the selected messages to the clipboard.
+ * Slot activated when mpCopyAction triggered signal is raised.
+ */
+void MessagesWidget::copyMessages()
+{
+  QModelIndexList indexes = mpMessagesListView->selectionModel()->selectedIndexes();
+  QList<int> rows;
+  foreach (QModelIndex index, indexes) {
+    rows.append(mpMessagesProxyModel->mapToSource(index).row());
+  }
+  // keep the order of the messages and not the order of selection.
+  qSort(rows);
+  QStringList messages;
+  foreach (int row, rows) {
+    messages.append(mpMessagesModel->getMessageEntry(row).getText());
+  }
+  QApplication::clipboard()->setText(messages.join("\n\n"));
+}
+
+/*!
+ * \brief MessagesWidget::filterMessages
+ * Filters the messages by the filter text and the message type.
+ */
+void MessagesWidget::filterMessages()
+{
+  StringHandler::OpenModelicaErrors errorType;
+  errorType = (StringHandler::OpenModelicaErrors)mpErrorTypeFilterComboBox->itemData(mpErrorTypeFilterComboBox->currentIndex()).toInt();
+  mpMessagesProxyModel->setFilterRegExp(QRegExp(mpFilterTextBox->text(), Qt::CaseInsensitive, QRegExp::FixedString));
+  mpMessagesProxyModel->setErrorTypeFilter(errorType);
 }
 
 /*!
@@ -330,5 +649,5 @@ void MessagesWidget::showContextMenu(QPoint point)
 void MessagesWidget::clearMessages()
 {
   resetMessagesNumber();
-  mpMessagesTextBrowser->clear();
+  mpMessagesModel->clearMessageEntries();
 }
@@ -37,7 +37,12 @@
 
 #include "Util/StringHandler.h"
 
-#include <QTextBrowser>
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QListView>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QTimer>
 
 class MessageItem
 {
@@ -72,6 +77,63 @@ private:
   MessageItemType mMessageItemType;
 };
 
+class MessageEntry
+{
+public:
+  int mNumber;
+  QString mTime;
+  StringHandler::OpenModelicaErrorKinds mErrorKind;
+  StringHandler::OpenModelicaErrors mErrorType;
+  QString mMessage;
+  QString mClassName;
+  int mLineNumber;
+  // size of the word wrapped message. Computed by MessagesModel when the view asks for it.
+  mutable QSize mSizeHint;
+  QString getHeading() const;
+  QString getText() const;
+};
+
+class MessagesModel : public QAbstractListModel
+{
+  Q_OBJECT
+public:
+  MessagesModel(QObject *pParent = 0);
+  int rowCount(const QModelIndex &parent = QModelIndex()) const;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+  const MessageEntry& getMessageEntry(int row) const {return mMessageEntries.at((mFirstMessageEntry + row) % mMessageEntries.size());}
+  int getMaximumMessages() const {return mMaximumMessages;}
+  void setMaximumMessages(int maximumMessages);
+  void setColors(const QColor &notificationColor, const QColor &warningColor, const QColor &errorColor);
+  void setTextLayout(const QFont &font, int width, int textMargin);
+  void addMessageEntry(const MessageEntry &messageEntry);
+  void clearMessageEntries();
+private:
+  // ring buffer of messages. mFirstMessageEntry is the oldest message once the buffer is full.
+  QVector<MessageEntry> mMessageEntries;
+  int mFirstMessageEntry;
+  int mMessageEntriesCount;
+  int mMaximumMessages;
+  QColor mNotificationColor;
+  QColor mWarningColor;
+  QColor mErrorColor;
+  QFont mFont;
+  int mWidth;
+  int mTextMargin;
+  void linearizeMessageEntries();
+};
+
+class MessagesProxyModel : public QSortFilterProxyModel
+{
+  Q_OBJECT
+public:
+  MessagesProxyModel(QObject *pParent = 0);
+  void setErrorTypeFilter(StringHandler::OpenModelicaErrors errorType);
+private:
+  StringHandler::OpenModelicaErrors mErrorTypeFilter;
+protected:
+  virtual bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+};
+
 class MessagesWidget : public QWidget
 {
   Q_OBJECT
@@ -85,21 +147,32 @@ private:
 
   static MessagesWidget *mpInstance;
   int mMessageNumber;
-  QTextBrowser *mpMessagesTextBrowser;
+  MessagesModel *mpMessagesModel;
+  MessagesProxyModel *mpMessagesProxyModel;
+  QLineEdit *mpFilterTextBox;
+  QComboBox *mpErrorTypeFilterComboBox;
+  QListView *mpMessagesListView;
+  QTimer mScrollToBottomTimer;
   QAction *mpSelectAllAction;
   QAction *mpCopyAction;
   QAction *mpClearAllAction;
+  void updateTextLayout();
 public:
   static MessagesWidget* instance() {return mpInstance;}
   void resetMessagesNumber() {mMessageNumber = 1;}
-  QTextBrowser* getMessagesTextBrowser() {return mpMessagesTextBrowser;}
+  MessagesModel* getMessagesModel() {return mpMessagesModel;}
+  QListView* getMessagesListView() {return mpMessagesListView;}
   void applyMessagesSettings();
   void addGUIMessage(MessageItem messageItem);
+protected:
+  virtual bool eventFilter(QObject *pObject, QEvent *pEvent);
 signals:
   void MessageAdded();
 private slots:
-  void openErrorMessageClass(QUrl url);
+  void openErrorMessageClass(const QModelIndex &index);
   void showContextMenu(QPoint point);
+  void copyMessages();
+  void filterMessages();
   void clearMessages();
 };
 
@@ -47,11 +47,13 @@
 #include "ModelicaClassDialog.h"
 #include "TLM/TLMCoSimulationDialog.h"
 #include "Git/GitCommands.h"
+#include "util/read_matlab4.h"
 #if !defined(WITHOUT_OSG)
 #include "Animation/ThreeDViewer.h"
 #endif
 
 #include <QNetworkReply>
+#include <qmath.h>
 
 
 //! @class GraphicsScene
@@ -490,6 +492,106 @@ void GraphicsView::deleteComponentFromClass(Component *pComponent)
   }
 }
 
+/*!
+ * \brief GraphicsView::addComponentToList
+ * Adds the Component to the list of components and to the components hash.
+ * \param pComponent
+ */
+void GraphicsView::addComponentToList(Component *pComponent)
+{
+  mComponentsList.append(pComponent);
+  mComponentsHash.insert(pComponent->getName(), pComponent);
+  mComponentsHashNames.insert(pComponent, pComponent->getName());
+}
+
+/*!
+ * \brief GraphicsView::deleteComponentFromList
+ * Removes the Component from the list of components and from the components hash.
+ * \param pComponent
+ */
+void GraphicsView::deleteComponentFromList(Component *pComponent)
+{
+  mComponentsList.removeOne(pComponent);
+  // remove the component with the name it is hashed with since it might be renamed.
+  mComponentsHash.remove(mComponentsHashNames.take(pComponent), pComponent);
+}
+
+/*!
+ * \brief GraphicsView::clearComponentsList
+ * Removes all the components from the list of components and from the components hash.
+ */
+void GraphicsView::clearComponentsList()
+{
+  mComponentsList.clear();
+  mComponentsHash.clear();
+  mComponentsHashNames.clear();
+}
+
+/*!
+ * \brief GraphicsView::updateComponentName
+ * Rehashes the Component with its new name.
+ * \param pComponent
+ * \return the name the component was hashed with or an empty string if the name is not changed.
+ */
+QString GraphicsView::updateComponentName(Component *pComponent)
+{
+  QHash<Component*, QString>::iterator iterator = mComponentsHashNames.find(pComponent);
+  if (iterator == mComponentsHashNames.end() || iterator.value().compare(pComponent->getName()) == 0) {
+    return "";
+  }
+  QString oldName = iterator.value();
+  mComponentsHash.remove(oldName, pComponent);
+  mComponentsHash.insert(pComponent->getName(), pComponent);
+  iterator.value() = pComponent->getName();
+  return oldName;
+}
+
+/*!
+ * \brief GraphicsView::updateComponentsNames
+ * Rehashes the components hashed with oldName that are renamed.
+ * Used when the component is renamed through the ComponentInfo shared with a component of another view.
+ * \param oldName
+ */
+void GraphicsView::updateComponentsNames(QString oldName)
+{
+  foreach (Component *pComponent, mComponentsHash.values(oldName)) {
+    updateComponentName(pComponent);
+  }
+}
+
+/*!
+ * \brief GraphicsView::addInheritedComponentToList
+ * Adds the Component to the list of inherited components and to the inherited components hash.
+ * The hash keeps the first inherited component of each name.
+ * \param pComponent
+ */
+void GraphicsView::addInheritedComponentToList(Component *pComponent)
+{
+  mInheritedComponentsList.append(pComponent);
+  if (!mInheritedComponentsHash.contains(pComponent->getName())) {
+    mInheritedComponentsHash.insert(pComponent->getName(), pComponent);
+  }
+}
+
+/*!
+ * \brief GraphicsView::deleteInheritedComponentFromList
+ * Removes the Component from the list of inherited components and from the inherited components hash.
+ * \param pComponent
+ */
+void GraphicsView::deleteInheritedComponentFromList(Component *pComponent)
+{
+  mInheritedComponentsList.removeOne(pComponent);
+  if (mInheritedComponentsHash.value(pComponent->getName(), 0) == pComponent) {
+    mInheritedComponentsHash.remove(pComponent->getName());
+    foreach (Component *pInheritedComponent, mInheritedComponentsList) {
+      if (pInheritedComponent->getName().compare(pComponent->getName()) == 0) {
+        mInheritedComponentsHash.insert(pInheritedComponent->getName(), pInheritedComponent);
+        break;
+      }
+    }
+  }
+}
+
 /*!
  * \brief GraphicsView::getComponentObject
  * Finds the Component
@@ -499,12 +601,18 @@ void GraphicsView::deleteComponentFromClass(Component *pComponent)
 Component* GraphicsView::getComponentObject(QString componentName)
 {
   // look in inherited components
-  foreach (Component *pInheritedComponent, mInheritedComponentsList) {
-    if (pInheritedComponent->getName().compare(componentName) == 0) {
-      return pInheritedComponent;
-    }
+  Component *pInheritedComponent = mInheritedComponentsHash.value(componentName, 0);
+  if (pInheritedComponent) {
+    return pInheritedComponent;
   }
   // look in components
+  int count = mComponentsHash.count(componentName);
+  if (count == 0) {
+    return 0;
+  } else if (count == 1) {
+    return mComponentsHash.value(componentName);
+  }
+  // in case of multiple declarations return the first declared component.
   foreach (Component *pComponent, mComponentsList) {
     if (pComponent->getName().compare(componentName) == 0) {
       return pComponent;
@@ -524,11 +632,8 @@ QString GraphicsView::getUniqueComponentName(QString componentName, int number)
 {
   QString name;
   name = QString(componentName).append(QString::number(number));
-  foreach (Component *pComponent, mComponentsList) {
-    if (pComponent->getName().compare(name, Qt::CaseSensitive) == 0) {
-      name = getUniqueComponentName(componentName, ++number);
-      break;
-    }
+  if (!checkComponentName(name)) {
+    name = getUniqueComponentName(componentName, ++number);
   }
   return name;
 }
@@ -541,12 +646,7 @@ QString GraphicsView::getUniqueComponentName(QString componentName, int number)
  */
 bool GraphicsView::checkComponentName(QString componentName)
 {
-  foreach (Component *pComponent, mComponentsList) {
-    if (pComponent->getName().compare(componentName, Qt::CaseSensitive) == 0) {
-      return false;
-    }
-  }
-  return true;
+  return !mComponentsHash.contains(componentName);
 }
 
 /*!
@@ -751,7 +851,7 @@ void GraphicsView::createLineShape(QPointF point)
   }
 
   if (!isCreatingLineShape()) {
-    mpLineShapeAnnotation = new LineAnnotation("", this);
+    mpLineShapeAnnotation = new LineAnnotation(AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpLineShapeAnnotation));
     setIsCreatingLineShape(true);
     mpLineShapeAnnotation->addPoint(point);
@@ -768,7 +868,7 @@ void GraphicsView::createPolygonShape(QPointF point)
   }
 
   if (!isCreatingPolygonShape()) {
-    mpPolygonShapeAnnotation = new PolygonAnnotation("", this);
+    mpPolygonShapeAnnotation = new PolygonAnnotation(AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpPolygonShapeAnnotation));
     setIsCreatingPolygonShape(true);
     mpPolygonShapeAnnotation->addPoint(point);
@@ -786,7 +886,7 @@ void GraphicsView::createRectangleShape(QPointF point)
   }
 
   if (!isCreatingRectangleShape()) {
-    mpRectangleShapeAnnotation = new RectangleAnnotation("", this);
+    mpRectangleShapeAnnotation = new RectangleAnnotation(AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpRectangleShapeAnnotation));
     setIsCreatingRectangleShape(true);
     mpRectangleShapeAnnotation->replaceExtent(0, point);
@@ -818,7 +918,7 @@ void GraphicsView::createEllipseShape(QPointF point)
   }
 
   if (!isCreatingEllipseShape()) {
-    mpEllipseShapeAnnotation = new EllipseAnnotation("", this);
+    mpEllipseShapeAnnotation = new EllipseAnnotation(AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpEllipseShapeAnnotation));
     setIsCreatingEllipseShape(true);
     mpEllipseShapeAnnotation->replaceExtent(0, point);
@@ -850,7 +950,7 @@ void GraphicsView::createTextShape(QPointF point)
   }
 
   if (!isCreatingTextShape()) {
-    mpTextShapeAnnotation = new TextAnnotation("", this);
+    mpTextShapeAnnotation = new TextAnnotation(AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpTextShapeAnnotation));
     setIsCreatingTextShape(true);
     mpTextShapeAnnotation->setTextString("text");
@@ -884,7 +984,7 @@ void GraphicsView::createBitmapShape(QPointF point)
   }
 
   if (!isCreatingBitmapShape()) {
-    mpBitmapShapeAnnotation = new BitmapAnnotation(mpModelWidget->getLibraryTreeItem()->getFileName(), "", this);
+    mpBitmapShapeAnnotation = new BitmapAnnotation(mpModelWidget->getLibraryTreeItem()->getFileName(), AnnotationValue(), this);
     mpModelWidget->getUndoStack()->push(new AddShapeCommand(mpBitmapShapeAnnotation));
     setIsCreatingBitmapShape(true);
     mpBitmapShapeAnnotation->replaceExtent(0, point);
@@ -1667,35 +1767,28 @@ void GraphicsView::drawBackground(QPainter *painter, const QRectF &rect)
   if (mpModelWidget->getModelWidgetContainer()->isShowGridLines()) {
     painter->setBrush(Qt::NoBrush);
     painter->setPen(lightGrayPen);
-    /* Draw left half vertical lines */
+    /* Collect all the grid lines and draw them in one go.
+     * Skip the grid lines when they are so close on the screen that they would only gray out the background.
+     */
     int horizontalGridStep = mCoOrdinateSystem.getHorizontalGridStep() * 10;
-    qreal xAxisStep = 0;
-    qreal yAxisStep = rect.y();
-    xAxisStep -= horizontalGridStep;
-    while (xAxisStep > rect.left()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep -= horizontalGridStep;
-    }
-    /* Draw right half vertical lines */
-    xAxisStep = 0;
-    while (xAxisStep < rect.right()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep += horizontalGridStep;
-    }
-    /* Draw left half horizontal lines */
     int verticalGridStep = mCoOrdinateSystem.getVerticalGridStep() * 10;
-    xAxisStep = rect.x();
-    yAxisStep = 0;
-    yAxisStep += verticalGridStep;
-    while (yAxisStep < rect.bottom()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep += verticalGridStep;
-    }
-    /* Draw right half horizontal lines */
-    yAxisStep = 0;
-    while (yAxisStep > rect.top()) {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep -= verticalGridStep;
+    qreal horizontalDeviceStep = horizontalGridStep * qAbs(painter->worldTransform().m11());
+    qreal verticalDeviceStep = verticalGridStep * qAbs(painter->worldTransform().m22());
+    if (horizontalGridStep > 0 && verticalGridStep > 0 && horizontalDeviceStep >= 4 && verticalDeviceStep >= 4) {
+      QVector<QLineF> gridLines;
+      /* vertical lines */
+      qreal xAxisStep = qCeil(rect.left() / horizontalGridStep) * horizontalGridStep;
+      while (xAxisStep < rect.right()) {
+        gridLines.append(QLineF(xAxisStep, rect.top(), xAxisStep, rect.bottom()));
+        xAxisStep += horizontalGridStep;
+      }
+      /* horizontal lines */
+      qreal yAxisStep = qCeil(rect.top() / verticalGridStep) * verticalGridStep;
+      while (yAxisStep < rect.bottom()) {
+        gridLines.append(QLineF(rect.left(), yAxisStep, rect.right(), yAxisStep));
+        yAxisStep += verticalGridStep;
+      }
+      painter->drawLines(gridLines);
     }
     /* set the middle horizontal and vertical line gray */
     painter->setPen(grayPen);
@@ -2438,7 +2531,8 @@ void WelcomePageWidget::openLatestNewsItem(QListWidgetItem *pItem)
 ModelWidget::ModelWidget(LibraryTreeItem* pLibraryTreeItem, ModelWidgetContainer *pModelWidgetContainer)
   : QWidget(pModelWidgetContainer), mpModelWidgetContainer(pModelWidgetContainer), mpLibraryTreeItem(pLibraryTreeItem),
     mComponentsLoaded(false), mDiagramViewLoaded(false), mConnectionsLoaded(false), mCreateModelWidgetComponents(false),
-    mExtendsModifiersLoaded(false)
+    mExtendsModifiersLoaded(false), mpDynamicResultsTimeLabel(0), mpDynamicResultsTimeSlider(0), mCollectDynamicResults(false),
+    mDynamicResultsTimeIndex(-1)
 {
   mExtendsModifiersMap.clear();
   // create widgets based on library type
@@ -2725,6 +2819,8 @@ void ModelWidget::loadComponents()
  */
 void ModelWidget::loadDiagramView()
 {
+  QTime loadTime;
+  loadTime.start();
   loadComponents();
   if (!mDiagramViewLoaded) {
     drawModelInheritedClassShapes(this, StringHandler::Diagram);
@@ -2736,6 +2832,14 @@ void ModelWidget::loadDiagramView()
      * We have disabled loading the connectors so user gets fast browsing of libraries.
      */
     mpLibraryTreeItem->handleIconUpdated();
+    // report the cost of drawing the components so the effect of sharing the class shapes can be measured.
+    if (MainWindow::instance()->isDebug()) {
+      QString message = tr("Loaded the diagram view of %1 in %2 ms. It has %3 components drawn with %4 graphics items.")
+          .arg(mpLibraryTreeItem->getNameStructure()).arg(loadTime.elapsed())
+          .arg(mpDiagramGraphicsView->getComponentsList().size()).arg(mpDiagramGraphicsScene->items().size());
+      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, message, Helper::scriptingKind,
+                                                            Helper::notificationLevel));
+    }
   }
 }
 
@@ -2839,6 +2943,14 @@ void ModelWidget::createModelWidgetComponents()
       pViewButtonsHorizontalLayout->addWidget(mpDocumentationViewToolButton);
       mpModelicaTypeLabel->setText(StringHandler::getModelicaClassType(mpLibraryTreeItem->getRestriction()));
       mpViewTypeLabel->setText(StringHandler::getViewType(StringHandler::Diagram));
+      // time slider for replaying the DynamicSelect values of the result file
+      mpDynamicResultsTimeLabel = new Label;
+      mpDynamicResultsTimeLabel->hide();
+      mpDynamicResultsTimeSlider = new QSlider(Qt::Horizontal);
+      mpDynamicResultsTimeSlider->setMinimumWidth(150);
+      mpDynamicResultsTimeSlider->setTracking(true);
+      mpDynamicResultsTimeSlider->hide();
+      connect(mpDynamicResultsTimeSlider, SIGNAL(valueChanged(int)), SLOT(dynamicResultsTimeChanged(int)));
       // modelica text editor
       mpEditor = new ModelicaEditor(this);
       ModelicaHighlighter *pModelicaTextHighlighter = new ModelicaHighlighter(OptionsDialog::instance()->getModelicaEditorPage(),
@@ -2852,6 +2964,8 @@ void ModelWidget::createModelWidgetComponents()
       mpModelStatusBar->addPermanentWidget(mpViewTypeLabel, 0);
       mpModelStatusBar->addPermanentWidget(mpModelClassPathLabel, 0);
       mpModelStatusBar->addPermanentWidget(mpModelFilePathLabel, 1);
+      mpModelStatusBar->addPermanentWidget(mpDynamicResultsTimeSlider, 0);
+      mpModelStatusBar->addPermanentWidget(mpDynamicResultsTimeLabel, 0);
       mpModelStatusBar->addPermanentWidget(mpCursorPositionLabel, 0);
       mpModelStatusBar->addPermanentWidget(mpFileLockToolButton, 0);
       // set layout
@@ -3321,14 +3435,191 @@ void ModelWidget::updateUndoRedoActions()
  */
 void ModelWidget::updateDynamicResults(QString resultFileName)
 {
+  clearDynamicResults();
   mResultFileName = resultFileName;
   if (!resultFileName.isEmpty()) {
+    /* The first update shows the final values and collects the variables used by the DynamicSelect annotations.
+     * readDynamicResults() then reads their trajectories once so the time slider doesn't need to look them up again.
+     */
+    mCollectDynamicResults = true;
     foreach (Component *component, mpDiagramGraphicsView->getInheritedComponentsList()) {
       component->componentParameterHasChanged();
     }
     foreach (Component *component, mpDiagramGraphicsView->getComponentsList()) {
       component->componentParameterHasChanged();
     }
+    mCollectDynamicResults = false;
+    readDynamicResults(resultFileName);
+  }
+}
+
+/*!
+ * \brief ModelWidget::getDynamicResultValue
+ * Returns the value of the variable name of the component pComponent from the result file.\n
+ * Uses the cached trajectory at the time selected by the time slider if the trajectories are read.
+ * Otherwise returns the final value from the variables browser.
+ * \param pComponent - the Component whose shapes use the value.
+ * \param name
+ * \return the value or null if the variable is not found.
+ */
+QVariant ModelWidget::getDynamicResultValue(Component *pComponent, QString name)
+{
+  QVariant dynamicValue; // isNull() per default
+  if (mResultFileName.isEmpty()) {
+    return dynamicValue;
+  }
+  QString variableName = pComponent->getComponentInfo()->getName() + "." + name;
+  if (mDynamicResultsTimeIndex >= 0) {
+    /* A variable without a trajectory has no value at the selected time.
+     * Return null so the shape keeps its current value instead of showing the final one.
+     */
+    QHash<QString, QVector<double> >::const_iterator it = mDynamicResultsHash.constFind(variableName);
+    if (it != mDynamicResultsHash.constEnd()) {
+      const QVector<double> &values = it.value();
+      dynamicValue = values.size() == 1 ? values.at(0) : values.at(qMin(mDynamicResultsTimeIndex, values.size() - 1));
+    }
+    return dynamicValue;
+  }
+  VariablesTreeModel *pVariablesTreeModel = MainWindow::instance()->getVariablesWidget()->getVariablesTreeModel();
+  VariablesTreeItem *pVariablesTreeItem = pVariablesTreeModel->findVariablesTreeItem(mResultFileName + "." + variableName,
+                                                                                     pVariablesTreeModel->getRootVariablesTreeItem());
+  if (pVariablesTreeItem) {
+    dynamicValue = pVariablesTreeItem->getValue(pVariablesTreeItem->getPreviousUnit(), pVariablesTreeItem->getUnit());
+    if (mCollectDynamicResults) {
+      mDynamicResultsItemsHash.insert(variableName, pVariablesTreeItem);
+      mDynamicResultsComponentsHash.insert(variableName, pComponent);
+    }
+  }
+  return dynamicValue;
+}
+
+/*!
+ * \brief ModelWidget::readDynamicResults
+ * Reads the trajectories of the collected DynamicSelect variables from the mat result file.\n
+ * The values are converted to the display unit once and the time slider is shown if there is anything to replay.
+ * Also builds the list of the Components that use the read variables, only those are updated when the time changes.
+ * \param resultFileName
+ */
+void ModelWidget::readDynamicResults(QString resultFileName)
+{
+  if (mDynamicResultsItemsHash.isEmpty() || !resultFileName.endsWith(".mat")) {
+    mDynamicResultsItemsHash.clear();
+    mDynamicResultsComponentsHash.clear();
+    return;
+  }
+  VariablesTreeItem *pFirstVariablesTreeItem = mDynamicResultsItemsHash.constBegin().value();
+  QString fileName = QString("%1/%2").arg(pFirstVariablesTreeItem->getFilePath(), pFirstVariablesTreeItem->getFileName());
+  ModelicaMatReader matReader;
+  matReader.file = 0;
+  if (0 != omc_new_matlab4_reader(fileName.toStdString().c_str(), &matReader)) {
+    mDynamicResultsItemsHash.clear();
+    mDynamicResultsComponentsHash.clear();
+    return;
+  }
+  // The first variable of the result file is always the time.
+  const double *pTimeValues = omc_matlab4_read_vals(&matReader, 1);
+  if (pTimeValues && matReader.nrows > 1) {
+    mDynamicResultsTimes.reserve(matReader.nrows);
+    for (uint i = 0 ; i < matReader.nrows ; i++) {
+      mDynamicResultsTimes.append(pTimeValues[i]);
+    }
+    OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+    QHash<QString, VariablesTreeItem*>::const_iterator it;
+    for (it = mDynamicResultsItemsHash.constBegin() ; it != mDynamicResultsItemsHash.constEnd() ; ++it) {
+      VariablesTreeItem *pVariablesTreeItem = it.value();
+      ModelicaMatVariable_t *pMatVariable = omc_matlab4_find_var(&matReader, pVariablesTreeItem->getPlotVariable().toStdString().c_str());
+      if (!pMatVariable) {
+        continue;
+      }
+      QVector<double> values;
+      if (pMatVariable->isParam) {
+        double value = 0.0;
+        if (0 == omc_matlab4_val(&value, &matReader, pMatVariable, omc_matlab4_startTime(&matReader))) {
+          values.append(value);
+        }
+      } else {
+        const double *pValues = omc_matlab4_read_vals(&matReader, pMatVariable->index);
+        if (pValues) {
+          values.reserve(matReader.nrows);
+          for (uint i = 0 ; i < matReader.nrows ; i++) {
+            values.append(pValues[i]);
+          }
+        }
+      }
+      if (values.isEmpty()) {
+        continue;
+      }
+      if (pVariablesTreeItem->getPreviousUnit().compare(pVariablesTreeItem->getUnit()) != 0) {
+        OMCInterface::convertUnits_res convertUnit = pOMCProxy->convertUnits(pVariablesTreeItem->getPreviousUnit(),
+                                                                              pVariablesTreeItem->getUnit());
+        if (!convertUnit.unitsCompatible) {
+          continue;
+        }
+        for (int i = 0 ; i < values.size() ; i++) {
+          values[i] = Utilities::convertUnit(values.at(i), convertUnit.offset, convertUnit.scaleFactor);
+        }
+      }
+      mDynamicResultsHash.insert(it.key(), values);
+    }
+  }
+  omc_free_matlab4_reader(&matReader);
+  mDynamicResultsItemsHash.clear();
+  QHash<QString, QVector<double> >::const_iterator resultsIterator;
+  for (resultsIterator = mDynamicResultsHash.constBegin() ; resultsIterator != mDynamicResultsHash.constEnd() ; ++resultsIterator) {
+    foreach (QPointer<Component> pComponent, mDynamicResultsComponentsHash.values(resultsIterator.key())) {
+      if (pComponent && !mDynamicResultsComponentsList.contains(pComponent)) {
+        mDynamicResultsComponentsList.append(pComponent);
+      }
+    }
+  }
+  mDynamicResultsComponentsHash.clear();
+  if (!mDynamicResultsHash.isEmpty() && mpDynamicResultsTimeSlider) {
+    mpDynamicResultsTimeSlider->blockSignals(true);
+    mpDynamicResultsTimeSlider->setRange(0, mDynamicResultsTimes.size() - 1);
+    mpDynamicResultsTimeSlider->setValue(mDynamicResultsTimes.size() - 1);
+    mpDynamicResultsTimeSlider->blockSignals(false);
+    mDynamicResultsTimeIndex = mDynamicResultsTimes.size() - 1;
+    mpDynamicResultsTimeLabel->setText(tr("Time: %1").arg(mDynamicResultsTimes.last()));
+    mpDynamicResultsTimeSlider->show();
+    mpDynamicResultsTimeLabel->show();
+  }
+}
+
+/*!
+ * \brief ModelWidget::clearDynamicResults
+ * Clears the cached DynamicSelect trajectories and hides the time slider.
+ */
+void ModelWidget::clearDynamicResults()
+{
+  mDynamicResultsItemsHash.clear();
+  mDynamicResultsHash.clear();
+  mDynamicResultsTimes.clear();
+  mDynamicResultsComponentsHash.clear();
+  mDynamicResultsComponentsList.clear();
+  mDynamicResultsTimeIndex = -1;
+  if (mpDynamicResultsTimeSlider) {
+    mpDynamicResultsTimeSlider->hide();
+    mpDynamicResultsTimeLabel->hide();
+  }
+}
+
+/*!
+ * \brief ModelWidget::dynamicResultsTimeChanged
+ * Slot activated when mpDynamicResultsTimeSlider valueChanged signal is raised.\n
+ * Updates and repaints only the Components whose DynamicSelect annotations use the read trajectories.
+ * \param index
+ */
+void ModelWidget::dynamicResultsTimeChanged(int index)
+{
+  if (index < 0 || index >= mDynamicResultsTimes.size()) {
+    return;
+  }
+  mDynamicResultsTimeIndex = index;
+  mpDynamicResultsTimeLabel->setText(tr("Time: %1").arg(mDynamicResultsTimes.at(index)));
+  foreach (QPointer<Component> pComponent, mDynamicResultsComponentsList) {
+    if (pComponent) {
+      pComponent->updateDynamicSelect();
+    }
   }
 }
 
@@ -3885,29 +4176,29 @@ void ModelWidget::getModelIconDiagramShapes(StringHandler::ViewType viewType)
     pGraphicsView = mpDiagramGraphicsView;
     annotationString = pOMCProxy->getDiagramAnnotation(mpLibraryTreeItem->getNameStructure());
   }
-  annotationString = StringHandler::removeFirstLastCurlBrackets(annotationString);
-  if (annotationString.isEmpty()) {
-    drawBaseCoOrdinateSystem(this, pGraphicsView);
-    return;
+  // parse the annotation once, the result is enclosed in curly brackets.
+  AnnotationParser annotationParser(annotationString);
+  AnnotationValue list = annotationParser.getRoot();
+  if (list.size() == 1 && list.at(0).isArray()) {
+    list = list.at(0);
   }
-  QStringList list = StringHandler::getStrings(annotationString);
   // read the coordinate system
   if (list.size() < 8) {
     drawBaseCoOrdinateSystem(this, pGraphicsView);
     return;
   }
 
-  qreal left = qMin(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal bottom = qMin(list.at(1).toFloat(), list.at(3).toFloat());
-  qreal right = qMax(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal top = qMax(list.at(1).toFloat(), list.at(3).toFloat());
+  qreal left = qMin(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal bottom = qMin(list.at(1).toDouble(), list.at(3).toDouble());
+  qreal right = qMax(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal top = qMax(list.at(1).toDouble(), list.at(3).toDouble());
   QList<QPointF> extent;
   extent << QPointF(left, bottom) << QPointF(right, top);
   pGraphicsView->mCoOrdinateSystem.setExtent(extent);
-  pGraphicsView->mCoOrdinateSystem.setPreserveAspectRatio((list.at(4).compare("true") == 0) ? true : false);
-  pGraphicsView->mCoOrdinateSystem.setInitialScale(list.at(5).toFloat());
-  qreal horizontal = list.at(6).toFloat();
-  qreal vertical = list.at(7).toFloat();
+  pGraphicsView->mCoOrdinateSystem.setPreserveAspectRatio(list.at(4).toBool());
+  pGraphicsView->mCoOrdinateSystem.setInitialScale(list.at(5).toDouble());
+  qreal horizontal = list.at(6).toDouble();
+  qreal vertical = list.at(7).toDouble();
   pGraphicsView->mCoOrdinateSystem.setGrid(QPointF(horizontal, vertical));
   pGraphicsView->mCoOrdinateSystem.setValid(true);
   pGraphicsView->setExtentRectangle(left, bottom, right, top);
@@ -3915,59 +4206,53 @@ void ModelWidget::getModelIconDiagramShapes(StringHandler::ViewType viewType)
   // read the shapes
   if (list.size() < 9)
     return;
-  QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)), '(', ')');
-  // Now parse the shapes available in list
-  foreach (QString shape, shapesList) {
-    if (shape.startsWith("Line")) {
-      shape = shape.mid(QString("Line").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      LineAnnotation *pLineAnnotation = new LineAnnotation(shape, pGraphicsView);
+  AnnotationValue shapesList = list.at(8);
+  // Now create the shapes available in list. The shapes are created from the parsed record arguments.
+  for (int i = 0 ; i < shapesList.size() ; i++) {
+    AnnotationValue shape = shapesList.at(i);
+    if (!shape.isRecord()) {
+      continue;
+    }
+    QStringRef shapeName = shape.getRecordName();
+    AnnotationValue shapeArguments = shape.getRecordArguments();
+    if (shapeName == QLatin1String("Line")) {
+      LineAnnotation *pLineAnnotation = new LineAnnotation(shapeArguments, pGraphicsView);
       pLineAnnotation->initializeTransformation();
       pLineAnnotation->drawCornerItems();
       pLineAnnotation->setCornerItemsActiveOrPassive();
       pGraphicsView->addShapeToList(pLineAnnotation);
       pGraphicsView->addItem(pLineAnnotation);
-    } else if (shape.startsWith("Polygon")) {
-      shape = shape.mid(QString("Polygon").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(shape, pGraphicsView);
+    } else if (shapeName == QLatin1String("Polygon")) {
+      PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(shapeArguments, pGraphicsView);
       pPolygonAnnotation->initializeTransformation();
       pPolygonAnnotation->drawCornerItems();
       pPolygonAnnotation->setCornerItemsActiveOrPassive();
       pGraphicsView->addShapeToList(pPolygonAnnotation);
       pGraphicsView->addItem(pPolygonAnnotation);
-    } else if (shape.startsWith("Rectangle")) {
-      shape = shape.mid(QString("Rectangle").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(shape, pGraphicsView);
+    } else if (shapeName == QLatin1String("Rectangle")) {
+      RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(shapeArguments, pGraphicsView);
       pRectangleAnnotation->initializeTransformation();
       pRectangleAnnotation->drawCornerItems();
       pRectangleAnnotation->setCornerItemsActiveOrPassive();
       pGraphicsView->addShapeToList(pRectangleAnnotation);
       pGraphicsView->addItem(pRectangleAnnotation);
-    } else if (shape.startsWith("Ellipse")) {
-      shape = shape.mid(QString("Ellipse").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(shape, pGraphicsView);
+    } else if (shapeName == QLatin1String("Ellipse")) {
+      EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(shapeArguments, pGraphicsView);
       pEllipseAnnotation->initializeTransformation();
       pEllipseAnnotation->drawCornerItems();
       pEllipseAnnotation->setCornerItemsActiveOrPassive();
       pGraphicsView->addShapeToList(pEllipseAnnotation);
       pGraphicsView->addItem(pEllipseAnnotation);
-    } else if (shape.startsWith("Text")) {
-      shape = shape.mid(QString("Text").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      TextAnnotation *pTextAnnotation = new TextAnnotation(shape, pGraphicsView);
+    } else if (shapeName == QLatin1String("Text")) {
+      TextAnnotation *pTextAnnotation = new TextAnnotation(shapeArguments, pGraphicsView);
       pTextAnnotation->initializeTransformation();
       pTextAnnotation->drawCornerItems();
       pTextAnnotation->setCornerItemsActiveOrPassive();
       pGraphicsView->addShapeToList(pTextAnnotation);
       pGraphicsView->addItem(pTextAnnotation);
-    } else if (shape.startsWith("Bitmap")) {
+    } else if (shapeName == QLatin1String("Bitmap")) {
       /* create the bitmap shape */
-      shape = shape.mid(QString("Bitmap").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mpLibraryTreeItem->mClassInformation.fileName, shape, pGraphicsView);
+      BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mpLibraryTreeItem->mClassInformation.fileName, shapeArguments, pGraphicsView);
       pBitmapAnnotation->initializeTransformation();
       pBitmapAnnotation->drawCornerItems();
       pBitmapAnnotation->setCornerItemsActiveOrPassive();
@@ -4042,9 +4327,10 @@ void ModelWidget::removeClassComponents(StringHandler::ViewType viewType)
   } else {
     pGraphicsView = mpDiagramGraphicsView;
   }
-  foreach (Component *pComponent, pGraphicsView->getComponentsList()) {
+  QList<Component*> components = pGraphicsView->getComponentsList();
+  pGraphicsView->clearComponentsList();
+  foreach (Component *pComponent, components) {
     pComponent->removeChildren();
-    pGraphicsView->deleteComponentFromList(pComponent);
     pGraphicsView->removeItem(pComponent->getOriginItem());
     delete pComponent->getOriginItem();
     pGraphicsView->removeItem(pComponent);
@@ -4190,16 +4476,11 @@ void ModelWidget::getModelConnections()
   // get the connections
   MainWindow *pMainWindow = MainWindow::instance();
   LibraryTreeModel *pLibraryTreeModel = pMainWindow->getLibraryWidget()->getLibraryTreeModel();
-  int connectionCount = pMainWindow->getOMCProxy()->getConnectionCount(mpLibraryTreeItem->getNameStructure());
-  for (int i = 1 ; i <= connectionCount ; i++) {
-    // get the connection from OMC
-    QStringList connectionList = pMainWindow->getOMCProxy()->getNthConnection(mpLibraryTreeItem->getNameStructure(), i);
+  // get all the connections with their annotations from OMC
+  QList<QStringList> connections = pMainWindow->getOMCProxy()->getConnections(mpLibraryTreeItem->getNameStructure());
+  foreach (QStringList connection, connections) {
+    QStringList connectionList = connection.mid(0, 3);
     QString connectionString = QString("{%1}").arg(connectionList.join(","));
-    // if the connectionString only contains two items then continue the loop,
-    // because connection is not valid then
-    if (connectionList.size() < 3) {
-      continue;
-    }
     // get start and end components
     QStringList startComponentList = StringHandler::makeVariableParts(connectionList.at(0));
     QStringList endComponentList = StringHandler::makeVariableParts(connectionList.at(1));
@@ -4280,8 +4561,8 @@ void ModelWidget::getModelConnections()
                                                             Helper::scriptingKind, Helper::errorLevel));
       continue;
     }
-    // get the connector annotations from OMC
-    QString connectionAnnotationString = pMainWindow->getOMCProxy()->getNthConnectionAnnotation(mpLibraryTreeItem->getNameStructure(), i);
+    // get the connector annotations
+    QString connectionAnnotationString = connection.at(3);
     QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(connectionAnnotationString), '(', ')');
     // Now parse the shapes available in list
     QString lineShape = "";
@@ -4306,20 +4587,17 @@ void ModelWidget::getModelConnections()
  */
 void ModelWidget::detectMultipleDeclarations()
 {
-  for (int i = 0 ; i < mComponentsList.size() ; i++) {
-    for (int j = 0 ; j < mComponentsList.size() ; j++) {
-      if (i == j) {
-        j++;
-        continue;
-      }
-      if (mComponentsList[i]->getName().compare(mComponentsList[j]->getName()) == 0) {
-        MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
-                                                              GUIMessages::getMessage(GUIMessages::MULTIPLE_DECLARATIONS_COMPONENT)
-                                                              .arg(mComponentsList[i]->getName()),
-                                                              Helper::scriptingKind, Helper::errorLevel));
-        return;
-      }
+  QSet<QString> componentNames;
+  componentNames.reserve(mComponentsList.size());
+  foreach (ComponentInfo *pComponentInfo, mComponentsList) {
+    if (componentNames.contains(pComponentInfo->getName())) {
+      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                            GUIMessages::getMessage(GUIMessages::MULTIPLE_DECLARATIONS_COMPONENT)
+                                                            .arg(pComponentInfo->getName()),
+                                                            Helper::scriptingKind, Helper::errorLevel));
+      return;
     }
+    componentNames.insert(pComponentInfo->getName());
   }
 }
 
@@ -4621,6 +4899,7 @@ void ModelWidget::removeDynamicResults(QString resultFileName)
     return;
   }
   if (resultFileName.isEmpty() or resultFileName == mResultFileName) {
+    clearDynamicResults();
     mResultFileName = "";
     foreach (Component *component, mpDiagramGraphicsView->getInheritedComponentsList()) {
       component->componentParameterHasChanged();
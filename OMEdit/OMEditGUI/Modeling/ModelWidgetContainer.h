@@ -57,6 +57,7 @@
 #include <QSplitter>
 #include <QUndoStack>
 #include <QUndoView>
+#include <QSlider>
 
 class ModelWidget;
 class ComponentInfo;
@@ -97,9 +98,12 @@ private:
   bool mIsMovingComponentsAndShapes;
   bool mRenderingLibraryPixmap;
   QList<Component*> mComponentsList;
+  QMultiHash<QString, Component*> mComponentsHash;
+  QHash<Component*, QString> mComponentsHashNames;
   QList<LineAnnotation*> mConnectionsList;
   QList<ShapeAnnotation*> mShapesList;
   QList<Component*> mInheritedComponentsList;
+  QHash<QString, Component*> mInheritedComponentsHash;
   QList<LineAnnotation*> mInheritedConnectionsList;
   QList<ShapeAnnotation*> mInheritedShapesList;
   LineAnnotation *mpConnectionLineAnnotation;
@@ -172,13 +176,16 @@ public:
   bool addComponent(QString className, QPointF position);
   void addComponentToView(QString name, LibraryTreeItem *pLibraryTreeItem, QString annotation, QPointF position,
                           ComponentInfo *pComponentInfo, bool addObject = true, bool openingClass = false);
-  void addComponentToList(Component *pComponent) {mComponentsList.append(pComponent);}
-  void addInheritedComponentToList(Component *pComponent) {mInheritedComponentsList.append(pComponent);}
+  void addComponentToList(Component *pComponent);
+  void addInheritedComponentToList(Component *pComponent);
   void addComponentToClass(Component *pComponent);
   void deleteComponent(Component *pComponent);
   void deleteComponentFromClass(Component *pComponent);
-  void deleteComponentFromList(Component *pComponent) {mComponentsList.removeOne(pComponent);}
-  void deleteInheritedComponentFromList(Component *pComponent) {mInheritedComponentsList.removeOne(pComponent);}
+  void deleteComponentFromList(Component *pComponent);
+  void clearComponentsList();
+  QString updateComponentName(Component *pComponent);
+  void updateComponentsNames(QString oldName);
+  void deleteInheritedComponentFromList(Component *pComponent);
   Component* getComponentObject(QString componentName);
   QString getUniqueComponentName(QString componentName, int number = 1);
   bool checkComponentName(QString componentName);
@@ -328,6 +335,7 @@ class ModelWidgetContainer;
 class ModelicaHighlighter;
 class CompositeModelHighlighter;
 class Label;
+class VariablesTreeItem;
 class ModelWidget : public QWidget
 {
   Q_OBJECT
@@ -377,6 +385,7 @@ public:
   void updateUndoRedoActions();
   void updateDynamicResults(QString resultFileName);
   QString getResultFileName() {return mResultFileName;}
+  QVariant getDynamicResultValue(Component *pComponent, QString name);
   bool writeCoSimulationResultFile(QString fileName);
   bool writeVisualXMLFile(QString fileName, bool canWriteVisualXMLFile = false);
 private:
@@ -394,6 +403,8 @@ private:
   Label *mpModelFilePathLabel;
   Label *mpCursorPositionLabel;
   QToolButton *mpFileLockToolButton;
+  Label *mpDynamicResultsTimeLabel;
+  QSlider *mpDynamicResultsTimeSlider;
   GraphicsView *mpDiagramGraphicsView;
   GraphicsScene *mpDiagramGraphicsScene;
   GraphicsView *mpIconGraphicsView;
@@ -412,6 +423,13 @@ private:
   QList<ComponentInfo*> mComponentsList;
   QStringList mComponentsAnnotationsList;
   QString mResultFileName;
+  bool mCollectDynamicResults;
+  QHash<QString, VariablesTreeItem*> mDynamicResultsItemsHash;
+  QHash<QString, QVector<double> > mDynamicResultsHash;
+  QVector<double> mDynamicResultsTimes;
+  QMultiHash<QString, QPointer<Component> > mDynamicResultsComponentsHash;
+  QList<QPointer<Component> > mDynamicResultsComponentsList;
+  int mDynamicResultsTimeIndex;
 
   void getModelInheritedClasses();
   void drawModelInheritedClassShapes(ModelWidget *pModelWidget, StringHandler::ViewType viewType);
@@ -430,8 +448,11 @@ private:
   QString getCompositeModelName();
   void getCompositeModelSubModels();
   void getCompositeModelConnections();
+  void readDynamicResults(QString resultFileName);
+  void clearDynamicResults();
 private slots:
   void showIconView(bool checked);
+  void dynamicResultsTimeChanged(int index);
   void showDiagramView(bool checked);
   void showTextView(bool checked);
 public slots:
@@ -675,8 +675,7 @@ void SaveAsClassDialog::saveAsModelicaClass()
   {
     duplicateModelText.prepend(QString("within ").append(mpParentClassComboBox->currentText()).append(";"));
   }
-  MainWindow::instance()->getOMCProxy()->sendCommand(duplicateModelText);
-  if (MainWindow::instance()->getOMCProxy()->getResult().toLower().contains("error"))
+  if (!MainWindow::instance()->getOMCProxy()->saveModifiedModel(duplicateModelText))
   {
     QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error), GUIMessages::getMessage(
                             GUIMessages::ERROR_OCCURRED).arg(MainWindow::instance()->getOMCProxy()->getResult()).append("\n\n").
@@ -1757,6 +1756,9 @@ void RenameItemDialog::renameItem()
       return;
     }
     if (QFile::rename(oldFileInfo.absoluteFilePath(), fileInfo.absoluteFilePath())) {
+      LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+      // the name structure of the item and its nested items changes so update the name index.
+      pLibraryTreeModel->removeLibraryTreeItemFromIndex(mpLibraryTreeItem);
       mpLibraryTreeItem->setName(mpNameTextBox->text());
       mpLibraryTreeItem->setNameStructure(fileInfo.absoluteFilePath());
       mpLibraryTreeItem->setFileName(fileInfo.absoluteFilePath());
@@ -1768,6 +1770,7 @@ void RenameItemDialog::renameItem()
       if (fileInfo.isDir()) {
         updateChildrenPath(mpLibraryTreeItem);
       }
+      pLibraryTreeModel->addLibraryTreeItemToIndex(mpLibraryTreeItem);
     }
   } else if (mpLibraryTreeItem->getLibraryType() == LibraryTreeItem::CompositeModel) {
     if (mpLibraryTreeItem->getModelWidget()) {
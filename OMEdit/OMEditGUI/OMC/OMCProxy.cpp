@@ -57,10 +57,13 @@ void omc_Main_setWindowsPaths(threadData_t *threadData, void* _inOMHome);
 #include "MainWindow.h"
 #include "Options/OptionsDialog.h"
 #include "Modeling/MessagesWidget.h"
+#include "Plotting/PlotWindowContainer.h"
+#include "Util/UnitConverter.h"
 #include "simulation_options.h"
 #include "omc_error.h"
 
 #include <QMessageBox>
+#include <QEventLoop>
 
 /*!
  * \class OMCProxy
@@ -71,9 +74,12 @@ void omc_Main_setWindowsPaths(threadData_t *threadData, void* _inOMHome);
  * \param pParent
  */
 OMCProxy::OMCProxy(QWidget *pParent)
-  : QObject(pParent), mHasInitialized(false), mResult(""), mTotalOMCCallsTime(0.0)
+  : QObject(pParent), mHasInitialized(false), mResult(""), mTotalOMCCallsTime(0.0), mpOMCCommandThread(0), mPendingCommandsCount(0),
+    mWaitingForCommand(false), mCacheHits(0), mCacheMisses(0)
 {
   mCurrentCommandIndex = -1;
+  // keep the responses of the last 1000 classes.
+  mCachedResponses.setMaxCost(1000);
   // OMC Commands Logger Widget
   mpOMCLoggerWidget = new QWidget;
   mpOMCLoggerWidget->resize(640, 480);
@@ -122,7 +128,7 @@ OMCProxy::OMCProxy(QWidget *pParent)
     pOMCDiffWidgetLayout->addWidget(mpOMCDiffMergedTextBox, 3, 0, 1, 2);
     mpOMCDiffWidget->setLayout(pOMCDiffWidgetLayout);
   }
-  mUnitConversionList.clear();
+  mUnitConversionHash.clear();
   mDerivedUnitsMap.clear();
   //start the server
   if(!initializeOMC()) {  // if we are unable to start OMC. Exit the application.
@@ -199,6 +205,8 @@ bool OMCProxy::initializeOMC()
   args = mmc_mk_cons(mmc_mk_scon(locale.toStdString().c_str()), args);
   // initialize threadData
   omc_System_initGarbageCollector(NULL);
+  // allow the OMCCommandThread to register itself with the garbage collector.
+  GC_allow_register_threads();
   threadData_t *threadData = (threadData_t *) GC_malloc(sizeof(threadData_t));
   void *st = 0;
   MMC_TRY_TOP_INTERNAL()
@@ -208,9 +216,16 @@ bool OMCProxy::initializeOMC()
   threadData->plotCB = MainWindow::PlotCallbackFunction;
   MMC_CATCH_TOP(return false;)
   mpOMCInterface = new OMCInterface(threadData, st);
-  connect(mpOMCInterface, SIGNAL(logCommand(QString,QTime*)), this, SLOT(logCommand(QString,QTime*)));
-  connect(mpOMCInterface, SIGNAL(logResponse(QString,QTime*)), this, SLOT(logResponse(QString,QTime*)));
-  connect(mpOMCInterface, SIGNAL(throwException(QString)), SLOT(showException(QString)));
+  /* OMCInterface is only called by the OMCCommandThread. The log signals pass a pointer to a local QTime so handle them directly in the
+   * thread and forward copies of the values to the GUI thread.
+   */
+  connect(mpOMCInterface, SIGNAL(logCommand(QString,QTime*)), this, SLOT(logInterfaceCommand(QString,QTime*)), Qt::DirectConnection);
+  connect(mpOMCInterface, SIGNAL(logResponse(QString,QTime*)), this, SLOT(logInterfaceResponse(QString,QTime*)), Qt::DirectConnection);
+  connect(mpOMCInterface, SIGNAL(throwException(QString)), SLOT(showException(QString)), Qt::QueuedConnection);
+  // start the thread that executes the commands sent via sendCommand and the OMCInterface calls.
+  mpOMCCommandThread = new OMCCommandThread(mpOMCInterface, this);
+  connect(mpOMCCommandThread, SIGNAL(commandExecuted()), SLOT(handleCommandExecuted()), Qt::QueuedConnection);
+  mpOMCCommandThread->start();
   mHasInitialized = true;
   // get OpenModelica version
   Helper::OpenModelicaVersion = getVersion();
@@ -218,8 +233,9 @@ bool OMCProxy::initializeOMC()
   sendCommand("\"" +  QString(GIT_SHA) + "\"");
 #endif
   // set OpenModelicaHome variable
-  Helper::OpenModelicaHome = mpOMCInterface->getInstallationDirectoryPath();
+  Helper::OpenModelicaHome = callOMCInterface(&OMCInterface::getInstallationDirectoryPath);
 #ifdef WIN32
+  // the OMCCommandThread is idle here since we just waited for getInstallationDirectoryPath.
   MMC_TRY_TOP_INTERNAL()
   omc_Main_setWindowsPaths(threadData, mmc_mk_scon(Helper::OpenModelicaHome.toStdString().c_str()));
   MMC_CATCH_TOP()
@@ -239,7 +255,14 @@ bool OMCProxy::initializeOMC()
  */
 void OMCProxy::quitOMC()
 {
+  if (mpCommunicationLogFile) {
+    fputs(QString("Cached responses: %1 hits, %2 misses\n\n").arg(mCacheHits).arg(mCacheMisses).toStdString().c_str(), mpCommunicationLogFile);
+  }
   sendCommand("quit()");
+  if (mpOMCCommandThread) {
+    mpOMCCommandThread->stop();
+    mpOMCCommandThread->wait();
+  }
   if (mpCommunicationLogFile) {
     fclose(mpCommunicationLogFile);
   }
@@ -250,47 +273,190 @@ void OMCProxy::quitOMC()
 
 /*!
  * \brief OMCProxy::sendCommand
- * Sends the user commands to OMC.
+ * Sends the user commands to OMC.\n
+ * The command is executed by the OMCCommandThread.
  * \param expression - is used to send command as a string.
+ * \sa OMCProxy::sendCommandAsync()
+ * \sa OMCProxy::waitForCommand()
  */
 void OMCProxy::sendCommand(const QString expression)
+{
+  waitForResult(sendCommandAsync(expression));
+}
+
+/*!
+ * \brief OMCProxy::waitForResult
+ * Waits for the command sent via OMCProxy::sendCommandAsync() and sets its result as the current result.
+ * \param pOMCCommand
+ * \sa OMCProxy::getResult()
+ */
+void OMCProxy::waitForResult(OMCCommand *pOMCCommand)
+{
+  if (!pOMCCommand) {
+    mResult = "";
+    return;
+  }
+  waitForCommand(pOMCCommand);
+  // an auto delete command is deleted later via deleteLater so it is still valid here.
+  mResult = pOMCCommand->getResult();
+}
+
+/*!
+ * \brief OMCProxy::sendCommandAsync
+ * Queues the command for the OMCCommandThread and returns immediately.\n
+ * The commands are executed in the order they are sent. Connect to OMCCommand::finished() to get the result.
+ * The returned OMCCommand is deleted once it is finished unless OMCCommand::setAutoDelete(false) is called.
+ * \param expression - is used to send command as a string.
+ * \return the command handle or 0 if OMC is not running.
+ */
+OMCCommand* OMCProxy::sendCommandAsync(const QString expression)
 {
   if (!mHasInitialized) {
     // if we are unable to start OMC. Exit the application.
     if(!initializeOMC()) {
       MainWindow::instance()->setExitApplicationStatus(true);
-      return;
+      return 0;
     }
   }
+  OMCCommand *pOMCCommand = new OMCCommand(expression, this);
   // write command to the commands log.
-  QTime commandTime;
-  commandTime.start();
-  logCommand(expression, &commandTime);
-  // TODO: Call this in a thread that loops over received messages? Avoid MMC_TRY_TOP all the time, etc
-  void *reply_str = NULL;
-  threadData_t *threadData = mpOMCInterface->threadData;
+  pOMCCommand->getCommandTime()->start();
+  logCommand(expression, pOMCCommand->getCommandTime());
+  mPendingCommandsCount++;
+  mpOMCCommandThread->enqueueCommand(pOMCCommand);
+  return pOMCCommand;
+}
 
-  MMC_TRY_TOP_INTERNAL()
+/*!
+ * \brief OMCProxy::enqueueInterfaceCall
+ * Queues the typed OMCInterface call for the OMCCommandThread.\n
+ * OMCInterface logs the call itself.
+ * \param pOMCCommand
+ * \return false if OMC is not running.
+ * \sa OMCProxy::callOMCInterface()
+ */
+bool OMCProxy::enqueueInterfaceCall(OMCCommand *pOMCCommand)
+{
+  if (!mHasInitialized) {
+    // if we are unable to start OMC. Exit the application.
+    if(!initializeOMC()) {
+      MainWindow::instance()->setExitApplicationStatus(true);
+      delete pOMCCommand;
+      return false;
+    }
+  }
+  mPendingCommandsCount++;
+  mpOMCCommandThread->enqueueCommand(pOMCCommand);
+  return true;
+}
 
-  MMC_TRY_STACK()
+/*!
+ * \brief OMCProxy::cancelCommand
+ * Removes the command from the queue if OMCCommandThread has not started it yet.\n
+ * A command that is already running can't be interrupted.
+ * \param pOMCCommand
+ * \return true if the command is cancelled.
+ */
+bool OMCProxy::cancelCommand(OMCCommand *pOMCCommand)
+{
+  if (pOMCCommand && mpOMCCommandThread && mpOMCCommandThread->cancelCommand(pOMCCommand)) {
+    logResponse(tr("Command cancelled."), pOMCCommand->getCommandTime());
+    finishCommand(pOMCCommand);
+    return true;
+  }
+  return false;
+}
 
-  if (!omc_Main_handleCommand(threadData, mmc_mk_scon(expression.toStdString().c_str()), mpOMCInterface->st, &reply_str, &mpOMCInterface->st)) {
-    if (expression == "quit()") {
-      return;
-    }
-    exitApplication();
+/*!
+ * \brief OMCProxy::waitForCommand
+ * Waits for the command to be executed.\n
+ * While waiting we keep processing the events except the user input so the GUI is repainted but the user can't start another action
+ * in the middle of this one. The user input is not lost, it is delivered once the command is finished.
+ * The commands that can take long, loading a library, instantiating or checking a model, are sent via the async functions instead so
+ * the GUI is not blocked at all.\n
+ * An event processed here might send another command. That command is waited for without starting another event loop so we never
+ * re-enter more than once. In that case the executed commands are finished right away so the command is complete when we return.
+ * \param pOMCCommand
+ */
+void OMCProxy::waitForCommand(OMCCommand *pOMCCommand)
+{
+  if (pOMCCommand->isFinished()) {
+    return;
+  }
+  if (mWaitingForCommand) {
+    mpOMCCommandThread->waitForCommand(pOMCCommand);
+    handleCommandExecuted();
+  } else {
+    mWaitingForCommand = true;
+    QEventLoop eventLoop;
+    connect(pOMCCommand, SIGNAL(finished(QString)), &eventLoop, SLOT(quit()));
+    eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+    mWaitingForCommand = false;
   }
-  mResult = MMC_STRINGDATA(reply_str);
-  logResponse(mResult.trimmed(), &commandTime);
+}
 
-  MMC_ELSE()
-    mResult = "";
-    fprintf(stderr, "Stack overflow detected and was not caught.\nSend us a bug report at https://trac.openmodelica.org/OpenModelica/newticket\n    Include the following trace:\n");
-    printStacktraceMessages();
-    fflush(NULL);
-  MMC_CATCH_STACK()
+/*!
+ * \brief OMCProxy::waitForCommands
+ * Waits until all the queued commands are executed.
+ * \sa OMCProxy::waitForCommand()
+ */
+void OMCProxy::waitForCommands()
+{
+  if (mPendingCommandsCount == 0) {
+    return;
+  }
+  if (mWaitingForCommand) {
+    mpOMCCommandThread->waitForIdle();
+    handleCommandExecuted();
+  } else {
+    mWaitingForCommand = true;
+    QEventLoop eventLoop;
+    connect(this, SIGNAL(commandsFinished()), &eventLoop, SLOT(quit()));
+    eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+    mWaitingForCommand = false;
+  }
+}
 
-  MMC_CATCH_TOP(mResult = "");
+/*!
+ * \brief OMCProxy::handleCommandExecuted
+ * Slot activated when OMCCommandThread commandExecuted signal is raised.\n
+ * Finishes the executed commands in the order they are executed. Also called directly by the nested waits.
+ */
+void OMCProxy::handleCommandExecuted()
+{
+  // take the commands one by one since finishing a command might wait for another one and finish the rest of them.
+  OMCCommand *pOMCCommand;
+  while ((pOMCCommand = mpOMCCommandThread->takeExecutedCommand())) {
+    finishCommand(pOMCCommand);
+  }
+}
+
+/*!
+ * \brief OMCProxy::finishCommand
+ * Logs the response and notifies the listeners of the command.
+ * \param pOMCCommand
+ */
+void OMCProxy::finishCommand(OMCCommand *pOMCCommand)
+{
+  if (!pOMCCommand->isCancelled() && !pOMCCommand->isInterfaceCall()) {
+    if (!pOMCCommand->isSuccess()) {
+      if (pOMCCommand->getExpression().compare("quit()") != 0) {
+        exitApplication();
+      }
+    } else {
+      logResponse(pOMCCommand->getResult(), pOMCCommand->getCommandTime());
+    }
+  }
+  pOMCCommand->setFinished(true);
+  mPendingCommandsCount--;
+  emit pOMCCommand->finished(pOMCCommand->getResult());
+  emit commandFinished();
+  if (mPendingCommandsCount == 0) {
+    emit commandsFinished();
+  }
+  if (pOMCCommand->autoDelete()) {
+    pOMCCommand->deleteLater();
+  }
 }
 
 /*!
@@ -320,6 +486,56 @@ QString OMCProxy::getResult()
  * \param commandTime - the command start time
  */
 void OMCProxy::logCommand(QString command, QTime *commandTime)
+{
+  writeCommandLog(command, commandTime->currentTime());
+}
+
+/*!
+ * \brief OMCProxy::logResponse
+ * Writes OMC response in OMC Logger window.
+ * Writes the response to the omeditcommunication.log file.
+ * \param response - the response to write
+ * \param responseTime - the command start time
+ */
+void OMCProxy::logResponse(QString response, QTime *responseTime)
+{
+  writeResponseLog(response, responseTime->currentTime(), responseTime->elapsed());
+}
+
+/*!
+ * \brief OMCProxy::logInterfaceCommand
+ * Slot activated in the OMCCommandThread when OMCInterface logCommand signal is raised.\n
+ * Forwards the command to the GUI thread.
+ * \param command
+ * \param commandTime
+ */
+void OMCProxy::logInterfaceCommand(QString command, QTime *commandTime)
+{
+  QMetaObject::invokeMethod(this, "writeCommandLog", Qt::QueuedConnection, Q_ARG(QString, command), Q_ARG(QTime, commandTime->currentTime()));
+}
+
+/*!
+ * \brief OMCProxy::logInterfaceResponse
+ * Slot activated in the OMCCommandThread when OMCInterface logResponse signal is raised.\n
+ * Forwards the response and the time it took to the GUI thread.
+ * \param response
+ * \param responseTime
+ */
+void OMCProxy::logInterfaceResponse(QString response, QTime *responseTime)
+{
+  QMetaObject::invokeMethod(this, "writeResponseLog", Qt::QueuedConnection, Q_ARG(QString, response),
+                            Q_ARG(QTime, responseTime->currentTime()), Q_ARG(int, responseTime->elapsed()));
+}
+
+/*!
+ * \brief OMCProxy::writeCommandLog
+ * Writes OMC command in OMC Logger window.
+ * Writes the command to the omeditcommunication.log file.
+ * Writes the command to the omeditcommands.mos file.
+ * \param command - the command to write
+ * \param time - the time the command is sent
+ */
+void OMCProxy::writeCommandLog(QString command, QTime time)
 {
   // insert the command to the logger window.
   QFont font(Helper::monospacedFontInfo.family(), Helper::monospacedFontInfo.pointSize() - 2, QFont::Bold, false);
@@ -333,7 +549,7 @@ void OMCProxy::logCommand(QString command, QTime *commandTime)
   mpExpressionTextBox->setText("");
   // write the log to communication log file
   if (mpCommunicationLogFile) {
-    fputs(QString("%1 %2\n").arg(command, commandTime->currentTime().toString("hh:mm:ss:zzz")).toStdString().c_str(), mpCommunicationLogFile);
+    fputs(QString("%1 %2\n").arg(command, time.toString("hh:mm:ss:zzz")).toStdString().c_str(), mpCommunicationLogFile);
   }
   // write commands mos file
   if (mpCommandsLogFile) {
@@ -346,13 +562,14 @@ void OMCProxy::logCommand(QString command, QTime *commandTime)
 }
 
 /*!
- * \brief OMCProxy::logResponse
+ * \brief OMCProxy::writeResponseLog
  * Writes OMC response in OMC Logger window.
  * Writes the response to the omeditcommunication.log file.
  * \param response - the response to write
- * \param responseTime - the response end time
+ * \param time - the response end time
+ * \param elapsed - the milliseconds the command took
  */
-void OMCProxy::logResponse(QString response, QTime *responseTime)
+void OMCProxy::writeResponseLog(QString response, QTime time, int elapsed)
 {
   // insert the response to the logger window.
   QFont font(Helper::monospacedFontInfo.family(), Helper::monospacedFontInfo.pointSize() - 2, QFont::Normal, false);
@@ -361,9 +578,9 @@ void OMCProxy::logResponse(QString response, QTime *responseTime)
   Utilities::insertText(mpOMCLoggerTextBox, response + "\n\n", format);
   // write the log to communication log file
   if (mpCommunicationLogFile) {
-    fputs(QString("%1 %2\n").arg(response).arg(responseTime->currentTime().toString("hh:mm:ss:zzz")).toStdString().c_str(), mpCommunicationLogFile);
-    mTotalOMCCallsTime += (double)responseTime->elapsed() / 1000;
-    fputs(QString("%1 secs (%2 secs)\n\n").arg(QString::number((double)responseTime->elapsed() / 1000)).arg(QString::number(mTotalOMCCallsTime)).toStdString().c_str(), mpCommunicationLogFile);
+    fputs(QString("%1 %2\n").arg(response).arg(time.toString("hh:mm:ss:zzz")).toStdString().c_str(), mpCommunicationLogFile);
+    mTotalOMCCallsTime += (double)elapsed / 1000;
+    fputs(QString("%1 secs (%2 secs)\n\n").arg(QString::number((double)elapsed / 1000)).arg(QString::number(mTotalOMCCallsTime)).toStdString().c_str(), mpCommunicationLogFile);
   }
 }
 
@@ -398,6 +615,8 @@ void OMCProxy::sendCustomExpression()
   if (mpExpressionTextBox->text().isEmpty())
     return;
 
+  // we don't know what the user has changed.
+  clearCachedResponses();
   sendCommand(mpExpressionTextBox->text());
   mpExpressionTextBox->setText("");
 }
@@ -441,150 +660,219 @@ void OMCProxy::exitApplication()
 }
 
 /*!
- * \brief OMCProxy::getErrorString
- * Returns the OMC error string.\n
- * \param warningsAsErrors
- * \return the error string.
- * \deprecated Use printMessagesStringInternal(). Now used where we want to consume the error message without showing it to user.
+ * \brief OMCProxy::getCachedResponse
+ * Looks up the cached response of a query command.
+ * \param className - the class the command is about.
+ * \param command - the query command.
+ * \param pResponse - set to the cached response.
+ * \return true if the response is found.
+ * \sa OMCProxy::cacheResponse()
  */
-QString OMCProxy::getErrorString(bool warningsAsErrors)
-{
-  return mpOMCInterface->getErrorString(warningsAsErrors);
-}
-
-/*!
-  Gets the errors by using the getMessagesStringInternal API.
-  Reads all the errors and add them to the Messages Window.
-  \see MessagesWidget::addGUIMessage
-  \return true if there are any errors otherwise false.'
-  */
-bool OMCProxy::printMessagesStringInternal()
+bool OMCProxy::getCachedResponse(const QString &className, const QString &command, QVariant *pResponse)
 {
-  int errorsSize = getMessagesStringInternal();
-  bool returnValue = errorsSize > 0 ? true : false;
-
-  /* Loop in reverse order since getMessagesStringInternal returns error messages in reverse order. */
-  for (int i = errorsSize; i > 0 ; i--) {
-    setCurrentError(i);
-    MessageItem messageItem(MessageItem::Modelica, getErrorFileName(), getErrorReadOnly(), getErrorLineStart(), getErrorColumnStart(), getErrorLineEnd(),
-                            getErrorColumnEnd(), getErrorMessage(), getErrorKind(), getErrorLevel());
-    MessagesWidget::instance()->addGUIMessage(messageItem);
+  QHash<QString, QVariant> *pClassResponses = mCachedResponses.object(className);
+  if (pClassResponses) {
+    QHash<QString, QVariant>::const_iterator commandIterator = pClassResponses->constFind(command);
+    if (commandIterator != pClassResponses->constEnd()) {
+      *pResponse = commandIterator.value();
+      mCacheHits++;
+      return true;
+    }
   }
-  return returnValue;
+  mCacheMisses++;
+  return false;
 }
 
 /*!
-  Retrieves the list of errors from OMC
-  \return size of errors
-  */
-int OMCProxy::getMessagesStringInternal()
-{
-  sendCommand("errors:=getMessagesStringInternal()");
-  sendCommand("size(errors,1)");
-  return getResult().toInt();
-}
-
-/*!
-  Sets the current error.
-  \param int the error index
-  */
-void OMCProxy::setCurrentError(int errorIndex)
-{
-  sendCommand("currentError:=errors[" + QString::number(errorIndex) + "]");
-}
-
-/*!
-  Gets the error file name from current error.
-  \return the error file name
-  */
-QString OMCProxy::getErrorFileName()
-{
-  sendCommand("currentError.info.filename");
-  QString file = StringHandler::unparse(getResult());
-  if (file.compare("<interactive>") == 0)
-    return "";
-  else
-    return file;
-}
-
-/*!
-  Gets the error read only state from current error.
-  \return the error read only state
-  */
-bool OMCProxy::getErrorReadOnly()
+ * \brief OMCProxy::cacheResponse
+ * Caches the response of a query command. The response is valid until the class or one of its base classes is modified.\n
+ * The responses of the least recently used classes are removed once the cache is full.
+ * \param className - the class the command is about.
+ * \param command - the query command.
+ * \param response
+ * \sa OMCProxy::invalidateCachedResponses()
+ */
+void OMCProxy::cacheResponse(const QString &className, const QString &command, const QVariant &response)
 {
-  sendCommand("currentError.info.readonly");
-  return StringHandler::unparseBool(StringHandler::unparse(getResult()));
+  QHash<QString, QVariant> *pClassResponses = mCachedResponses.object(className);
+  if (!pClassResponses) {
+    pClassResponses = new QHash<QString, QVariant>;
+    mCachedResponses.insert(className, pClassResponses);
+  }
+  pClassResponses->insert(command, response);
 }
 
 /*!
-  Gets the error line start index from current error.
-  \return the error line start index
-  */
-int OMCProxy::getErrorLineStart()
+ * \brief OMCProxy::addCachedResponsesDependency
+ * Records that the cached responses of dependentClassName must be invalidated whenever className is modified.\n
+ * The dependencies are kept outside of the responses cache so they survive when the responses of a class are removed from the cache.
+ * \param className - the used or inherited class. The name can be relative.
+ * \param dependentClassName
+ */
+void OMCProxy::addCachedResponsesDependency(const QString &className, const QString &dependentClassName)
 {
-  sendCommand("currentError.info.lineStart");
-  return getResult().toInt();
+  if (className.compare(dependentClassName) != 0) {
+    mCachedResponsesDependents[className].insert(dependentClassName);
+  }
 }
 
 /*!
-  Gets the error column start index from current error.
-  \return the error column start index
-  */
-int OMCProxy::getErrorColumnStart()
+ * \brief OMCProxy::invalidateCachedResponses
+ * Removes the cached responses of the class, its nested classes and of all the classes inheriting or using them.\n
+ * The dependencies may be recorded with relative class names so a dependency on any suffix of the class name is followed.
+ * This might invalidate a few unrelated classes but never misses a dependent class.
+ * \param className
+ */
+void OMCProxy::invalidateCachedResponses(QString className)
 {
-  sendCommand("currentError.info.columnStart");
-  return getResult().toInt();
+  QStringList classNames;
+  classNames.append(className);
+  foreach (QString cachedClassName, mCachedResponses.keys()) {
+    if (cachedClassName.startsWith(className + ".")) {
+      classNames.append(cachedClassName);
+    }
+  }
+  QSet<QString> invalidatedClassNames;
+  while (!classNames.isEmpty()) {
+    QString name = classNames.takeFirst();
+    if (invalidatedClassNames.contains(name)) {
+      continue;
+    }
+    invalidatedClassNames.insert(name);
+    mCachedResponses.remove(name);
+    QHash<QString, QSet<QString> >::const_iterator iterator;
+    for (iterator = mCachedResponsesDependents.constBegin() ; iterator != mCachedResponsesDependents.constEnd() ; ++iterator) {
+      if (name.compare(iterator.key()) == 0 || name.endsWith("." + iterator.key())) {
+        classNames.append(iterator.value().toList());
+      }
+    }
+  }
 }
 
 /*!
-  Gets the error line end index from current error.
-  \return the error line end index
-  */
-int OMCProxy::getErrorLineEnd()
+ * \brief OMCProxy::clearCachedResponses
+ * Removes all the cached responses. Used when we can't tell which classes are modified.
+ */
+void OMCProxy::clearCachedResponses()
 {
-  sendCommand("currentError.info.lineEnd");
-  return getResult().toInt();
+  mCachedResponses.clear();
+  mCachedResponsesDependents.clear();
 }
 
 /*!
-  Gets the error column end index from current error.
-  \return the error column end index
-  */
-int OMCProxy::getErrorColumnEnd()
+ * \brief OMCProxy::getErrorString
+ * Returns the OMC error string.\n
+ * \param warningsAsErrors
+ * \return the error string.
+ * \deprecated Use printMessagesStringInternal(). Now used where we want to consume the error message without showing it to user.
+ */
+QString OMCProxy::getErrorString(bool warningsAsErrors)
 {
-  sendCommand("currentError.info.columnEnd");
-  return getResult().toInt();
+  return callOMCInterface(&OMCInterface::getErrorString, warningsAsErrors);
 }
 
 /*!
-  Gets the error message from current error.
-  \return the error message
+  Gets the errors by using the getMessagesStringInternal API.
+  Reads all the errors and add them to the Messages Window.
+  \see MessagesWidget::addGUIMessage
+  \return true if there are any errors otherwise false.'
   */
-QString OMCProxy::getErrorMessage()
+bool OMCProxy::printMessagesStringInternal()
 {
-  sendCommand("currentError.message");
-  return StringHandler::unparse(getResult());
+  QList<MessageItem> messageItems = getMessagesStringInternal();
+  /* Loop in reverse order since getMessagesStringInternal returns error messages in reverse order. */
+  for (int i = messageItems.size() - 1 ; i >= 0 ; i--) {
+    MessagesWidget::instance()->addGUIMessage(messageItems.at(i));
+  }
+  return !messageItems.isEmpty();
 }
 
 /*!
-  Gets the error kind from current error.
-  \return the error kind
-  */
-QString OMCProxy::getErrorKind()
+ * \brief OMCProxy::getMessagesStringInternal
+ * Retrieves all the pending errors from OMC with a single call.
+ * \return the list of errors in the order returned by OMC i.e., the most recent first.
+ */
+QList<MessageItem> OMCProxy::getMessagesStringInternal()
 {
-  sendCommand("currentError.kind");
-  return getResult();
+  sendCommand("getMessagesStringInternal()");
+  return parseMessagesStringInternal(getResult());
 }
 
 /*!
-  Gets the error level from current error.
-  \return the error level
-  */
-QString OMCProxy::getErrorLevel()
+ * \brief OMCProxy::parseMessagesStringInternal
+ * Parses the array of OpenModelica.Scripting.ErrorMessage records returned by getMessagesStringInternal().\n
+ * Each record is printed as,\n
+ * record OpenModelica.Scripting.ErrorMessage\n
+ *     info = record OpenModelica.Scripting.SourceInfo\n
+ *     filename = "", readonly = false, lineStart = 0, columnStart = 0, lineEnd = 0, columnEnd = 0\n
+ * end OpenModelica.Scripting.SourceInfo;, message = "", kind = .., level = .., id = ..\n
+ * end OpenModelica.Scripting.ErrorMessage;
+ * \param messages
+ * \return
+ */
+QList<MessageItem> OMCProxy::parseMessagesStringInternal(const QString &messages)
 {
-  sendCommand("currentError.level");
-  return getResult();
+  QList<MessageItem> messageItems;
+  QHash<QString, QString> fields;
+  int length = messages.length();
+  int i = 0;
+  while (i < length) {
+    QChar c = messages.at(i);
+    if (c.isSpace() || c == '{' || c == '}' || c == ',' || c == ';') {
+      i++;
+      continue;
+    }
+    // read the word
+    int start = i;
+    while (i < length && !messages.at(i).isSpace() && messages.at(i) != '=' && messages.at(i) != ';' && messages.at(i) != ',') {
+      i++;
+    }
+    QString word = messages.mid(start, i - start);
+    if (word.compare("record") == 0) {
+      // skip the record name
+      while (i < length && messages.at(i) != '\n') {
+        i++;
+      }
+    } else if (word.compare("end") == 0) {
+      start = i;
+      while (i < length && messages.at(i) != ';') {
+        i++;
+      }
+      if (messages.mid(start, i - start).trimmed().compare("OpenModelica.Scripting.ErrorMessage") == 0) {
+        QString fileName = fields.value("filename");
+        if (fileName.compare("<interactive>") == 0) {
+          fileName = "";
+        }
+        messageItems.append(MessageItem(MessageItem::Modelica, fileName, StringHandler::unparseBool(fields.value("readonly")),
+                                        fields.value("lineStart").toInt(), fields.value("columnStart").toInt(), fields.value("lineEnd").toInt(),
+                                        fields.value("columnEnd").toInt(), fields.value("message"), fields.value("kind"), fields.value("level")));
+        fields.clear();
+      }
+    } else {
+      // read the field value
+      while (i < length && (messages.at(i).isSpace() || messages.at(i) == '=')) {
+        i++;
+      }
+      if (i < length && messages.at(i) == '"') {
+        start = i++;
+        while (i < length && messages.at(i) != '"') {
+          if (messages.at(i) == '\\') {
+            i++;
+          }
+          i++;
+        }
+        i++;
+        fields.insert(word, StringHandler::unparse(messages.mid(start, i - start)));
+      } else if (messages.mid(i, 7).compare("record ") != 0) { // nested records are read by the next iteration
+        start = i;
+        while (i < length && messages.at(i) != ',' && messages.at(i) != '\n') {
+          i++;
+        }
+        fields.insert(word, messages.mid(start, i - start).trimmed());
+      }
+    }
+  }
+  return messageItems;
 }
 
 /*!
@@ -593,7 +881,7 @@ QString OMCProxy::getErrorLevel()
   */
 QString OMCProxy::getVersion(QString className)
 {
-  return mpOMCInterface->getVersion(className);
+  return callOMCInterface(&OMCInterface::getVersion, className);
 }
 
 /*!
@@ -708,7 +996,7 @@ void OMCProxy::loadUserLibraries()
 QStringList OMCProxy::getClassNames(QString className, bool recursive, bool qualified, bool sort, bool builtin, bool showProtected,
                                     bool includeConstants)
 {
-  return mpOMCInterface->getClassNames(className, recursive, qualified, sort, builtin, showProtected, includeConstants);
+  return callOMCInterface(&OMCInterface::getClassNames, className, recursive, qualified, sort, builtin, showProtected, includeConstants);
 }
 
 /*!
@@ -719,7 +1007,7 @@ QStringList OMCProxy::getClassNames(QString className, bool recursive, bool qual
   */
 QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
 {
-  return mpOMCInterface->searchClassNames(searchText, findInText);
+  return callOMCInterface(&OMCInterface::searchClassNames, searchText, findInText);
 }
 
 /*!
@@ -729,7 +1017,7 @@ QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
   */
 OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString className)
 {
-  OMCInterface::getClassInformation_res classInformation = mpOMCInterface->getClassInformation(className);
+  OMCInterface::getClassInformation_res classInformation = callOMCInterface(&OMCInterface::getClassInformation, className);
   QString comment = classInformation.comment.replace("\\\"", "\"");
   comment = makeDocumentationUriToFileName(comment);
   // since tooltips can't handle file:// scheme so we have to remove it in order to display images and make links work.
@@ -749,7 +1037,7 @@ OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString clas
   */
 bool OMCProxy::isPackage(QString className)
 {
-  return mpOMCInterface->isPackage(className);
+  return callOMCInterface(&OMCInterface::isPackage, className);
 }
 
 /*!
@@ -774,7 +1062,7 @@ bool OMCProxy::isBuiltinType(QString typeName)
 QString OMCProxy::getBuiltinType(QString typeName)
 {
   QString result = "";
-  result = mpOMCInterface->getBuiltinType(typeName);
+  result = callOMCInterface(&OMCInterface::getBuiltinType, typeName);
   getErrorString();
   return result;
 }
@@ -790,43 +1078,43 @@ bool OMCProxy::isWhat(StringHandler::ModelicaClasses type, QString className)
   bool result = false;
   switch (type) {
     case StringHandler::Model:
-      result = mpOMCInterface->isModel(className);
+      result = callOMCInterface(&OMCInterface::isModel, className);
       break;
     case StringHandler::Class:
-      result = mpOMCInterface->isClass(className);
+      result = callOMCInterface(&OMCInterface::isClass, className);
       break;
     case StringHandler::Connector:
-      result = mpOMCInterface->isConnector(className);
+      result = callOMCInterface(&OMCInterface::isConnector, className);
       break;
     case StringHandler::Record:
-      result = mpOMCInterface->isRecord(className);
+      result = callOMCInterface(&OMCInterface::isRecord, className);
       break;
     case StringHandler::Block:
-      result = mpOMCInterface->isBlock(className);
+      result = callOMCInterface(&OMCInterface::isBlock, className);
       break;
     case StringHandler::Function:
-      result = mpOMCInterface->isFunction(className);
+      result = callOMCInterface(&OMCInterface::isFunction, className);
       break;
     case StringHandler::Package:
-      result = mpOMCInterface->isPackage(className);
+      result = callOMCInterface(&OMCInterface::isPackage, className);
       break;
     case StringHandler::Type:
-      result = mpOMCInterface->isType(className);
+      result = callOMCInterface(&OMCInterface::isType, className);
       break;
     case StringHandler::Operator:
-      result = mpOMCInterface->isOperator(className);
+      result = callOMCInterface(&OMCInterface::isOperator, className);
       break;
     case StringHandler::OperatorRecord:
-      result = mpOMCInterface->isOperatorRecord(className);
+      result = callOMCInterface(&OMCInterface::isOperatorRecord, className);
       break;
     case StringHandler::OperatorFunction:
-      result = mpOMCInterface->isOperatorFunction(className);
+      result = callOMCInterface(&OMCInterface::isOperatorFunction, className);
       break;
     case StringHandler::Optimization:
-      result = mpOMCInterface->isOptimization(className);
+      result = callOMCInterface(&OMCInterface::isOptimization, className);
       break;
     case StringHandler::Enumeration:
-      result = mpOMCInterface->isEnumeration(className);
+      result = callOMCInterface(&OMCInterface::isEnumeration, className);
       break;
     default:
       result = false;
@@ -845,7 +1133,7 @@ bool OMCProxy::isProtectedClass(QString className, QString nestedClassName)
   if (className.isEmpty()) {
     return false;
   } else {
-    return mpOMCInterface->isProtectedClass(className, nestedClassName);
+    return callOMCInterface(&OMCInterface::isProtectedClass, className, nestedClassName);
   }
 }
 
@@ -856,7 +1144,7 @@ bool OMCProxy::isProtectedClass(QString className, QString nestedClassName)
   */
 bool OMCProxy::isPartial(QString className)
 {
-  return mpOMCInterface->isPartial(className);
+  return callOMCInterface(&OMCInterface::isPartial, className);
 }
 
 /*!
@@ -879,7 +1167,7 @@ bool OMCProxy::isReplaceable(QString parentClassName, QString className)
   */
 StringHandler::ModelicaClasses OMCProxy::getClassRestriction(QString className)
 {
-  QString result = mpOMCInterface->getClassRestriction(className);
+  QString result = callOMCInterface(&OMCInterface::getClassRestriction, className);
 
   if (result.toLower().contains("model"))
     return StringHandler::Model;
@@ -917,7 +1205,7 @@ StringHandler::ModelicaClasses OMCProxy::getClassRestriction(QString className)
   */
 QString OMCProxy::getParameterValue(QString className, QString parameter)
 {
-  return mpOMCInterface->getParameterValue(className, parameter);
+  return callOMCInterface(&OMCInterface::getParameterValue, className, parameter);
 }
 
 /*!
@@ -928,7 +1216,7 @@ QString OMCProxy::getParameterValue(QString className, QString parameter)
   */
 QStringList OMCProxy::getComponentModifierNames(QString className, QString name)
 {
-  return mpOMCInterface->getComponentModifierNames(className, name);
+  return callOMCInterface(&OMCInterface::getComponentModifierNames, className, name);
 }
 
 /*!
@@ -940,7 +1228,14 @@ QStringList OMCProxy::getComponentModifierNames(QString className, QString name)
  */
 QString OMCProxy::getComponentModifierValue(QString className, QString name)
 {
-  return mpOMCInterface->getComponentModifierValue(className, name);
+  QString command = "getComponentModifierValue(" + name + ")";
+  QVariant response;
+  if (getCachedResponse(className, command, &response)) {
+    return response.toString();
+  }
+  QString result = callOMCInterface(&OMCInterface::getComponentModifierValue, className, name);
+  cacheResponse(className, command, result);
+  return result;
 }
 
 /*!
@@ -960,6 +1255,7 @@ bool OMCProxy::setComponentModifierValue(QString className, QString modifierName
   } else {
     expression = QString("setComponentModifierValue(%1, %2, $Code(=%3))").arg(className).arg(modifierName).arg(modifierValue);
   }
+  invalidateCachedResponses(className);
   sendCommand(expression);
   if (getResult().toLower().compare("ok") == 0) {
     return true;
@@ -980,7 +1276,8 @@ bool OMCProxy::setComponentModifierValue(QString className, QString modifierName
  */
 bool OMCProxy::removeComponentModifiers(QString className, QString name)
 {
-  return mpOMCInterface->removeComponentModifiers(className, name, true);
+  invalidateCachedResponses(className);
+  return callOMCInterface(&OMCInterface::removeComponentModifiers, className, name, true);
 }
 
 /*!
@@ -992,7 +1289,7 @@ bool OMCProxy::removeComponentModifiers(QString className, QString name)
  */
 QString OMCProxy::getComponentModifierValues(QString className, QString name)
 {
-  return mpOMCInterface->getComponentModifierValues(className, name);
+  return callOMCInterface(&OMCInterface::getComponentModifierValues, className, name);
 }
 
 QStringList OMCProxy::getExtendsModifierNames(QString className, QString extendsClassName)
@@ -1026,6 +1323,7 @@ bool OMCProxy::setExtendsModifierValue(QString className, QString extendsClassNa
     expression = QString("setExtendsModifierValue(%1, %2, %3, $Code(=%4))").arg(className).arg(extendsClassName).arg(modifierName)
         .arg(modifierValue);
   }
+  invalidateCachedResponses(className);
   sendCommand(expression);
   if (getResult().toLower().compare("ok") == 0) {
     return true;
@@ -1059,7 +1357,8 @@ bool OMCProxy::isExtendsModifierFinal(QString className, QString extendsClassNam
  */
 bool OMCProxy::removeExtendsModifiers(QString className, QString extendsClassName)
 {
-  return mpOMCInterface->removeExtendsModifiers(className, extendsClassName, true);
+  invalidateCachedResponses(className);
+  return callOMCInterface(&OMCInterface::removeExtendsModifiers, className, extendsClassName, true);
 }
 
 /*!
@@ -1070,9 +1369,14 @@ bool OMCProxy::removeExtendsModifiers(QString className, QString extendsClassNam
 QString OMCProxy::getIconAnnotation(QString className)
 {
   QString expression = "getIconAnnotation(" + className + ")";
+  QVariant response;
+  if (getCachedResponse(className, expression, &response)) {
+    return response.toString();
+  }
   sendCommand(expression);
   QString result = getResult();
   printMessagesStringInternal();
+  cacheResponse(className, expression, result);
   return result;
 }
 
@@ -1084,9 +1388,14 @@ QString OMCProxy::getIconAnnotation(QString className)
 QString OMCProxy::getDiagramAnnotation(QString className)
 {
   QString expression = "getDiagramAnnotation(" + className + ")";
+  QVariant response;
+  if (getCachedResponse(className, expression, &response)) {
+    return response.toString();
+  }
   sendCommand(expression);
   QString result = getResult();
   printMessagesStringInternal();
+  cacheResponse(className, expression, result);
   return result;
 }
 
@@ -1121,7 +1430,7 @@ int OMCProxy::getConnectionCount(QString className)
  */
 QList<QString> OMCProxy::getNthConnection(QString className, int index)
 {
-  return mpOMCInterface->getNthConnection(className, index);
+  return callOMCInterface(&OMCInterface::getNthConnection, className, index);
 }
 
 /*!
@@ -1137,6 +1446,69 @@ QString OMCProxy::getNthConnectionAnnotation(QString className, int num)
   return getResult();
 }
 
+/*!
+ * \brief OMCProxy::getConnections
+ * Returns all the connections of a model with their annotations.\n
+ * getNthConnection is a builtin function so all the connections are fetched with one array expression whose result is a list of
+ * {from, to, comment} lists. getNthConnectionAnnotation belongs to the graphical API which can't be used inside expressions so the
+ * annotation commands are queued together and we wait only once for them.
+ * \param className - is the name of the model.
+ * \return the list of connections i.e, {from, to, comment, annotation}
+ */
+QList<QStringList> OMCProxy::getConnections(QString className)
+{
+  QString expression = "getConnections(" + className + ")";
+  QVariant response;
+  QStringList result;
+  // the response is cached as a flat list of {from, to, comment, annotation} items.
+  if (getCachedResponse(className, expression, &response)) {
+    result = response.toStringList();
+  } else {
+    sendCommand(QString("{getNthConnection(%1, i) for i in 1:getConnectionCount(%1)}").arg(className));
+    QString connectionsString = getResult().trimmed();
+    QList<QStringList> connectionsList;
+    if (connectionsString.startsWith("{") && connectionsString.endsWith("}")) {
+      foreach (QString connection, StringHandler::getCurlyBracketsGroups(StringHandler::removeFirstLastCurlBrackets(connectionsString))) {
+        connectionsList.append(StringHandler::unparseStrings(connection));
+      }
+    } else {
+      QString errorString = getErrorString();
+      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                            tr("Unable to fetch the connections of %1 in one call, fetching them one by one. %2")
+                                                            .arg(className).arg(errorString), Helper::scriptingKind, Helper::warningLevel));
+      int connectionCount = getConnectionCount(className);
+      for (int i = 1 ; i <= connectionCount ; i++) {
+        connectionsList.append(getNthConnection(className, i));
+      }
+    }
+    QList<OMCCommand*> commands;
+    for (int i = 1 ; i <= connectionsList.size() ; i++) {
+      OMCCommand *pOMCCommand = sendCommandAsync(QString("getNthConnectionAnnotation(%1, %2)").arg(className).arg(i));
+      if (pOMCCommand) {
+        pOMCCommand->setAutoDelete(false);
+      }
+      commands.append(pOMCCommand);
+    }
+    waitForCommands();
+    for (int i = 0 ; i < connectionsList.size() ; i++) {
+      QStringList connection = connectionsList.at(i);
+      // if the connection only contains two items then skip it, because connection is not valid then
+      if (connection.size() < 3) {
+        continue;
+      }
+      QString annotation = commands.at(i) ? commands.at(i)->getResult().trimmed() : QString();
+      result << connection.at(0) << connection.at(1) << connection.at(2) << annotation;
+    }
+    qDeleteAll(commands);
+    cacheResponse(className, expression, result);
+  }
+  QList<QStringList> connections;
+  for (int i = 0 ; i + 3 < result.size() ; i += 4) {
+    connections.append(result.mid(i, 4));
+  }
+  return connections;
+}
+
 /*!
  * \brief OMCProxy::getInheritanceCount
  * Returns the inheritance count of a model.
@@ -1186,8 +1558,18 @@ QString OMCProxy::getNthInheritedClass(QString className, int num)
  */
 QList<QString> OMCProxy::getInheritedClasses(QString className)
 {
-  QList<QString> result = mpOMCInterface->getInheritedClasses(className);
+  QString command = "getInheritedClasses(" + className + ")";
+  QVariant response;
+  if (getCachedResponse(className, command, &response)) {
+    return response.toStringList();
+  }
+  QList<QString> result = callOMCInterface(&OMCInterface::getInheritedClasses, className);
   printMessagesStringInternal();
+  cacheResponse(className, command, QStringList(result));
+  // the class must be invalidated whenever one of its base classes is modified.
+  foreach (QString inheritedClass, result) {
+    addCachedResponsesDependency(inheritedClass, className);
+  }
   return result;
 }
 
@@ -1201,8 +1583,16 @@ QList<QString> OMCProxy::getInheritedClasses(QString className)
 QList<ComponentInfo*> OMCProxy::getComponents(QString className)
 {
   QString expression = "getComponents(" + className + ", useQuotes = true)";
-  sendCommand(expression);
-  QString result = getResult();
+  QVariant response;
+  QString result;
+  // cache the response instead of the ComponentInfo objects since the caller takes the ownership of the list.
+  if (getCachedResponse(className, expression, &response)) {
+    result = response.toString();
+  } else {
+    sendCommand(expression);
+    result = getResult();
+    cacheResponse(className, expression, result);
+  }
   QList<ComponentInfo*> componentInfoList;
   QStringList list = StringHandler::unparseArrays(result);
 
@@ -1213,6 +1603,8 @@ QList<ComponentInfo*> OMCProxy::getComponents(QString className)
     ComponentInfo *pComponentInfo = new ComponentInfo();
     pComponentInfo->parseComponentInfoString(list.at(i));
     componentInfoList.append(pComponentInfo);
+    // the class must be invalidated whenever the class of one of its components is modified.
+    addCachedResponsesDependency(pComponentInfo->getClassName(), className);
   }
 
   return componentInfoList;
@@ -1226,14 +1618,20 @@ QList<ComponentInfo*> OMCProxy::getComponents(QString className)
 QStringList OMCProxy::getComponentAnnotations(QString className)
 {
   QString expression = "getComponentAnnotations(" + className + ")";
+  QVariant response;
+  if (getCachedResponse(className, expression, &response)) {
+    return response.toStringList();
+  }
   sendCommand(expression);
-  return StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
+  QStringList result = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
+  cacheResponse(className, expression, result);
+  return result;
 }
 
 QString OMCProxy::getDocumentationAnnotationInfoHeader(LibraryTreeItem *pLibraryTreeItem, QString infoHeader)
 {
   if (pLibraryTreeItem && !pLibraryTreeItem->isRootItem()) {
-    QList<QString> docsList = mpOMCInterface->getDocumentationAnnotation(pLibraryTreeItem->getNameStructure());
+    QList<QString> docsList = getDocumentationAnnotationInClass(pLibraryTreeItem);
     infoHeader.prepend(docsList.at(2)); // __OpenModelica_infoHeader section is the 3rd item in the list
     return getDocumentationAnnotationInfoHeader(pLibraryTreeItem->parent(), infoHeader);
   } else {
@@ -1250,7 +1648,7 @@ QString OMCProxy::getDocumentationAnnotationInfoHeader(LibraryTreeItem *pLibrary
  */
 QString OMCProxy::getDocumentationAnnotation(LibraryTreeItem *pLibraryTreeItem)
 {
-  QList<QString> docsList = mpOMCInterface->getDocumentationAnnotation(pLibraryTreeItem->getNameStructure());
+  QList<QString> docsList = getDocumentationAnnotationInClass(pLibraryTreeItem);
   QString infoHeader = "";
   infoHeader = getDocumentationAnnotationInfoHeader(pLibraryTreeItem->parent(), infoHeader);
   // get the class comment and show it as the first line on the documentation page.
@@ -1337,7 +1735,15 @@ QString OMCProxy::getDocumentationAnnotation(LibraryTreeItem *pLibraryTreeItem)
  */
 QList<QString> OMCProxy::getDocumentationAnnotationInClass(LibraryTreeItem *pLibraryTreeItem)
 {
-  return mpOMCInterface->getDocumentationAnnotation(pLibraryTreeItem->getNameStructure());
+  QString className = pLibraryTreeItem->getNameStructure();
+  QString command = "getDocumentationAnnotation(" + className + ")";
+  QVariant response;
+  if (getCachedResponse(className, command, &response)) {
+    return response.toStringList();
+  }
+  QList<QString> result = callOMCInterface(&OMCInterface::getDocumentationAnnotation, className);
+  cacheResponse(className, command, QStringList(result));
+  return result;
 }
 
 /*!
@@ -1350,7 +1756,7 @@ QList<QString> OMCProxy::getDocumentationAnnotationInClass(LibraryTreeItem *pLib
  */
 QString OMCProxy::getClassComment(QString className)
 {
-  return mpOMCInterface->getClassComment(className);
+  return callOMCInterface(&OMCInterface::getClassComment, className);
 }
 
 /*!
@@ -1360,7 +1766,7 @@ QString OMCProxy::getClassComment(QString className)
   */
 QString OMCProxy::changeDirectory(QString directory)
 {
-  return mpOMCInterface->cd(directory);
+  return callOMCInterface(&OMCInterface::cd, directory);
 }
 
 /*!
@@ -1371,14 +1777,25 @@ QString OMCProxy::changeDirectory(QString directory)
   */
 bool OMCProxy::loadModel(QString className, QString priorityVersion, bool notify, QString languageStandard, bool requireExactVersion)
 {
-  bool result = false;
-  QList<QString> priorityVersionList;
-  priorityVersionList << priorityVersion;
-  result = mpOMCInterface->loadModel(className, priorityVersionList, notify, languageStandard, requireExactVersion);
+  waitForResult(loadModelAsync(className, priorityVersion, notify, languageStandard, requireExactVersion));
+  bool result = StringHandler::unparseBool(getResult());
   printMessagesStringInternal();
   return result;
 }
 
+/*!
+ * \brief OMCProxy::loadModelAsync
+ * Sends the loadModel command without waiting for it.\n
+ * The result of the finished command is the unparsed loadModel result.
+ * \sa OMCProxy::loadModel()
+ */
+OMCCommand* OMCProxy::loadModelAsync(QString className, QString priorityVersion, bool notify, QString languageStandard, bool requireExactVersion)
+{
+  invalidateCachedResponses(className);
+  return sendCommandAsync(QString("loadModel(%1, {\"%2\"}, %3, \"%4\", %5)").arg(className).arg(priorityVersion).arg(notify ? "true" : "false")
+                          .arg(languageStandard).arg(requireExactVersion ? "true" : "false"));
+}
+
 /*!
   Loads a file in OMC
   \param fileName - the file to load.
@@ -1386,13 +1803,27 @@ bool OMCProxy::loadModel(QString className, QString priorityVersion, bool notify
   */
 bool OMCProxy::loadFile(QString fileName, QString encoding, bool uses)
 {
-  bool result = false;
-  fileName = fileName.replace('\\', '/');
-  result = mpOMCInterface->loadFile(fileName, encoding, uses);
+  waitForResult(loadFileAsync(fileName, encoding, uses));
+  bool result = StringHandler::unparseBool(getResult());
   printMessagesStringInternal();
   return result;
 }
 
+/*!
+ * \brief OMCProxy::loadFileAsync
+ * Sends the loadFile command without waiting for it.\n
+ * The result of the finished command is the unparsed loadFile result.
+ * \sa OMCProxy::loadFile()
+ */
+OMCCommand* OMCProxy::loadFileAsync(QString fileName, QString encoding, bool uses)
+{
+  fileName = fileName.replace('\\', '/');
+  // we don't know which classes the file contains.
+  clearCachedResponses();
+  return sendCommandAsync(QString("loadFile(\"%1\", \"%2\", %3)").arg(StringHandler::escapeString(fileName)).arg(encoding)
+                          .arg(uses ? "true" : "false"));
+}
+
 /*!
  * \brief OMCProxy::loadString
  * Loads a string in OMC
@@ -1405,7 +1836,9 @@ bool OMCProxy::loadFile(QString fileName, QString encoding, bool uses)
  */
 bool OMCProxy::loadString(QString value, QString fileName, QString encoding, bool merge, bool checkError)
 {
-  bool result = mpOMCInterface->loadString(value, fileName, encoding, merge);
+  // the text can modify anything the other classes depend on e.g., the constants used in their annotations.
+  clearCachedResponses();
+  bool result = callOMCInterface(&OMCInterface::loadString, value, fileName, encoding, merge);
   if (checkError) {
     printMessagesStringInternal();
   }
@@ -1421,7 +1854,7 @@ QList<QString> OMCProxy::parseFile(QString fileName, QString encoding)
 {
   QList<QString> result;
   fileName = fileName.replace('\\', '/');
-  result = mpOMCInterface->parseFile(fileName, encoding);
+  result = callOMCInterface(&OMCInterface::parseFile, fileName, encoding);
   if (result.isEmpty()) {
     printMessagesStringInternal();
   }
@@ -1436,7 +1869,7 @@ QList<QString> OMCProxy::parseFile(QString fileName, QString encoding)
 QList<QString> OMCProxy::parseString(QString value, QString fileName)
 {
   QList<QString> result;
-  result = mpOMCInterface->parseString(value, fileName);
+  result = callOMCInterface(&OMCInterface::parseString, value, fileName);
   printMessagesStringInternal();
   return result;
 }
@@ -1510,6 +1943,8 @@ bool OMCProxy::existClass(QString className)
   */
 bool OMCProxy::renameClass(QString oldName, QString newName)
 {
+  // renameClass also updates the references to the class in other classes.
+  clearCachedResponses();
   sendCommand("renameClass(" + oldName + ", " + newName + ")");
   if (StringHandler::unparseBool(getResult()))
     return false;
@@ -1524,6 +1959,7 @@ bool OMCProxy::renameClass(QString oldName, QString newName)
   */
 bool OMCProxy::deleteClass(QString className)
 {
+  invalidateCachedResponses(className);
   sendCommand("deleteClass(" + className + ")");
   if (StringHandler::unparseBool(getResult()))
     return true;
@@ -1539,7 +1975,7 @@ bool OMCProxy::deleteClass(QString className)
  */
 QString OMCProxy::getSourceFile(QString className)
 {
-  QString file = mpOMCInterface->getSourceFile(className);
+  QString file = callOMCInterface(&OMCInterface::getSourceFile, className);
   if (file.compare("<interactive>") == 0) {
     return "";
   } else {
@@ -1556,7 +1992,7 @@ QString OMCProxy::getSourceFile(QString className)
  */
 bool OMCProxy::setSourceFile(QString className, QString path)
 {
-  return mpOMCInterface->setSourceFile(className, path);
+  return callOMCInterface(&OMCInterface::setSourceFile, className, path);
 }
 
 /*!
@@ -1568,6 +2004,7 @@ bool OMCProxy::setSourceFile(QString className, QString path)
  */
 bool OMCProxy::save(QString className)
 {
+  invalidateCachedResponses(className);
   sendCommand("save(" + className + ")");
   bool result = StringHandler::unparseBool(getResult());
   if (!result) {
@@ -1578,6 +2015,8 @@ bool OMCProxy::save(QString className)
 
 bool OMCProxy::saveModifiedModel(QString modelText)
 {
+  // the text can modify anything the other classes depend on e.g., the constants used in their annotations.
+  clearCachedResponses();
   sendCommand(modelText);
   if (getResult().toLower().contains("error"))
     return false;
@@ -1594,7 +2033,7 @@ bool OMCProxy::saveModifiedModel(QString modelText)
  */
 bool OMCProxy::saveTotalModel(QString fileName, QString className)
 {
-  bool result = mpOMCInterface->saveTotalModel(fileName, className);
+  bool result = callOMCInterface(&OMCInterface::saveTotalModel, fileName, className);
   if (!result) {
     printMessagesStringInternal();
   }
@@ -1624,7 +2063,7 @@ QString OMCProxy::list(QString className)
  */
 QString OMCProxy::listFile(QString className)
 {
-  QString result = mpOMCInterface->listFile(className);
+  QString result = callOMCInterface(&OMCInterface::listFile, className);
   printMessagesStringInternal();
   return result;
 }
@@ -1669,6 +2108,7 @@ QString OMCProxy::diffModelicaFileListings(QString before, QString after)
  */
 bool OMCProxy::addClassAnnotation(QString className, QString annotation)
 {
+  invalidateCachedResponses(className);
   sendCommand("addClassAnnotation(" + className + ", " + annotation + ")");
   if (StringHandler::unparseBool(getResult())) {
     return true;
@@ -1716,6 +2156,7 @@ QString OMCProxy::getDefaultComponentPrefixes(QString className)
   */
 bool OMCProxy::addComponent(QString name, QString className, QString componentName, QString placementAnnotation)
 {
+  invalidateCachedResponses(componentName);
   sendCommand("addComponent(" + name + ", " + className + "," + componentName + "," + placementAnnotation + ")");
   if (StringHandler::unparseBool(getResult()))
     return true;
@@ -1731,6 +2172,7 @@ bool OMCProxy::addComponent(QString name, QString className, QString componentNa
   */
 bool OMCProxy::deleteComponent(QString name, QString componentName)
 {
+  invalidateCachedResponses(componentName);
   sendCommand("deleteComponent(" + name + "," + componentName + ")");
   if (StringHandler::unparseBool(getResult()))
     return true;
@@ -1749,6 +2191,7 @@ bool OMCProxy::deleteComponent(QString name, QString componentName)
   */
 bool OMCProxy::renameComponent(QString className, QString oldName, QString newName)
 {
+  invalidateCachedResponses(className);
   sendCommand("renameComponent(" + className + "," + oldName + "," + newName + ")");
   if (getResult().toLower().contains("error"))
     return false;
@@ -1766,6 +2209,7 @@ bool OMCProxy::renameComponent(QString className, QString oldName, QString newNa
   */
 bool OMCProxy::updateComponent(QString name, QString className, QString componentName, QString placementAnnotation)
 {
+  invalidateCachedResponses(componentName);
   sendCommand("updateComponent(" + name + "," + className + "," + componentName + "," + placementAnnotation + ")");
   if (StringHandler::unparseBool(getResult()))
     return true;
@@ -1783,6 +2227,7 @@ bool OMCProxy::updateComponent(QString name, QString className, QString componen
   */
 bool OMCProxy::renameComponentInClass(QString className, QString oldName, QString newName)
 {
+  invalidateCachedResponses(className);
   sendCommand("renameComponentInClass(" + className + "," + oldName + "," + newName + ")");
   if (getResult().toLower().contains("error"))
     return false;
@@ -1800,6 +2245,7 @@ bool OMCProxy::renameComponentInClass(QString className, QString oldName, QStrin
   */
 bool OMCProxy::updateConnection(QString from, QString to, QString className, QString annotation)
 {
+  invalidateCachedResponses(className);
   sendCommand("updateConnection(" + from + "," + to + "," + className + "," + annotation + ")");
   if (getResult().toLower().compare("ok") == 0) {
     return true;
@@ -1825,6 +2271,7 @@ bool OMCProxy::updateConnection(QString from, QString to, QString className, QSt
 bool OMCProxy::setComponentProperties(QString className, QString componentName, QString isFinal, QString isFlow, QString isProtected,
                                       QString isReplaceAble, QString variability, QString isInner, QString isOuter, QString causality)
 {
+  invalidateCachedResponses(className);
   sendCommand("setComponentProperties(" + className + "," + componentName + ",{" + isFinal + "," + isFlow + "," + isProtected +
               "," + isReplaceAble + "}, {\"" + variability + "\"}, {" + isInner + "," + isOuter + "}, {\"" + causality + "\"})");
 
@@ -1843,6 +2290,7 @@ bool OMCProxy::setComponentProperties(QString className, QString componentName,
   */
 bool OMCProxy::setComponentComment(QString className, QString componentName, QString comment)
 {
+  invalidateCachedResponses(className);
   sendCommand("setComponentComment(" + className + "," + componentName + ",\"" + comment + "\")");
   if (getResult().toLower().contains("error"))
     return false;
@@ -1860,6 +2308,7 @@ bool OMCProxy::setComponentComment(QString className, QString componentName, QSt
  */
 bool OMCProxy::setComponentDimensions(QString className, QString componentName, QString dimensions)
 {
+  invalidateCachedResponses(className);
   sendCommand("setComponentDimensions(" + className + "," + componentName + "," + dimensions + ")");
   if (getResult().toLower().compare("ok") == 0) {
     return true;
@@ -1878,6 +2327,7 @@ bool OMCProxy::setComponentDimensions(QString className, QString componentName,
  */
 bool OMCProxy::addConnection(QString from, QString to, QString className, QString annotation)
 {
+  invalidateCachedResponses(className);
   if (annotation.compare("annotate=Line()") == 0) {
     sendCommand("addConnection(" + from + "," + to + "," + className + ")");
   } else {
@@ -1899,6 +2349,7 @@ bool OMCProxy::addConnection(QString from, QString to, QString className, QStrin
   */
 bool OMCProxy::deleteConnection(QString from, QString to, QString className)
 {
+  invalidateCachedResponses(className);
   sendCommand("deleteConnection(" + from + "," + to + "," + className + ")");
   if (getResult().toLower().compare("ok") == 0) {
     return true;
@@ -1965,7 +2416,7 @@ bool OMCProxy::translateModel(QString className, QString simualtionParameters)
  */
 QStringList OMCProxy::readSimulationResultVars(QString fileName)
 {
-  QStringList variablesList = mpOMCInterface->readSimulationResultVars(fileName, true, false);
+  QStringList variablesList = callOMCInterface(&OMCInterface::readSimulationResultVars, fileName, true, false);
   qSort(variablesList.begin(), variablesList.end());
   printMessagesStringInternal();
   return variablesList;
@@ -1981,7 +2432,7 @@ QStringList OMCProxy::readSimulationResultVars(QString fileName)
 bool OMCProxy::closeSimulationResultFile()
 {
 #ifdef Q_OS_WIN
-  return mpOMCInterface->closeSimulationResultFile();
+  return callOMCInterface(&OMCInterface::closeSimulationResultFile);
 #else
   return true;
 #endif
@@ -1995,12 +2446,25 @@ bool OMCProxy::closeSimulationResultFile()
  */
 QString OMCProxy::checkModel(QString className)
 {
-  QString result = mpOMCInterface->checkModel(className);
+  waitForResult(checkModelAsync(className));
+  QString result = StringHandler::unparse(getResult());
   printMessagesStringInternal();
   MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   return result;
 }
 
+/*!
+ * \brief OMCProxy::checkModelAsync
+ * Sends the checkModel command without waiting for it.
+ * \param className - the name of the class.
+ * \return the command handle.
+ * \sa OMCProxy::checkModel()
+ */
+OMCCommand* OMCProxy::checkModelAsync(QString className)
+{
+  return sendCommandAsync("checkModel(" + className + ")");
+}
+
 /*!
   Converts a given ngspice netlist to equivalent Modelica code.
   Filename is the name of the ngspice netlist. Subcircuit and device model (.lib) files
@@ -2022,12 +2486,25 @@ bool OMCProxy::ngspicetoModelica(QString fileName)
  */
 QString OMCProxy::checkAllModelsRecursive(QString className)
 {
-  QString result = mpOMCInterface->checkAllModelsRecursive(className, false);
+  waitForResult(checkAllModelsRecursiveAsync(className));
+  QString result = StringHandler::unparse(getResult());
   printMessagesStringInternal();
   MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   return result;
 }
 
+/*!
+ * \brief OMCProxy::checkAllModelsRecursiveAsync
+ * Sends the checkAllModelsRecursive command without waiting for it.
+ * \param className - the name of the class.
+ * \return the command handle.
+ * \sa OMCProxy::checkAllModelsRecursive()
+ */
+OMCCommand* OMCProxy::checkAllModelsRecursiveAsync(QString className)
+{
+  return sendCommandAsync("checkAllModelsRecursive(" + className + ", false)");
+}
+
 /*!
  * \brief OMCProxy::instantiateModel
  * Instantiates the model.
@@ -2036,12 +2513,25 @@ QString OMCProxy::checkAllModelsRecursive(QString className)
  */
 QString OMCProxy::instantiateModel(QString className)
 {
-  QString result = mpOMCInterface->instantiateModel(className);
+  waitForResult(instantiateModelAsync(className));
+  QString result = StringHandler::unparse(getResult());
   printMessagesStringInternal();
   MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   return result;
 }
 
+/*!
+ * \brief OMCProxy::instantiateModelAsync
+ * Sends the instantiateModel command without waiting for it.
+ * \param className - the name of the class.
+ * \return the command handle.
+ * \sa OMCProxy::instantiateModel()
+ */
+OMCCommand* OMCProxy::instantiateModelAsync(QString className)
+{
+  return sendCommandAsync("instantiateModel(" + className + ")");
+}
+
 /*!
  * \brief OMCProxy::isExperiment
  * Returns the simulation options stored in the model.
@@ -2050,7 +2540,7 @@ QString OMCProxy::instantiateModel(QString className)
  */
 bool OMCProxy::isExperiment(QString className)
 {
-  return mpOMCInterface->isExperiment(className);
+  return callOMCInterface(&OMCInterface::isExperiment, className);
 }
 
 /*!
@@ -2062,7 +2552,7 @@ bool OMCProxy::isExperiment(QString className)
  */
 OMCInterface::getSimulationOptions_res OMCProxy::getSimulationOptions(QString className, double defaultTolerance)
 {
-  return mpOMCInterface->getSimulationOptions(className, 0.0, 1.0, defaultTolerance, 500, 0.0);
+  return callOMCInterface(&OMCInterface::getSimulationOptions, className, 0.0, 1.0, defaultTolerance, 500, 0.0);
 }
 
 /*!
@@ -2078,7 +2568,7 @@ OMCInterface::getSimulationOptions_res OMCProxy::getSimulationOptions(QString cl
 QString OMCProxy::buildModelFMU(QString className, double version, QString type, QString fileNamePrefix, QList<QString> platforms, bool includeResources)
 {
   fileNamePrefix = fileNamePrefix.isEmpty() ? "<default>" : fileNamePrefix;
-  QString fmuFileName = mpOMCInterface->buildModelFMU(className, QString::number(version), type, fileNamePrefix, platforms, includeResources);
+  QString fmuFileName = callOMCInterface(&OMCInterface::buildModelFMU, className, QString::number(version), type, fileNamePrefix, platforms, includeResources);
   if (!fmuFileName.isEmpty()) {
     MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   }
@@ -2118,7 +2608,7 @@ QString OMCProxy::importFMU(QString fmuName, QString outputDirectory, int logLev
                             bool generateOutputConnectors)
 {
   outputDirectory = outputDirectory.isEmpty() ? "<default>" : outputDirectory;
-  QString fmuFileName = mpOMCInterface->importFMU(fmuName, outputDirectory, logLevel, true, debugLogging, generateInputConnectors,
+  QString fmuFileName = callOMCInterface(&OMCInterface::importFMU, fmuName, outputDirectory, logLevel, true, debugLogging, generateInputConnectors,
                                                   generateOutputConnectors);
   printMessagesStringInternal();
   return fmuFileName;
@@ -2139,7 +2629,7 @@ QString OMCProxy::importFMUModelDescription(QString fmuModelDescriptionName, QSt
                             bool generateOutputConnectors)
 {
   outputDirectory = outputDirectory.isEmpty() ? "<default>" : outputDirectory;
-  QString fmuFileName = mpOMCInterface->importFMUModelDescription(fmuModelDescriptionName, outputDirectory, logLevel, true, debugLogging, generateInputConnectors,
+  QString fmuFileName = callOMCInterface(&OMCInterface::importFMUModelDescription, fmuModelDescriptionName, outputDirectory, logLevel, true, debugLogging, generateInputConnectors,
                                                   generateOutputConnectors);
   printMessagesStringInternal();
   return fmuFileName;
@@ -2151,7 +2641,7 @@ QString OMCProxy::importFMUModelDescription(QString fmuModelDescriptionName, QSt
   */
 QString OMCProxy::getMatchingAlgorithm()
 {
-  return mpOMCInterface->getMatchingAlgorithm();
+  return callOMCInterface(&OMCInterface::getMatchingAlgorithm);
 }
 
 /*!
@@ -2161,7 +2651,7 @@ QString OMCProxy::getMatchingAlgorithm()
  */
 OMCInterface::getAvailableMatchingAlgorithms_res OMCProxy::getAvailableMatchingAlgorithms()
 {
-  return mpOMCInterface->getAvailableMatchingAlgorithms();
+  return callOMCInterface(&OMCInterface::getAvailableMatchingAlgorithms);
 }
 
 /*!
@@ -2171,7 +2661,7 @@ OMCInterface::getAvailableMatchingAlgorithms_res OMCProxy::getAvailableMatchingA
  */
 QString OMCProxy::getIndexReductionMethod()
 {
-  return mpOMCInterface->getIndexReductionMethod();
+  return callOMCInterface(&OMCInterface::getIndexReductionMethod);
 }
 
 /*!
@@ -2197,7 +2687,7 @@ bool OMCProxy::setMatchingAlgorithm(QString matchingAlgorithm)
  */
 OMCInterface::getAvailableIndexReductionMethods_res OMCProxy::getAvailableIndexReductionMethods()
 {
-  return mpOMCInterface->getAvailableIndexReductionMethods();
+  return callOMCInterface(&OMCInterface::getAvailableIndexReductionMethods);
 }
 
 /*!
@@ -2225,7 +2715,7 @@ bool OMCProxy::setIndexReductionMethod(QString method)
  */
 bool OMCProxy::setCommandLineOptions(QString options)
 {
-  bool result = mpOMCInterface->setCommandLineOptions(options);
+  bool result = callOMCInterface(&OMCInterface::setCommandLineOptions, options);
   if (!result) {
     printMessagesStringInternal();
   }
@@ -2239,7 +2729,7 @@ bool OMCProxy::setCommandLineOptions(QString options)
  */
 bool OMCProxy::clearCommandLineOptions()
 {
-  bool result = mpOMCInterface->clearCommandLineOptions();
+  bool result = callOMCInterface(&OMCInterface::clearCommandLineOptions);
   if (result) {
     return true;
   } else {
@@ -2332,7 +2822,7 @@ QString OMCProxy::uriToFilename(QString uri)
  */
 QString OMCProxy::getModelicaPath()
 {
-  QString result = mpOMCInterface->getModelicaPath();
+  QString result = callOMCInterface(&OMCInterface::getModelicaPath);
   printMessagesStringInternal();
   return result;
 }
@@ -2344,7 +2834,7 @@ QString OMCProxy::getModelicaPath()
  */
 QStringList OMCProxy::getAvailableLibraries()
 {
-  return mpOMCInterface->getAvailableLibraries();
+  return callOMCInterface(&OMCInterface::getAvailableLibraries);
 }
 
 /*!
@@ -2356,30 +2846,53 @@ QStringList OMCProxy::getAvailableLibraries()
  */
 QString OMCProxy::getDerivedClassModifierValue(QString className, QString modifierName)
 {
-  return mpOMCInterface->getDerivedClassModifierValue(className, modifierName);
+  return callOMCInterface(&OMCInterface::getDerivedClassModifierValue, className, modifierName);
 }
 
 /*!
  * \brief OMCProxy::convertUnits
  * Returns the scale factor and offset used when converting two units.\n
  * Returns false if the types are not compatible and should not be converted.
+ * The units are converted locally using UnitConverter. OMC is only asked for the units UnitConverter can't convert.
+ * In debug mode OMC is always asked and the UnitConverter result is compared with it.
  * \param from
  * \param to
  * \return
  */
 OMCInterface::convertUnits_res OMCProxy::convertUnits(QString from, QString to)
 {
-  foreach (UnitConverion unitConversion, mUnitConversionList) {
-    if ((unitConversion.mFromUnit.compare(from) == 0) && (unitConversion.mToUnit.compare(to) == 0)) {
-      return unitConversion.mConvertUnits;
-    }
-  }
-  OMCInterface::convertUnits_res convertUnits_res = mpOMCInterface->convertUnits(from, to);
-  UnitConverion unitConverion;
-  unitConverion.mFromUnit = from;
-  unitConverion.mToUnit = to;
-  unitConverion.mConvertUnits = convertUnits_res;
-  mUnitConversionList.append(unitConverion);
+  QPair<QString, QString> units = qMakePair(from, to);
+  QHash<QPair<QString, QString>, OMCInterface::convertUnits_res>::const_iterator unitConversion = mUnitConversionHash.constFind(units);
+  if (unitConversion != mUnitConversionHash.constEnd()) {
+    return unitConversion.value();
+  }
+  OMCInterface::convertUnits_res convertUnits_res;
+  double scaleFactor, offset;
+  bool converted = UnitConverter::convertUnits(from, to, &scaleFactor, &offset);
+  if (converted && !MainWindow::instance()->isDebug()) {
+    convertUnits_res.unitsCompatible = true;
+    convertUnits_res.scaleFactor = scaleFactor;
+    convertUnits_res.offset = offset;
+    mUnitConversionHash.insert(units, convertUnits_res);
+    return convertUnits_res;
+  }
+  convertUnits_res = callOMCInterface(&OMCInterface::convertUnits, from, to);
+  /* In debug mode every conversion of UnitConverter is checked against OMC once and OMC wins.
+   * Each mismatch is reported so UnitConverter can be fixed.
+   */
+  if (converted && (!convertUnits_res.unitsCompatible
+                    || qAbs(convertUnits_res.scaleFactor - scaleFactor) > 1e-12 * qMax(1.0, qAbs(convertUnits_res.scaleFactor))
+                    || qAbs(convertUnits_res.offset - offset) > 1e-12 * qMax(1.0, qAbs(convertUnits_res.offset)))) {
+    QString message = QString("UnitConverter converts %1 to %2 with scale factor %3 and offset %4 but OMC %5.")
+        .arg(from, to, QString::number(scaleFactor, 'g', 17), QString::number(offset, 'g', 17))
+        .arg(convertUnits_res.unitsCompatible ? QString("uses scale factor %1 and offset %2")
+                                                .arg(QString::number(convertUnits_res.scaleFactor, 'g', 17),
+                                                     QString::number(convertUnits_res.offset, 'g', 17))
+                                              : QString("finds the units incompatible"));
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, message, Helper::scriptingKind,
+                                                          Helper::warningLevel));
+  }
+  mUnitConversionHash.insert(units, convertUnits_res);
   // show error if units are not compatible
   if (!convertUnits_res.unitsCompatible) {
     printMessagesStringInternal();
@@ -2401,7 +2914,7 @@ QList<QString> OMCProxy::getDerivedUnits(QString baseUnit)
       return derivedUnitsIterator.value();
     }
   }
-  QList<QString> result = mpOMCInterface->getDerivedUnits(baseUnit);
+  QList<QString> result = callOMCInterface(&OMCInterface::getDerivedUnits, baseUnit);
   getErrorString();
   mDerivedUnitsMap.insert(baseUnit, result);
   return result;
@@ -2439,7 +2952,7 @@ QString OMCProxy::getCommandLineOptionsAnnotation(QString className)
  */
 QList<QString> OMCProxy::getAnnotationNamedModifiers(QString className, QString annotation)
 {
-  QList<QString> result = mpOMCInterface->getAnnotationNamedModifiers(className, annotation);
+  QList<QString> result = callOMCInterface(&OMCInterface::getAnnotationNamedModifiers, className, annotation);
   if (result.isEmpty()) {
     printMessagesStringInternal();
   }
@@ -2456,7 +2969,7 @@ QList<QString> OMCProxy::getAnnotationNamedModifiers(QString className, QString
  */
 QString OMCProxy::getAnnotationModifierValue(QString className, QString annotation, QString modifier)
 {
-  return mpOMCInterface->getAnnotationModifierValue(className, annotation, modifier);
+  return callOMCInterface(&OMCInterface::getAnnotationModifierValue, className, annotation, modifier);
 }
 
 /*!
@@ -2483,7 +2996,7 @@ QString OMCProxy::getSimulationFlagsAnnotation(QString className)
  */
 int OMCProxy::numProcessors()
 {
-  return mpOMCInterface->numProcessors();
+  return callOMCInterface(&OMCInterface::numProcessors);
 }
 
 /*!
@@ -2493,7 +3006,7 @@ int OMCProxy::numProcessors()
  */
 QString OMCProxy::help(QString topic)
 {
-  return mpOMCInterface->help(topic);
+  return callOMCInterface(&OMCInterface::help, topic);
 }
 
 /*!
@@ -2503,7 +3016,7 @@ QString OMCProxy::help(QString topic)
  */
 OMCInterface::getConfigFlagValidOptions_res OMCProxy::getConfigFlagValidOptions(QString topic)
 {
-  return mpOMCInterface->getConfigFlagValidOptions(topic);
+  return callOMCInterface(&OMCInterface::getConfigFlagValidOptions, topic);
 }
 
 /*!
@@ -2531,7 +3044,7 @@ bool OMCProxy::setDebugFlags(QString debugFlags)
 bool OMCProxy::exportToFigaro(QString className, QString directory, QString database, QString mode, QString options, QString processor)
 {
   bool result = false;
-  result = mpOMCInterface->exportToFigaro(className, directory, database, mode, options, processor);
+  result = callOMCInterface(&OMCInterface::exportToFigaro, className, directory, database, mode, options, processor);
   if (!result) {
     printMessagesStringInternal();
   }
@@ -2548,7 +3061,7 @@ bool OMCProxy::exportToFigaro(QString className, QString directory, QString data
  */
 bool OMCProxy::copyClass(QString className, QString newClassName, QString withIn)
 {
-  bool result = mpOMCInterface->copyClass(className, newClassName, withIn.isEmpty() ? "TopLevel" : withIn);
+  bool result = callOMCInterface(&OMCInterface::copyClass, className, newClassName, withIn.isEmpty() ? "TopLevel" : withIn);
   if (!result) printMessagesStringInternal();
   return result;
 }
@@ -2669,7 +3182,7 @@ void OMCProxy::getLogStreams(QStringList *names, QStringList *descriptions)
  */
 bool OMCProxy::moveClass(QString className, int offset)
 {
-  return mpOMCInterface->moveClass(className, offset);
+  return callOMCInterface(&OMCInterface::moveClass, className, offset);
 }
 
 /*!
@@ -2680,7 +3193,7 @@ bool OMCProxy::moveClass(QString className, int offset)
  */
 bool OMCProxy::moveClassToTop(QString className)
 {
-  return mpOMCInterface->moveClassToTop(className);
+  return callOMCInterface(&OMCInterface::moveClassToTop, className);
 }
 
 /*!
@@ -2691,7 +3204,7 @@ bool OMCProxy::moveClassToTop(QString className)
  */
 bool OMCProxy::moveClassToBottom(QString className)
 {
-  return mpOMCInterface->moveClassToBottom(className);
+  return callOMCInterface(&OMCInterface::moveClassToBottom, className);
 }
 
 /*!
@@ -2702,7 +3215,8 @@ bool OMCProxy::moveClassToBottom(QString className)
  */
 bool OMCProxy::inferBindings(QString className)
 {
-  bool result = mpOMCInterface->inferBindings(className);
+  invalidateCachedResponses(className);
+  bool result = callOMCInterface(&OMCInterface::inferBindings, className);
   printMessagesStringInternal();
   return result;
 }
@@ -2715,7 +3229,7 @@ bool OMCProxy::inferBindings(QString className)
  */
 bool OMCProxy::generateVerificationScenarios(QString className)
 {
-  bool result = mpOMCInterface->generateVerificationScenarios(className);
+  bool result = callOMCInterface(&OMCInterface::generateVerificationScenarios, className);
   printMessagesStringInternal();
   return result;
 }
@@ -2728,11 +3242,255 @@ bool OMCProxy::generateVerificationScenarios(QString className)
  */
 QList<QList<QString > > OMCProxy::getUses(QString className)
 {
-  QList<QList<QString > > result = mpOMCInterface->getUses(className);
+  QList<QList<QString > > result = callOMCInterface(&OMCInterface::getUses, className);
   printMessagesStringInternal();
   return result;
 }
 
+/*!
+ * \class OMCCommand
+ * \brief Handle of a command queued for the OMCCommandThread.
+ */
+/*!
+ * \brief OMCCommand::OMCCommand
+ * \param expression
+ * \param pParent
+ */
+OMCCommand::OMCCommand(const QString &expression, QObject *pParent)
+  : QObject(pParent), mExpression(expression), mResult(""), mSuccess(true), mFinished(false), mCancelled(false), mExecuted(false),
+    mAutoDelete(true), mInterfaceCall(false)
+{
+
+}
+
+/*!
+ * \class OMCCommandThread
+ * \brief Executes the queued OMC commands one by one so that the GUI thread is not blocked by the compiler.
+ */
+/*!
+ * \brief OMCCommandThread::OMCCommandThread
+ * \param pOMCInterface
+ * \param pParent
+ */
+OMCCommandThread::OMCCommandThread(OMCInterface *pOMCInterface, QObject *pParent)
+  : QThread(pParent), mpOMCInterface(pOMCInterface), mExecutingCommand(false), mStop(false)
+{
+  // same stack size as we use for the main thread on Windows since the compiler is heavily recursive.
+  setStackSize(33554432);
+  /* The thread gets its own threadData since the jump buffers, the local roots and the stack limits are per thread.
+   * Start from an empty one, the jump buffers are set by MMC_TRY_TOP_INTERNAL and the stack limits in OMCCommandThread::run().
+   * The thread object is not scanned by the garbage collector so allocate it as uncollectable.
+   */
+  mpThreadData = (threadData_t *) GC_malloc_uncollectable(sizeof(threadData_t));
+  memset(mpThreadData, 0, sizeof(threadData_t));
+  // the plot commands are executed in this thread so the plot callback must forward the plot to the GUI thread.
+  mpThreadData->plotClassPointer = this;
+  mpThreadData->plotCB = OMCCommandThread::PlotCallbackFunction;
+  // OMCInterface is only called from this thread.
+  mpOMCInterface->threadData = mpThreadData;
+}
+
+/*!
+ * \brief OMCCommandThread::enqueueCommand
+ * Adds the command to the end of the queue.
+ * \param pOMCCommand
+ */
+void OMCCommandThread::enqueueCommand(OMCCommand *pOMCCommand)
+{
+  QMutexLocker locker(&mMutex);
+  mCommandsQueue.enqueue(pOMCCommand);
+  mCommandsAvailable.wakeOne();
+}
+
+/*!
+ * \brief OMCCommandThread::cancelCommand
+ * Removes the command from the queue.
+ * \param pOMCCommand
+ * \return false if the command is already started.
+ */
+bool OMCCommandThread::cancelCommand(OMCCommand *pOMCCommand)
+{
+  QMutexLocker locker(&mMutex);
+  if (mCommandsQueue.removeOne(pOMCCommand)) {
+    pOMCCommand->setCancelled(true);
+    return true;
+  }
+  return false;
+}
+
+/*!
+ * \brief OMCCommandThread::waitForCommand
+ * Blocks the calling thread until the command is executed.\n
+ * Unlike OMCProxy::waitForCommand no events are processed while waiting.
+ * \param pOMCCommand
+ */
+void OMCCommandThread::waitForCommand(OMCCommand *pOMCCommand)
+{
+  QMutexLocker locker(&mMutex);
+  while (!pOMCCommand->isExecuted() && !pOMCCommand->isCancelled()) {
+    mCommandExecuted.wait(&mMutex);
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::waitForIdle
+ * Blocks the calling thread until all the queued commands are executed.
+ */
+void OMCCommandThread::waitForIdle()
+{
+  QMutexLocker locker(&mMutex);
+  while (!mCommandsQueue.isEmpty() || mExecutingCommand) {
+    mCommandExecuted.wait(&mMutex);
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::takeExecutedCommand
+ * Removes the oldest executed command from the executed commands queue.
+ * \return the command or 0 if no command is executed since the last call.
+ */
+OMCCommand* OMCCommandThread::takeExecutedCommand()
+{
+  QMutexLocker locker(&mMutex);
+  if (mExecutedCommandsQueue.isEmpty()) {
+    return 0;
+  }
+  return mExecutedCommandsQueue.dequeue();
+}
+
+/*!
+ * \brief OMCCommandThread::stop
+ * Stops the thread once the queued commands are executed.
+ */
+void OMCCommandThread::stop()
+{
+  QMutexLocker locker(&mMutex);
+  mStop = true;
+  mCommandsAvailable.wakeOne();
+}
+
+/*!
+ * \brief OMCCommandThread::run
+ * Reimplentation of QThread::run(). Waits for the commands and executes them in order.
+ */
+void OMCCommandThread::run()
+{
+  // the compiler allocates via the garbage collector so it must know about this thread.
+  struct GC_stack_base stackBase;
+  GC_get_stack_base(&stackBase);
+  GC_register_my_thread(&stackBase);
+  // the stack overflow check must use the stack of this thread.
+  mmc_init_stackoverflow(mpThreadData);
+  forever {
+    mMutex.lock();
+    while (mCommandsQueue.isEmpty() && !mStop) {
+      mCommandsAvailable.wait(&mMutex);
+    }
+    if (mCommandsQueue.isEmpty()) {
+      mMutex.unlock();
+      break;
+    }
+    OMCCommand *pOMCCommand = mCommandsQueue.dequeue();
+    mExecutingCommand = true;
+    mMutex.unlock();
+    executeCommand(pOMCCommand);
+    mMutex.lock();
+    pOMCCommand->setExecuted(true);
+    mExecutedCommandsQueue.enqueue(pOMCCommand);
+    mExecutingCommand = false;
+    mCommandExecuted.wakeAll();
+    mMutex.unlock();
+    emit commandExecuted();
+  }
+  GC_unregister_my_thread();
+}
+
+/*!
+ * \brief OMCCommandThread::executeCommand
+ * Executes the command using the symbol table owned by OMCInterface.\n
+ * The typed OMCInterface calls are executed here as well so the symbol table is only used by this thread.
+ * \param pOMCCommand
+ */
+void OMCCommandThread::executeCommand(OMCCommand *pOMCCommand)
+{
+  if (pOMCCommand->isInterfaceCall()) {
+    // OMCInterface handles the compiler errors itself.
+    pOMCCommand->invoke(mpOMCInterface);
+    return;
+  }
+  void *reply_str = NULL;
+  threadData_t *threadData = mpThreadData;
+  QString result = "";
+
+  MMC_TRY_TOP_INTERNAL()
+
+  MMC_TRY_STACK()
+
+  if (!omc_Main_handleCommand(threadData, mmc_mk_scon(pOMCCommand->getExpression().toStdString().c_str()), mpOMCInterface->st, &reply_str,
+                              &mpOMCInterface->st)) {
+    pOMCCommand->setSuccess(false);
+  } else {
+    result = MMC_STRINGDATA(reply_str);
+  }
+
+  MMC_ELSE()
+    result = "";
+    fprintf(stderr, "Stack overflow detected and was not caught.\nSend us a bug report at https://trac.openmodelica.org/OpenModelica/newticket\n    Include the following trace:\n");
+    printStacktraceMessages();
+    fflush(NULL);
+  MMC_CATCH_STACK()
+
+  MMC_CATCH_TOP(result = "";)
+
+  pOMCCommand->setResult(result.trimmed());
+}
+
+/*!
+ * \brief OMCCommandThread::PlotCallbackFunction
+ * The plot callback of the OMCCommandThread threadData. Called in the thread by the plot commands.\n
+ * Copies the arguments and forwards them to the GUI thread since the plot windows can only be created there.
+ * \sa MainWindow::PlotCallbackFunction()
+ */
+void OMCCommandThread::PlotCallbackFunction(void *p, int externalWindow, const char* filename, const char* title, const char* grid,
+                                            const char* plotType, const char* logX, const char* logY, const char* xLabel, const char* yLabel,
+                                            const char* x1, const char* x2, const char* y1, const char* y2, const char* curveWidth,
+                                            const char* curveStyle, const char* legendPosition, const char* footer, const char* autoScale,
+                                            const char* variables)
+{
+  OMCCommandThread *pOMCCommandThread = (OMCCommandThread*)p;
+  if (pOMCCommandThread) {
+    QStringList arguments;
+    arguments << filename << title << grid << plotType << logX << logY << xLabel << yLabel << x1 << x2 << y1 << y2 << curveWidth
+              << curveStyle << legendPosition << footer << autoScale << variables;
+    QMetaObject::invokeMethod(pOMCCommandThread, "plot", Qt::QueuedConnection, Q_ARG(int, externalWindow), Q_ARG(QStringList, arguments));
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::plot
+ * Slot invoked in the GUI thread by OMCCommandThread::PlotCallbackFunction.
+ * \param externalWindow
+ * \param arguments - the arguments of the plot callback in order.
+ */
+void OMCCommandThread::plot(int externalWindow, QStringList arguments)
+{
+  QList<QByteArray> values;
+  foreach (QString argument, arguments) {
+    values.append(argument.toUtf8());
+  }
+  try {
+    MainWindow::PlotCallbackFunction(MainWindow::instance(), externalWindow, values.at(0).constData(), values.at(1).constData(),
+                                     values.at(2).constData(), values.at(3).constData(), values.at(4).constData(), values.at(5).constData(),
+                                     values.at(6).constData(), values.at(7).constData(), values.at(8).constData(), values.at(9).constData(),
+                                     values.at(10).constData(), values.at(11).constData(), values.at(12).constData(),
+                                     values.at(13).constData(), values.at(14).constData(), values.at(15).constData(),
+                                     values.at(16).constData(), values.at(17).constData());
+  } catch (OMPlot::PlotException &e) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, e.what(), Helper::scriptingKind,
+                                                          Helper::errorLevel));
+  }
+}
+
 /*!
   \class CustomExpressionBox
   \brief A text box for executing OMC commands.
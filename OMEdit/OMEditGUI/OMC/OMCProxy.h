@@ -41,17 +41,246 @@
 #include "Util/Utilities.h"
 #include "Util/Helper.h"
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QCache>
+
 class CustomExpressionBox;
 class ComponentInfo;
 class StringHandler;
 class OMCInterface;
 class LibraryTreeItem;
+class MessageItem;
+
+class OMCCommand : public QObject
+{
+  Q_OBJECT
+public:
+  OMCCommand(const QString &expression, QObject *pParent = 0);
+  QString getExpression() const {return mExpression;}
+  void setResult(const QString &result) {mResult = result;}
+  QString getResult() const {return mResult;}
+  void setSuccess(bool success) {mSuccess = success;}
+  bool isSuccess() const {return mSuccess;}
+  void setFinished(bool finished) {mFinished = finished;}
+  bool isFinished() const {return mFinished;}
+  void setCancelled(bool cancelled) {mCancelled = cancelled;}
+  bool isCancelled() const {return mCancelled;}
+  void setExecuted(bool executed) {mExecuted = executed;}
+  bool isExecuted() const {return mExecuted;}
+  void setAutoDelete(bool autoDelete) {mAutoDelete = autoDelete;}
+  bool autoDelete() const {return mAutoDelete;}
+  bool isInterfaceCall() const {return mInterfaceCall;}
+  QTime* getCommandTime() {return &mCommandTime;}
+  virtual void invoke(OMCInterface *pOMCInterface) {Q_UNUSED(pOMCInterface);}
+protected:
+  void setInterfaceCall(bool interfaceCall) {mInterfaceCall = interfaceCall;}
+private:
+  QString mExpression;
+  QString mResult;
+  bool mSuccess;
+  bool mFinished;
+  bool mCancelled;
+  bool mExecuted;
+  bool mAutoDelete;
+  bool mInterfaceCall;
+  QTime mCommandTime;
+signals:
+  void finished(QString result);
+};
+
+/*!
+ * \brief The OMCArgument struct
+ * Strips the reference from the parameter type of an OMCInterface function so the argument can be stored by value.
+ */
+template <typename T> struct OMCArgument {typedef T Type;};
+template <typename T> struct OMCArgument<T&> {typedef T Type;};
+template <typename T> struct OMCArgument<const T&> {typedef T Type;};
+
+/*!
+ * \brief The OMCInterfaceCall class
+ * A typed OMCInterface function queued for the OMCCommandThread. The subclasses bind the function and its arguments.
+ */
+template <typename R>
+class OMCInterfaceCall : public OMCCommand
+{
+public:
+  OMCInterfaceCall(QObject *pParent) : OMCCommand("", pParent), mReturnValue() {setInterfaceCall(true);}
+  R getReturnValue() const {return mReturnValue;}
+protected:
+  R mReturnValue;
+};
+
+template <typename R>
+class OMCInterfaceCall0 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)();
+  OMCInterfaceCall0(Function pFunction, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)();}
+private:
+  Function mpFunction;
+};
+
+template <typename R, typename P1>
+class OMCInterfaceCall1 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1);
+  OMCInterfaceCall1(Function pFunction, const typename OMCArgument<P1>::Type &a1, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+};
+
+template <typename R, typename P1, typename P2>
+class OMCInterfaceCall2 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2);
+  OMCInterfaceCall2(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+};
+
+template <typename R, typename P1, typename P2, typename P3>
+class OMCInterfaceCall3 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2, P3);
+  OMCInterfaceCall3(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                    const typename OMCArgument<P3>::Type &a3, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2), mA3(a3) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2, mA3);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+  typename OMCArgument<P3>::Type mA3;
+};
+
+template <typename R, typename P1, typename P2, typename P3, typename P4>
+class OMCInterfaceCall4 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2, P3, P4);
+  OMCInterfaceCall4(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                    const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2), mA3(a3), mA4(a4) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2, mA3, mA4);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+  typename OMCArgument<P3>::Type mA3;
+  typename OMCArgument<P4>::Type mA4;
+};
+
+template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5>
+class OMCInterfaceCall5 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2, P3, P4, P5);
+  OMCInterfaceCall5(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                    const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4,
+                    const typename OMCArgument<P5>::Type &a5, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2), mA3(a3), mA4(a4), mA5(a5) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2, mA3, mA4, mA5);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+  typename OMCArgument<P3>::Type mA3;
+  typename OMCArgument<P4>::Type mA4;
+  typename OMCArgument<P5>::Type mA5;
+};
+
+template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6>
+class OMCInterfaceCall6 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2, P3, P4, P5, P6);
+  OMCInterfaceCall6(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                    const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4,
+                    const typename OMCArgument<P5>::Type &a5, const typename OMCArgument<P6>::Type &a6, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2), mA3(a3), mA4(a4), mA5(a5), mA6(a6) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2, mA3, mA4, mA5, mA6);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+  typename OMCArgument<P3>::Type mA3;
+  typename OMCArgument<P4>::Type mA4;
+  typename OMCArgument<P5>::Type mA5;
+  typename OMCArgument<P6>::Type mA6;
+};
 
-typedef struct {
-  QString mFromUnit;
-  QString mToUnit;
-  OMCInterface::convertUnits_res mConvertUnits;
-} UnitConverion;
+template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7>
+class OMCInterfaceCall7 : public OMCInterfaceCall<R>
+{
+public:
+  typedef R (OMCInterface::*Function)(P1, P2, P3, P4, P5, P6, P7);
+  OMCInterfaceCall7(Function pFunction, const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                    const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4,
+                    const typename OMCArgument<P5>::Type &a5, const typename OMCArgument<P6>::Type &a6,
+                    const typename OMCArgument<P7>::Type &a7, QObject *pParent)
+    : OMCInterfaceCall<R>(pParent), mpFunction(pFunction), mA1(a1), mA2(a2), mA3(a3), mA4(a4), mA5(a5), mA6(a6), mA7(a7) {}
+  virtual void invoke(OMCInterface *pOMCInterface) {this->mReturnValue = (pOMCInterface->*mpFunction)(mA1, mA2, mA3, mA4, mA5, mA6, mA7);}
+private:
+  Function mpFunction;
+  typename OMCArgument<P1>::Type mA1;
+  typename OMCArgument<P2>::Type mA2;
+  typename OMCArgument<P3>::Type mA3;
+  typename OMCArgument<P4>::Type mA4;
+  typename OMCArgument<P5>::Type mA5;
+  typename OMCArgument<P6>::Type mA6;
+  typename OMCArgument<P7>::Type mA7;
+};
+
+class OMCCommandThread : public QThread
+{
+  Q_OBJECT
+public:
+  OMCCommandThread(OMCInterface *pOMCInterface, QObject *pParent = 0);
+  void enqueueCommand(OMCCommand *pOMCCommand);
+  bool cancelCommand(OMCCommand *pOMCCommand);
+  void waitForCommand(OMCCommand *pOMCCommand);
+  void waitForIdle();
+  OMCCommand* takeExecutedCommand();
+  void stop();
+  static void PlotCallbackFunction(void *p, int externalWindow, const char* filename, const char* title, const char* grid,
+                                   const char* plotType, const char* logX, const char* logY, const char* xLabel, const char* yLabel,
+                                   const char* x1, const char* x2, const char* y1, const char* y2, const char* curveWidth,
+                                   const char* curveStyle, const char* legendPosition, const char* footer, const char* autoScale,
+                                   const char* variables);
+protected:
+  virtual void run();
+private:
+  OMCInterface *mpOMCInterface;
+  threadData_t *mpThreadData;
+  QMutex mMutex;
+  QWaitCondition mCommandsAvailable;
+  QWaitCondition mCommandExecuted;
+  QQueue<OMCCommand*> mCommandsQueue;
+  QQueue<OMCCommand*> mExecutedCommandsQueue;
+  bool mExecutingCommand;
+  bool mStop;
+
+  void executeCommand(OMCCommand *pOMCCommand);
+private slots:
+  void plot(int externalWindow, QStringList arguments);
+signals:
+  void commandExecuted();
+};
 
 class OMCProxy : public QObject
 {
@@ -77,9 +306,85 @@ private:
   FILE *mpCommunicationLogFile;
   FILE *mpCommandsLogFile;
   double mTotalOMCCallsTime;
-  QList<UnitConverion> mUnitConversionList;
+  QHash<QPair<QString, QString>, OMCInterface::convertUnits_res> mUnitConversionHash;
   QMap<QString, QList<QString> > mDerivedUnitsMap;
   OMCInterface *mpOMCInterface;
+  OMCCommandThread *mpOMCCommandThread;
+  int mPendingCommandsCount;
+  bool mWaitingForCommand;
+  QCache<QString, QHash<QString, QVariant> > mCachedResponses;
+  QHash<QString, QSet<QString> > mCachedResponsesDependents;
+  int mCacheHits;
+  int mCacheMisses;
+
+  bool enqueueInterfaceCall(OMCCommand *pOMCCommand);
+  /*!
+   * \brief OMCProxy::waitForInterfaceCall
+   * Queues the typed OMCInterface call for the OMCCommandThread and waits for its return value.
+   * \param pOMCInterfaceCall
+   * \return
+   */
+  template <typename R>
+  R waitForInterfaceCall(OMCInterfaceCall<R> *pOMCInterfaceCall)
+  {
+    if (!enqueueInterfaceCall(pOMCInterfaceCall)) {
+      return R();
+    }
+    waitForCommand(pOMCInterfaceCall);
+    return pOMCInterfaceCall->getReturnValue();
+  }
+  template <typename R>
+  R callOMCInterface(R (OMCInterface::*pFunction)())
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall0<R>(pFunction, this));
+  }
+  template <typename R, typename P1>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1), const typename OMCArgument<P1>::Type &a1)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall1<R, P1>(pFunction, a1, this));
+  }
+  template <typename R, typename P1, typename P2>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2), const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall2<R, P1, P2>(pFunction, a1, a2, this));
+  }
+  template <typename R, typename P1, typename P2, typename P3>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2, P3), const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                     const typename OMCArgument<P3>::Type &a3)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall3<R, P1, P2, P3>(pFunction, a1, a2, a3, this));
+  }
+  template <typename R, typename P1, typename P2, typename P3, typename P4>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2, P3, P4), const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                     const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall4<R, P1, P2, P3, P4>(pFunction, a1, a2, a3, a4, this));
+  }
+  template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2, P3, P4, P5), const typename OMCArgument<P1>::Type &a1, const typename OMCArgument<P2>::Type &a2,
+                     const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4, const typename OMCArgument<P5>::Type &a5)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall5<R, P1, P2, P3, P4, P5>(pFunction, a1, a2, a3, a4, a5, this));
+  }
+  template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2, P3, P4, P5, P6), const typename OMCArgument<P1>::Type &a1,
+                     const typename OMCArgument<P2>::Type &a2, const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4,
+                     const typename OMCArgument<P5>::Type &a5, const typename OMCArgument<P6>::Type &a6)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall6<R, P1, P2, P3, P4, P5, P6>(pFunction, a1, a2, a3, a4, a5, a6, this));
+  }
+  template <typename R, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7>
+  R callOMCInterface(R (OMCInterface::*pFunction)(P1, P2, P3, P4, P5, P6, P7), const typename OMCArgument<P1>::Type &a1,
+                     const typename OMCArgument<P2>::Type &a2, const typename OMCArgument<P3>::Type &a3, const typename OMCArgument<P4>::Type &a4,
+                     const typename OMCArgument<P5>::Type &a5, const typename OMCArgument<P6>::Type &a6, const typename OMCArgument<P7>::Type &a7)
+  {
+    return waitForInterfaceCall(new OMCInterfaceCall7<R, P1, P2, P3, P4, P5, P6, P7>(pFunction, a1, a2, a3, a4, a5, a6, a7, this));
+  }
+  void finishCommand(OMCCommand *pOMCCommand);
+  QList<MessageItem> parseMessagesStringInternal(const QString &messages);
+  bool getCachedResponse(const QString &className, const QString &command, QVariant *pResponse);
+  void cacheResponse(const QString &className, const QString &command, const QVariant &response);
+  void addCachedResponsesDependency(const QString &className, const QString &dependentClassName);
 public:
   OMCProxy(QWidget *pParent = 0);
   ~OMCProxy();
@@ -88,23 +393,22 @@ public:
   bool initializeOMC();
   void quitOMC();
   void sendCommand(const QString expression);
+  OMCCommand* sendCommandAsync(const QString expression);
+  void waitForResult(OMCCommand *pOMCCommand);
+  bool cancelCommand(OMCCommand *pOMCCommand);
+  void waitForCommand(OMCCommand *pOMCCommand);
+  void waitForCommands();
+  int getCacheHits() {return mCacheHits;}
+  int getCacheMisses() {return mCacheMisses;}
+  void invalidateCachedResponses(QString className);
+  void clearCachedResponses();
   void setResult(QString value);
   QString getResult();
   void exitApplication();
   void removeObjectRefFile();
   QString getErrorString(bool warningsAsErrors = false);
   bool printMessagesStringInternal();
-  int getMessagesStringInternal();
-  void setCurrentError(int errorIndex);
-  QString getErrorFileName();
-  bool getErrorReadOnly();
-  int getErrorLineStart();
-  int getErrorColumnStart();
-  int getErrorLineEnd();
-  int getErrorColumnEnd();
-  QString getErrorMessage();
-  QString getErrorKind();
-  QString getErrorLevel();
+  QList<MessageItem> getMessagesStringInternal();
   QString getVersion(QString className = QString("OpenModelica"));
   void loadSystemLibraries();
   void loadUserLibraries();
@@ -136,6 +440,7 @@ public:
   int getConnectionCount(QString className);
   QList<QString> getNthConnection(QString className, int index);
   QString getNthConnectionAnnotation(QString className, int num);
+  QList<QStringList> getConnections(QString className);
   int getInheritanceCount(QString className);
   QString getNthInheritedClass(QString className, int num);
   QList<QString> getInheritedClasses(QString className);
@@ -148,7 +453,10 @@ public:
   QString changeDirectory(QString directory = QString(""));
   bool loadModel(QString className, QString priorityVersion = QString("default"), bool notify = false, QString languageStandard = QString(""),
                  bool requireExactVersion = false);
+  OMCCommand* loadModelAsync(QString className, QString priorityVersion = QString("default"), bool notify = false,
+                             QString languageStandard = QString(""), bool requireExactVersion = false);
   bool loadFile(QString fileName, QString encoding = Helper::utf8, bool uses = true);
+  OMCCommand* loadFileAsync(QString fileName, QString encoding = Helper::utf8, bool uses = true);
   bool loadString(QString value, QString fileName, QString encoding = Helper::utf8, bool merge = false, bool checkError = true);
   QList<QString> parseFile(QString fileName, QString encoding = Helper::utf8);
   QList<QString> parseString(QString value, QString fileName);
@@ -166,6 +474,7 @@ public:
   QString listFile(QString className);
   QString diffModelicaFileListings(QString before, QString after);
   QString instantiateModel(QString className);
+  OMCCommand* instantiateModelAsync(QString className);
   bool addClassAnnotation(QString className, QString annotation);
   QString getDefaultComponentName(QString className);
   QString getDefaultComponentPrefixes(QString className);
@@ -187,8 +496,10 @@ public:
   QStringList readSimulationResultVars(QString fileName);
   bool closeSimulationResultFile();
   QString checkModel(QString className);
+  OMCCommand* checkModelAsync(QString className);
   bool ngspicetoModelica(QString fileName);
   QString checkAllModelsRecursive(QString className);
+  OMCCommand* checkAllModelsRecursiveAsync(QString className);
   bool isExperiment(QString className);
   OMCInterface::getSimulationOptions_res getSimulationOptions(QString className, double defaultTolerance = 1e-6);
   QString buildModelFMU(QString className, double version, QString type, QString fileNamePrefix, QList<QString> platforms, bool includeResources = true);
@@ -237,6 +548,13 @@ public:
   QList<QList<QString > > getUses(QString className);
 signals:
   void commandFinished();
+  void commandsFinished();
+private slots:
+  void handleCommandExecuted();
+  void logInterfaceCommand(QString command, QTime *commandTime);
+  void logInterfaceResponse(QString response, QTime *responseTime);
+  void writeCommandLog(QString command, QTime time);
+  void writeResponseLog(QString response, QTime time, int elapsed);
 public slots:
   void logCommand(QString command, QTime *commandTime);
   void logResponse(QString response, QTime *responseTime);
@@ -117,6 +117,8 @@ SOURCES += main.cpp \
   Util/Helper.cpp \
   Util/Utilities.cpp \
   Util/StringHandler.cpp \
+  Util/AnnotationParser.cpp \
+  Util/UnitConverter.cpp \
   MainWindow.cpp \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.cpp \
   OMC/OMCProxy.cpp \
@@ -136,6 +138,8 @@ SOURCES += main.cpp \
   Editors/MetaModelicaEditor.cpp \
   Editors/HTMLEditor.cpp \
   Plotting/PlotWindowContainer.cpp \
+  Plotting/MatResultReader.cpp \
+  Plotting/DecimatedPlotCurve.cpp \
   Component/Component.cpp \
   Annotations/ShapeAnnotation.cpp \
   Component/CornerItem.cpp \
@@ -190,6 +194,8 @@ SOURCES += main.cpp \
 HEADERS  += Util/Helper.h \
   Util/Utilities.h \
   Util/StringHandler.h \
+  Util/AnnotationParser.h \
+  Util/UnitConverter.h \
   MainWindow.h \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.h \
   OMC/OMCProxy.h \
@@ -209,6 +215,8 @@ HEADERS  += Util/Helper.h \
   Editors/MetaModelicaEditor.h \
   Editors/HTMLEditor.h \
   Plotting/PlotWindowContainer.h \
+  Plotting/MatResultReader.h \
+  Plotting/DecimatedPlotCurve.h \
   Component/Component.h \
   Annotations/ShapeAnnotation.h \
   Component/CornerItem.h \
@@ -515,6 +515,9 @@ void OptionsDialog::readSimulationSettings()
   if (mpSettings->contains("simulation/switchToPlottingPerspectiveAfterSimulation")) {
     mpSimulationPage->getSwitchToPlottingPerspectiveCheckBox()->setChecked(mpSettings->value("simulation/switchToPlottingPerspectiveAfterSimulation").toBool());
   }
+  if (mpSettings->contains("simulation/livePlotting")) {
+    mpSimulationPage->getLivePlottingCheckBox()->setChecked(mpSettings->value("simulation/livePlotting").toBool());
+  }
   if (mpSettings->contains("simulation/outputMode")) {
     mpSimulationPage->setOutputMode(mpSettings->value("simulation/outputMode").toString());
   }
@@ -1038,6 +1041,7 @@ void OptionsDialog::saveSimulationSettings()
   // save class before simulation.
   mpSettings->setValue("simulation/saveClassBeforeSimulation", mpSimulationPage->getSaveClassBeforeSimulationCheckBox()->isChecked());
   mpSettings->setValue("simulation/switchToPlottingPerspectiveAfterSimulation", mpSimulationPage->getSwitchToPlottingPerspectiveCheckBox()->isChecked());
+  mpSettings->setValue("simulation/livePlotting", mpSimulationPage->getLivePlottingCheckBox()->isChecked());
   mpSettings->setValue("simulation/outputMode", mpSimulationPage->getOutputMode());
 }
 
@@ -3265,6 +3269,10 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   /* switch to plotting perspective after simulation checkbox */
   mpSwitchToPlottingPerspectiveCheckBox = new QCheckBox(tr("Switch to plotting perspective after simulation"));
   mpSwitchToPlottingPerspectiveCheckBox->setChecked(true);
+  /* live plotting checkbox */
+  mpLivePlottingCheckBox = new QCheckBox(tr("Update the plotted variables while the simulation is running"));
+  mpLivePlottingCheckBox->setToolTip(tr("Reads the csv result file during the simulation and updates the curves of the plot windows.\n"
+                                        "The mat and plt result files can only be read once the simulation has finished."));
   // simulation output format
   mpOutputGroupBox = new QGroupBox(Helper::output);
   mpStructuredRadioButton = new QRadioButton(tr("Structured"));
@@ -3302,7 +3310,8 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   pSimulationLayout->addWidget(mpIgnoreSimulationFlagsAnnotationCheckBox, 6, 0, 1, 3);
   pSimulationLayout->addWidget(mpSaveClassBeforeSimulationCheckBox, 7, 0, 1, 3);
   pSimulationLayout->addWidget(mpSwitchToPlottingPerspectiveCheckBox, 8, 0, 1, 3);
-  pSimulationLayout->addWidget(mpOutputGroupBox, 9, 0, 1, 3);
+  pSimulationLayout->addWidget(mpLivePlottingCheckBox, 9, 0, 1, 3);
+  pSimulationLayout->addWidget(mpOutputGroupBox, 10, 0, 1, 3);
   mpSimulationGroupBox->setLayout(pSimulationLayout);
   // set the layout
   QVBoxLayout *pLayout = new QVBoxLayout;
@@ -0,0 +1,427 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "DecimatedPlotCurve.h"
+
+#include <QApplication>
+#include <qmath.h>
+
+/*!
+ * \class DecimatedSeriesData
+ * \brief The samples of a result variable decimated to the width of the plot.
+ * update() reads the rows of the visible time range. If there are more rows than twice the width of the plot in pixels then the
+ * minimum and maximum of each bucket of the matching MinMaxPyramid level are used instead so that spikes remain visible.
+ * The values are converted with value * scale + offset which holds the unit conversions applied to the curve.
+ */
+/*!
+ * \brief DecimatedSeriesData::DecimatedSeriesData
+ * \param pReader - the reader of the result file. DecimatedSeriesData takes the ownership.
+ * \param variable
+ * \param column
+ * \param negated
+ */
+DecimatedSeriesData::DecimatedSeriesData(MatResultReader *pReader, const QString &variable, int column, bool negated)
+  : mpReader(pReader), mVariable(variable), mColumn(column), mNegated(negated), mFirstTime(0), mLastTime(0), mMinimum(0), mMaximum(0),
+    mXScale(1), mXOffset(0), mYScale(1), mYOffset(0), mUpdated(false), mFrom(0), mTo(0), mWidth(0)
+{
+
+}
+
+DecimatedSeriesData::~DecimatedSeriesData()
+{
+  delete mpReader;
+}
+
+/*!
+ * \brief DecimatedSeriesData::readPyramid
+ * Reads the MinMaxPyramid of the column and the range of the data.
+ * \return
+ */
+bool DecimatedSeriesData::readPyramid()
+{
+  mUpdated = false;
+  bool read = mPyramid.read(mpReader, mColumn) && mpReader->readColumn(0, 0, 1, &mFirstTime)
+              && mpReader->readColumn(0, mpReader->getRowsCount() - 1, 1, &mLastTime);
+  mpReader->releasePages();
+  if (!read) {
+    return false;
+  }
+  const MinMaxLevel &level = mPyramid.getLevel(mPyramid.getLevelsCount() - 1);
+  mMinimum = level.mMinimum.first();
+  mMaximum = level.mMaximum.first();
+  return true;
+}
+
+/*!
+ * \brief DecimatedSeriesData::convertXValues
+ * Converts the x values like Utilities::convertUnit.
+ * \param offset
+ * \param scaleFactor
+ */
+void DecimatedSeriesData::convertXValues(double offset, double scaleFactor)
+{
+  mXScale = mXScale / scaleFactor;
+  mXOffset = (mXOffset - offset) / scaleFactor;
+  mUpdated = false;
+}
+
+/*!
+ * \brief DecimatedSeriesData::convertYValues
+ * Converts the y values like Utilities::convertUnit.
+ * \param offset
+ * \param scaleFactor
+ */
+void DecimatedSeriesData::convertYValues(double offset, double scaleFactor)
+{
+  mYScale = mYScale / scaleFactor;
+  mYOffset = (mYOffset - offset) / scaleFactor;
+  mUpdated = false;
+}
+
+/*!
+ * \brief DecimatedSeriesData::update
+ * Updates the samples for the visible x range from - to which is width pixels wide.
+ * \param from
+ * \param to
+ * \param width
+ */
+void DecimatedSeriesData::update(double from, double to, int width)
+{
+  if (mpReader->isModified() && !reload()) {
+    mXValues.clear();
+    mYValues.clear();
+    return;
+  }
+  width = qMax(width, 1);
+  if (mUpdated && from == mFrom && to == mTo && width == mWidth) {
+    return;
+  }
+  mUpdated = true;
+  mFrom = from;
+  mTo = to;
+  mWidth = width;
+  mXValues.clear();
+  mYValues.clear();
+  // the visible range in the time of the result file. Include the rows just outside of it so the curve reaches the borders.
+  double firstTime = (from - mXOffset) / mXScale;
+  double lastTime = (to - mXOffset) / mXScale;
+  if (firstTime > lastTime) {
+    qSwap(firstTime, lastTime);
+  }
+  int rowsCount = mpReader->getRowsCount();
+  int firstRow = qBound(0, mpReader->lowerBoundRow(firstTime) - 1, rowsCount - 1);
+  int lastRow = qBound(firstRow, mpReader->lowerBoundRow(lastTime), rowsCount - 1);
+  int count = lastRow - firstRow + 1;
+  if (count <= 2 * width) {
+    QVector<double> times(count);
+    QVector<double> values(count);
+    if (mpReader->readColumn(0, firstRow, count, times.data()) && mpReader->readColumn(mColumn, firstRow, count, values.data())) {
+      mXValues.reserve(count);
+      mYValues.reserve(count);
+      for (int i = 0 ; i < count ; i++) {
+        mXValues.append(times.at(i) * mXScale + mXOffset);
+        mYValues.append((mNegated ? -values.at(i) : values.at(i)) * mYScale + mYOffset);
+      }
+    }
+  } else {
+    const MinMaxLevel &level = mPyramid.getLevel(mPyramid.findLevel(count, width));
+    int firstBucket = firstRow / level.mBucketSize;
+    int lastBucket = lastRow / level.mBucketSize;
+    mXValues.reserve(2 * (lastBucket - firstBucket + 1));
+    mYValues.reserve(2 * (lastBucket - firstBucket + 1));
+    // draw the minimum and maximum of each bucket in the order in which they occur
+    for (int bucket = firstBucket ; bucket <= lastBucket ; bucket++) {
+      if (level.mMinimumRow.at(bucket) <= level.mMaximumRow.at(bucket)) {
+        appendSample(level.mMinimumRow.at(bucket), level.mMinimum.at(bucket));
+        if (level.mMaximumRow.at(bucket) != level.mMinimumRow.at(bucket)) {
+          appendSample(level.mMaximumRow.at(bucket), level.mMaximum.at(bucket));
+        }
+      } else {
+        appendSample(level.mMaximumRow.at(bucket), level.mMaximum.at(bucket));
+        appendSample(level.mMinimumRow.at(bucket), level.mMinimum.at(bucket));
+      }
+    }
+  }
+  mpReader->releasePages();
+}
+
+/*!
+ * \brief DecimatedSeriesData::boundingRect
+ * Returns the bounding rectangle of all the values and not only of the current samples.
+ * \return
+ */
+QRectF DecimatedSeriesData::boundingRect() const
+{
+  if (mPyramid.isEmpty()) {
+    return QRectF(1.0, 1.0, -2.0, -2.0);
+  }
+  double left = mFirstTime * mXScale + mXOffset;
+  double right = mLastTime * mXScale + mXOffset;
+  double bottom = (mNegated ? -mMaximum : mMinimum) * mYScale + mYOffset;
+  double top = (mNegated ? -mMinimum : mMaximum) * mYScale + mYOffset;
+  return QRectF(qMin(left, right), qMin(bottom, top), qAbs(right - left), qAbs(top - bottom));
+}
+
+/*!
+ * \brief DecimatedSeriesData::reload
+ * Reads the result file again after it is changed e.g., by a new simulation.
+ * \return
+ */
+bool DecimatedSeriesData::reload()
+{
+  mUpdated = false;
+  QString fileName = mpReader->getFileName();
+  delete mpReader;
+  mpReader = new MatResultReader(fileName);
+  bool found = mpReader->isValid() && mpReader->findVariable(mVariable, &mColumn, &mNegated);
+  mpReader->releasePages();
+  if (!found) {
+    mPyramid = MinMaxPyramid();
+    return false;
+  }
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  bool read = readPyramid();
+  QApplication::restoreOverrideCursor();
+  if (!read) {
+    mPyramid = MinMaxPyramid();
+  }
+  return read;
+}
+
+/*!
+ * \brief DecimatedSeriesData::appendSample
+ * Appends the value at row with the time of the row.
+ * \param row
+ * \param value
+ */
+void DecimatedSeriesData::appendSample(int row, double value)
+{
+  double time;
+  if (mpReader->readColumn(0, row, 1, &time)) {
+    mXValues.append(time * mXScale + mXOffset);
+    mYValues.append((mNegated ? -value : value) * mYScale + mYOffset);
+  }
+}
+
+/*!
+ * \class DecimatedPlotCurve
+ * \brief A curve of a variable from a large MATLAB v4 result file.
+ * The curve does not load the variable. The samples are decimated to the visible range every time the curve is drawn,
+ * so zooming or panning refines the curve.
+ * The curve is used for result files with at least MinimumRowsCount rows instead of OMPlot::PlotCurve which reads the whole variable.
+ */
+/*!
+ * \brief DecimatedPlotCurve::create
+ * Creates the curve of the variable.
+ * Returns 0 if the file is not a MATLAB v4 result file with at least MinimumRowsCount rows or if the variable is a parameter.
+ * \param filePath
+ * \param fileName
+ * \param variable
+ * \param displayUnit
+ * \return
+ */
+DecimatedPlotCurve* DecimatedPlotCurve::create(const QString &filePath, const QString &fileName, const QString &variable,
+                                               const QString &displayUnit)
+{
+  if (!fileName.endsWith(".mat")) {
+    return 0;
+  }
+  MatResultReader *pReader = new MatResultReader(QString("%1/%2").arg(filePath, fileName));
+  int column;
+  bool negated;
+  if (!pReader->isValid() || pReader->getRowsCount() < MinimumRowsCount || !pReader->findVariable(variable, &column, &negated)) {
+    delete pReader;
+    return 0;
+  }
+  pReader->releasePages();
+  DecimatedSeriesData *pSeriesData = new DecimatedSeriesData(pReader, variable, column, negated);
+  // the pyramid is built on the first plot of the variable
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  bool read = pSeriesData->readPyramid();
+  QApplication::restoreOverrideCursor();
+  if (!read) {
+    delete pSeriesData;
+    return 0;
+  }
+  return new DecimatedPlotCurve(pSeriesData, fileName, variable, displayUnit);
+}
+
+/*!
+ * \brief DecimatedPlotCurve::getPlotCurves
+ * Returns the decimated curves attached to the plot.
+ * \param pPlot
+ * \return
+ */
+QList<DecimatedPlotCurve*> DecimatedPlotCurve::getPlotCurves(QwtPlot *pPlot)
+{
+  QList<DecimatedPlotCurve*> plotCurves;
+  foreach (QwtPlotItem *pPlotItem, pPlot->itemList(Rtti_DecimatedPlotCurve)) {
+    plotCurves.append(static_cast<DecimatedPlotCurve*>(pPlotItem));
+  }
+  return plotCurves;
+}
+
+/*!
+ * \brief DecimatedPlotCurve::setDisplayUnit
+ * Sets the display unit and updates the title.
+ * \param displayUnit
+ */
+void DecimatedPlotCurve::setDisplayUnit(const QString &displayUnit)
+{
+  mDisplayUnit = displayUnit;
+  if (mDisplayUnit.isEmpty()) {
+    setTitle(mVariable);
+  } else {
+    setTitle(QString("%1 (%2)").arg(mVariable, mDisplayUnit));
+  }
+}
+
+/*!
+ * \brief DecimatedPlotCurve::setCurveWidth
+ * \param width
+ */
+void DecimatedPlotCurve::setCurveWidth(qreal width)
+{
+  mCurveWidth = width;
+  QPen curvePen = pen();
+  curvePen.setWidthF(width);
+  setPen(curvePen);
+}
+
+/*!
+ * \brief DecimatedPlotCurve::setCurveStyle
+ * Sets the curve style. The styles are the curve patterns of the plotting options.
+ * \param style
+ */
+void DecimatedPlotCurve::setCurveStyle(int style)
+{
+  mCurveStyle = style;
+  QPen curvePen = pen();
+  setStyle(QwtPlotCurve::Lines);
+  switch (style) {
+    case 2:
+      curvePen.setStyle(Qt::DashLine);
+      break;
+    case 3:
+      curvePen.setStyle(Qt::DotLine);
+      break;
+    case 4:
+      curvePen.setStyle(Qt::DashDotLine);
+      break;
+    case 5:
+      curvePen.setStyle(Qt::DashDotDotLine);
+      break;
+    case 6:
+      curvePen.setStyle(Qt::SolidLine);
+      setStyle(QwtPlotCurve::Sticks);
+      break;
+    case 7:
+      curvePen.setStyle(Qt::SolidLine);
+      setStyle(QwtPlotCurve::Steps);
+      break;
+    default:
+      curvePen.setStyle(Qt::SolidLine);
+      break;
+  }
+  setPen(curvePen);
+}
+
+/*!
+ * \brief DecimatedPlotCurve::setCurveColor
+ * Sets the color of the curve from a fixed list of colors.
+ * \param index - the number of curves already on the plot.
+ */
+void DecimatedPlotCurve::setCurveColor(int index)
+{
+  static const Qt::GlobalColor colors[] = {Qt::red, Qt::blue, Qt::darkGreen, Qt::magenta, Qt::darkCyan, Qt::darkYellow, Qt::black};
+  QPen curvePen = pen();
+  curvePen.setColor(colors[index % (sizeof(colors) / sizeof(colors[0]))]);
+  setPen(curvePen);
+}
+
+/*!
+ * \brief DecimatedPlotCurve::convertXValues
+ * \param offset
+ * \param scaleFactor
+ * \sa DecimatedSeriesData::convertXValues()
+ */
+void DecimatedPlotCurve::convertXValues(double offset, double scaleFactor)
+{
+  mpSeriesData->convertXValues(offset, scaleFactor);
+  itemChanged();
+}
+
+/*!
+ * \brief DecimatedPlotCurve::convertYValues
+ * \param offset
+ * \param scaleFactor
+ * \sa DecimatedSeriesData::convertYValues()
+ */
+void DecimatedPlotCurve::convertYValues(double offset, double scaleFactor)
+{
+  mpSeriesData->convertYValues(offset, scaleFactor);
+  itemChanged();
+}
+
+/*!
+ * \brief DecimatedPlotCurve::drawSeries
+ * Decimates the samples to the visible range and draws them.
+ * \param pPainter
+ * \param xMap
+ * \param yMap
+ * \param canvasRect
+ * \param from
+ * \param to
+ */
+void DecimatedPlotCurve::drawSeries(QPainter *pPainter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect,
+                                    int from, int to) const
+{
+  Q_UNUSED(from);
+  Q_UNUSED(to);
+  mpSeriesData->update(xMap.s1(), xMap.s2(), qCeil(qAbs(xMap.p2() - xMap.p1())));
+  QwtPlotCurve::drawSeries(pPainter, xMap, yMap, canvasRect, 0, -1);
+}
+
+/*!
+ * \brief DecimatedPlotCurve::DecimatedPlotCurve
+ * \param pSeriesData - the samples of the curve. The curve takes the ownership.
+ * \param fileName
+ * \param variable
+ * \param displayUnit
+ */
+DecimatedPlotCurve::DecimatedPlotCurve(DecimatedSeriesData *pSeriesData, const QString &fileName, const QString &variable,
+                                       const QString &displayUnit)
+  : QwtPlotCurve(variable), mpSeriesData(pSeriesData), mFileName(fileName), mVariable(variable),
+    mNameStructure(QString("%1.%2").arg(fileName, variable)), mCurveWidth(1), mCurveStyle(1)
+{
+  setData(pSeriesData);
+  setDisplayUnit(displayUnit);
+}
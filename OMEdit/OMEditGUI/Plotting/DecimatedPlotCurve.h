@@ -0,0 +1,113 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef DECIMATEDPLOTCURVE_H
+#define DECIMATEDPLOTCURVE_H
+
+#include "Plotting/MatResultReader.h"
+#include "OMPlot.h"
+
+#include <qwt_plot_curve.h>
+#include <qwt_series_data.h>
+
+class DecimatedSeriesData : public QwtSeriesData<QPointF>
+{
+public:
+  DecimatedSeriesData(MatResultReader *pReader, const QString &variable, int column, bool negated);
+  ~DecimatedSeriesData();
+  bool readPyramid();
+  void convertXValues(double offset, double scaleFactor);
+  void convertYValues(double offset, double scaleFactor);
+  void update(double from, double to, int width);
+  virtual size_t size() const {return mXValues.size();}
+  virtual QPointF sample(size_t i) const {return QPointF(mXValues.at(i), mYValues.at(i));}
+  virtual QRectF boundingRect() const;
+private:
+  MatResultReader *mpReader;
+  QString mVariable;
+  int mColumn;
+  bool mNegated;
+  MinMaxPyramid mPyramid;
+  double mFirstTime;
+  double mLastTime;
+  double mMinimum;
+  double mMaximum;
+  double mXScale;
+  double mXOffset;
+  double mYScale;
+  double mYOffset;
+  bool mUpdated;
+  double mFrom;
+  double mTo;
+  int mWidth;
+  QVector<double> mXValues;
+  QVector<double> mYValues;
+  bool reload();
+  void appendSample(int row, double value);
+};
+
+class DecimatedPlotCurve : public QwtPlotCurve
+{
+public:
+  enum {
+    Rtti_DecimatedPlotCurve = QwtPlotItem::Rtti_PlotUserItem + 1,
+    MinimumRowsCount = 1000000
+  };
+  static DecimatedPlotCurve* create(const QString &filePath, const QString &fileName, const QString &variable,
+                                    const QString &displayUnit);
+  static QList<DecimatedPlotCurve*> getPlotCurves(QwtPlot *pPlot);
+  QString getFileName() const {return mFileName;}
+  QString getNameStructure() const {return mNameStructure;}
+  QString getDisplayUnit() const {return mDisplayUnit;}
+  void setDisplayUnit(const QString &displayUnit);
+  qreal getCurveWidth() const {return mCurveWidth;}
+  void setCurveWidth(qreal width);
+  int getCurveStyle() const {return mCurveStyle;}
+  void setCurveStyle(int style);
+  void setCurveColor(int index);
+  void convertXValues(double offset, double scaleFactor);
+  void convertYValues(double offset, double scaleFactor);
+  virtual int rtti() const {return Rtti_DecimatedPlotCurve;}
+protected:
+  virtual void drawSeries(QPainter *pPainter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect, int from,
+                          int to) const;
+private:
+  DecimatedPlotCurve(DecimatedSeriesData *pSeriesData, const QString &fileName, const QString &variable, const QString &displayUnit);
+  DecimatedSeriesData *mpSeriesData;
+  QString mFileName;
+  QString mVariable;
+  QString mNameStructure;
+  QString mDisplayUnit;
+  qreal mCurveWidth;
+  int mCurveStyle;
+};
+
+#endif // DECIMATEDPLOTCURVE_H
@@ -0,0 +1,592 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "MatResultReader.h"
+
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QSysInfo>
+#include <qmath.h>
+
+/* The result file is mapped in windows of PageSize bytes and at most MaximumPagesCount windows are kept mapped. */
+static const qint64 PageSize = 4 * 1024 * 1024;
+static const int MaximumPagesCount = 16;
+
+/*!
+ * \class MatResultReader
+ * \brief Reads the continuous variables of a MATLAB v4 result file.
+ * The file is mapped page by page when the values are read so only the pages holding the requested rows are loaded.
+ * The pages are released with releasePages() which also closes the file so that a new simulation can overwrite it.
+ */
+/*!
+ * \brief MatResultReader::MatResultReader
+ * \param fileName
+ */
+MatResultReader::MatResultReader(const QString &fileName)
+  : mFileName(fileName), mFile(fileName), mFileSize(0), mValid(false), mTransposed(false), mNamesOffset(0), mNameLength(0),
+    mDataInfoOffset(0), mVariablesCount(0), mDataOffset(0), mElementSize(8), mRowsCount(0), mColumnsCount(0)
+{
+  QFileInfo fileInfo(fileName);
+  mFileSize = fileInfo.size();
+  mLastModified = fileInfo.lastModified();
+  mValid = readMatrices();
+  releasePages();
+}
+
+MatResultReader::~MatResultReader()
+{
+  releasePages();
+}
+
+/*!
+ * \brief MatResultReader::isModified
+ * Returns true if the result file is changed since it was read.
+ * \return
+ */
+bool MatResultReader::isModified() const
+{
+  QFileInfo fileInfo(mFileName);
+  return fileInfo.size() != mFileSize || fileInfo.lastModified() != mLastModified;
+}
+
+/*!
+ * \brief MatResultReader::findVariable
+ * Finds the column of the variable in the data_2 matrix.
+ * Returns false if the variable is not found or is a parameter.
+ * \param name
+ * \param pColumn - the 0-based column.
+ * \param pNegated - true if the variable is a negated alias of the column.
+ * \return
+ */
+bool MatResultReader::findVariable(const QString &name, int *pColumn, bool *pNegated)
+{
+  if (!mValid) {
+    return false;
+  }
+  if (mVariables.isEmpty()) {
+    readVariableNames();
+  }
+  QHash<QString, int>::const_iterator iterator = mVariables.find(name);
+  if (iterator == mVariables.end()) {
+    return false;
+  }
+  // the first two rows of dataInfo are the data set and the signed 1-based column of the variable.
+  qint32 dataSet, column;
+  qint64 dataSetOffset, columnOffset;
+  if (mTransposed) {
+    dataSetOffset = mDataInfoOffset + (qint64)iterator.value() * 4 * sizeof(qint32);
+    columnOffset = dataSetOffset + sizeof(qint32);
+  } else {
+    dataSetOffset = mDataInfoOffset + (qint64)iterator.value() * sizeof(qint32);
+    columnOffset = dataSetOffset + (qint64)mVariablesCount * sizeof(qint32);
+  }
+  if (!readBytes(dataSetOffset, (char*)&dataSet, sizeof(qint32)) || !readBytes(columnOffset, (char*)&column, sizeof(qint32))) {
+    return false;
+  }
+  // data set 1 is data_1 which holds the parameters. The time has data set 0 and is stored in data_2.
+  if (dataSet == 1 || column == 0 || qAbs(column) > mColumnsCount) {
+    return false;
+  }
+  *pColumn = qAbs(column) - 1;
+  *pNegated = column < 0;
+  return true;
+}
+
+/*!
+ * \brief MatResultReader::readColumn
+ * Reads count values of the column starting at firstRow.
+ * \param column
+ * \param firstRow
+ * \param count
+ * \param pValues
+ * \return
+ */
+bool MatResultReader::readColumn(int column, int firstRow, int count, double *pValues)
+{
+  if (!mValid || column < 0 || column >= mColumnsCount || firstRow < 0 || count < 0 || (qint64)firstRow + count > mRowsCount) {
+    return false;
+  }
+  // the values of a time point are stored together in transposed files, otherwise the values of a variable.
+  qint64 index = mTransposed ? (qint64)firstRow * mColumnsCount + column : (qint64)column * mRowsCount + firstRow;
+  qint64 offset = mDataOffset + index * mElementSize;
+  qint64 stride = mTransposed ? (qint64)mColumnsCount * mElementSize : mElementSize;
+  if (!mTransposed && mElementSize == sizeof(double)) {
+    return readBytes(offset, (char*)pValues, (qint64)count * sizeof(double));
+  }
+  for (int i = 0 ; i < count ; i++, offset += stride) {
+    if (mElementSize == sizeof(double)) {
+      if (!readBytes(offset, (char*)(pValues + i), sizeof(double))) {
+        return false;
+      }
+    } else {
+      float value;
+      if (!readBytes(offset, (char*)&value, sizeof(float))) {
+        return false;
+      }
+      pValues[i] = value;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief MatResultReader::lowerBoundRow
+ * Returns the first row whose time is not less than time or the number of rows if there is no such row.
+ * The time is the first column of data_2.
+ * \param time
+ * \return
+ */
+int MatResultReader::lowerBoundRow(double time)
+{
+  int low = 0;
+  int high = mRowsCount;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    double value;
+    if (!readColumn(0, middle, 1, &value)) {
+      break;
+    }
+    if (value < time) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/*!
+ * \brief MatResultReader::releasePages
+ * Unmaps all the pages and closes the file.
+ */
+void MatResultReader::releasePages()
+{
+  foreach (Page page, mPages) {
+    mFile.unmap(page.mpData);
+  }
+  mPages.clear();
+  mFile.close();
+}
+
+/*!
+ * \brief MatResultReader::readMatrices
+ * Reads the headers of the matrices in the file and remembers where the variable names, the data information and data_2 are.
+ * \return
+ */
+bool MatResultReader::readMatrices()
+{
+  bool namesFound = false;
+  bool dataInfoFound = false;
+  qint64 offset = 0;
+  while (offset + 5 * (qint64)sizeof(qint32) <= mFileSize) {
+    // type, rows, columns, imaginary flag and the length of the name.
+    qint32 header[5];
+    if (!readBytes(offset, (char*)header, sizeof(header))) {
+      return false;
+    }
+    qint32 type = header[0];
+    if (type < 0 || type >= 2000 || header[1] < 0 || header[2] < 0 || header[3] != 0 || header[4] <= 0 || header[4] > 256) {
+      return false;
+    }
+    // the thousands digit of the type is the byte order. Only files written with the byte order of this machine are read.
+    if ((type / 1000) != (QSysInfo::ByteOrder == QSysInfo::LittleEndian ? 0 : 1)) {
+      return false;
+    }
+    int elementSize;
+    int precision = (type % 100) / 10;
+    switch (precision) {
+      case 0:
+        elementSize = 8;
+        break;
+      case 1:
+      case 2:
+        elementSize = 4;
+        break;
+      case 3:
+      case 4:
+        elementSize = 2;
+        break;
+      case 5:
+        elementSize = 1;
+        break;
+      default:
+        return false;
+    }
+    QByteArray name(header[4], '\0');
+    if (!readBytes(offset + sizeof(header), name.data(), header[4])) {
+      return false;
+    }
+    name = QByteArray(name.constData());
+    qint64 rows = header[1];
+    qint64 columns = header[2];
+    qint64 dataOffset = offset + sizeof(header) + header[4];
+    qint64 dataSize = rows * columns * elementSize;
+    if (dataOffset + dataSize > mFileSize) {
+      return false;
+    }
+    if (name == "Aclass") {
+      // the fourth line of Aclass is binTrans or binNormal. The lines are stored column wise.
+      QByteArray aclass((int)dataSize, '\0');
+      if (!readBytes(dataOffset, aclass.data(), dataSize)) {
+        return false;
+      }
+      QByteArray storage;
+      for (qint64 i = 0 ; rows >= 4 && i < columns ; i++) {
+        storage.append(aclass.at(i * rows + 3));
+      }
+      mTransposed = storage.startsWith("binTrans");
+    } else if (name == "name" && elementSize == 1) {
+      mNamesOffset = dataOffset;
+      mNameLength = mTransposed ? rows : columns;
+      mVariablesCount = mTransposed ? columns : rows;
+      namesFound = true;
+    } else if (name == "dataInfo" && precision == 2 && rows * columns == 4 * (qint64)mVariablesCount) {
+      mDataInfoOffset = dataOffset;
+      dataInfoFound = true;
+    } else if (name == "data_2" && (precision == 0 || precision == 1)) {
+      mDataOffset = dataOffset;
+      mElementSize = elementSize;
+      mColumnsCount = mTransposed ? rows : columns;
+      mRowsCount = mTransposed ? columns : rows;
+      return namesFound && dataInfoFound && mRowsCount > 0 && mColumnsCount > 0;
+    }
+    offset = dataOffset + dataSize;
+  }
+  return false;
+}
+
+/*!
+ * \brief MatResultReader::readVariableNames
+ * Reads the variable names and maps them to their index in the name and dataInfo matrices.
+ */
+void MatResultReader::readVariableNames()
+{
+  QByteArray names(mNameLength * mVariablesCount, '\0');
+  if (!readBytes(mNamesOffset, names.data(), names.size())) {
+    return;
+  }
+  QByteArray name;
+  for (int i = 0 ; i < mVariablesCount ; i++) {
+    name.clear();
+    for (int j = 0 ; j < mNameLength ; j++) {
+      char character = mTransposed ? names.at(i * mNameLength + j) : names.at(j * mVariablesCount + i);
+      if (character == '\0') {
+        break;
+      }
+      name.append(character);
+    }
+    QString variable = QString::fromUtf8(name.trimmed());
+    if (!mVariables.contains(variable)) {
+      mVariables.insert(variable, i);
+    }
+  }
+}
+
+/*!
+ * \brief MatResultReader::getPage
+ * Returns the mapped page and its size. Maps the page if it is not mapped yet and unmaps the least recently used page.
+ * \param index
+ * \param pSize
+ * \return
+ */
+const uchar* MatResultReader::getPage(qint64 index, qint64 *pSize)
+{
+  for (int i = 0 ; i < mPages.size() ; i++) {
+    if (mPages.at(i).mIndex == index) {
+      if (i > 0) {
+        mPages.move(i, 0);
+      }
+      *pSize = mPages.first().mSize;
+      return mPages.first().mpData;
+    }
+  }
+  if (!mFile.isOpen() && !mFile.open(QIODevice::ReadOnly)) {
+    return 0;
+  }
+  Page page;
+  page.mIndex = index;
+  page.mSize = qMin(PageSize, mFileSize - index * PageSize);
+  if (page.mSize <= 0) {
+    return 0;
+  }
+  page.mpData = mFile.map(index * PageSize, page.mSize);
+  if (!page.mpData) {
+    return 0;
+  }
+  mPages.prepend(page);
+  if (mPages.size() > MaximumPagesCount) {
+    mFile.unmap(mPages.takeLast().mpData);
+  }
+  *pSize = page.mSize;
+  return page.mpData;
+}
+
+/*!
+ * \brief MatResultReader::readBytes
+ * Copies size bytes starting at offset from the mapped pages to pData.
+ * \param offset
+ * \param pData
+ * \param size
+ * \return
+ */
+bool MatResultReader::readBytes(qint64 offset, char *pData, qint64 size)
+{
+  while (size > 0) {
+    qint64 index = offset / PageSize;
+    qint64 pageSize;
+    const uchar *pPage = getPage(index, &pageSize);
+    if (!pPage) {
+      return false;
+    }
+    qint64 position = offset - index * PageSize;
+    qint64 length = qMin(size, pageSize - position);
+    if (length <= 0) {
+      return false;
+    }
+    memcpy(pData, pPage + position, length);
+    pData += length;
+    offset += length;
+    size -= length;
+  }
+  return true;
+}
+
+/*!
+ * \class MinMaxPyramid
+ * \brief Minimum and maximum of a result column over buckets of rows.
+ * The finest level has buckets of BaseBucketSize rows and each following level combines Fanout buckets of the previous level.
+ * The row of each minimum and maximum is kept so that a curve drawn from a level shows the extremes at their time.
+ */
+MinMaxPyramid::MinMaxPyramid()
+{
+
+}
+
+/*!
+ * \brief MinMaxPyramid::findLevel
+ * Returns the finest level which covers rowsCount rows with at most bucketsCount buckets or the coarsest level.
+ * \param rowsCount
+ * \param bucketsCount
+ * \return
+ */
+int MinMaxPyramid::findLevel(int rowsCount, int bucketsCount) const
+{
+  for (int i = 0 ; i < mLevels.size() ; i++) {
+    if ((qint64)mLevels.at(i).mBucketSize * qMax(bucketsCount, 1) >= rowsCount) {
+      return i;
+    }
+  }
+  return mLevels.size() - 1;
+}
+
+/*!
+ * \brief MinMaxPyramid::read
+ * Reads the pyramid of the column from the cache file beside the result file.
+ * Builds it from the result file and writes the cache file if there is no valid cache file.
+ * \param pReader
+ * \param column
+ * \return
+ */
+bool MinMaxPyramid::read(MatResultReader *pReader, int column)
+{
+  QString fileName = getCacheFileName(pReader->getFileName(), column);
+  if (load(fileName, pReader, column)) {
+    return true;
+  }
+  if (!build(pReader, column)) {
+    return false;
+  }
+  save(fileName, pReader, column);
+  return true;
+}
+
+/*!
+ * \brief MinMaxPyramid::getCacheFileName
+ * Returns the cache file of the column. The cache files of a result file are kept in the directory <result file>.minmax.
+ * \param resultFileName
+ * \param column
+ * \return
+ */
+QString MinMaxPyramid::getCacheFileName(const QString &resultFileName, int column)
+{
+  QFileInfo fileInfo(resultFileName);
+  return QString("%1/%2.minmax/%3.bin").arg(fileInfo.absolutePath()).arg(fileInfo.fileName()).arg(column);
+}
+
+/*!
+ * \brief MinMaxPyramid::build
+ * Builds the pyramid by reading the column once.
+ * \param pReader
+ * \param column
+ * \return
+ */
+bool MinMaxPyramid::build(MatResultReader *pReader, int column)
+{
+  mLevels.clear();
+  int rowsCount = pReader->getRowsCount();
+  int bucketsCount = (rowsCount + BaseBucketSize - 1) / BaseBucketSize;
+  MinMaxLevel level;
+  level.mBucketSize = BaseBucketSize;
+  level.mMinimum.resize(bucketsCount);
+  level.mMaximum.resize(bucketsCount);
+  level.mMinimumRow.resize(bucketsCount);
+  level.mMaximumRow.resize(bucketsCount);
+  double *pMinimum = level.mMinimum.data();
+  double *pMaximum = level.mMaximum.data();
+  qint32 *pMinimumRow = level.mMinimumRow.data();
+  qint32 *pMaximumRow = level.mMaximumRow.data();
+  QVector<double> values(BaseBucketSize * 1024);
+  for (int firstRow = 0 ; firstRow < rowsCount ; firstRow += values.size()) {
+    int count = qMin(values.size(), rowsCount - firstRow);
+    if (!pReader->readColumn(column, firstRow, count, values.data())) {
+      pReader->releasePages();
+      return false;
+    }
+    for (int i = 0 ; i < count ; i++) {
+      int row = firstRow + i;
+      int bucket = row / BaseBucketSize;
+      double value = values.at(i);
+      if (row % BaseBucketSize == 0) {
+        pMinimum[bucket] = pMaximum[bucket] = value;
+        pMinimumRow[bucket] = pMaximumRow[bucket] = row;
+        continue;
+      }
+      if (value < pMinimum[bucket] || qIsNaN(pMinimum[bucket])) {
+        pMinimum[bucket] = value;
+        pMinimumRow[bucket] = row;
+      }
+      if (value > pMaximum[bucket] || qIsNaN(pMaximum[bucket])) {
+        pMaximum[bucket] = value;
+        pMaximumRow[bucket] = row;
+      }
+    }
+  }
+  pReader->releasePages();
+  mLevels.append(level);
+  while (mLevels.last().mMinimum.size() > 1) {
+    const MinMaxLevel finerLevel = mLevels.last();
+    MinMaxLevel coarserLevel;
+    coarserLevel.mBucketSize = finerLevel.mBucketSize * Fanout;
+    bucketsCount = (finerLevel.mMinimum.size() + Fanout - 1) / Fanout;
+    coarserLevel.mMinimum.resize(bucketsCount);
+    coarserLevel.mMaximum.resize(bucketsCount);
+    coarserLevel.mMinimumRow.resize(bucketsCount);
+    coarserLevel.mMaximumRow.resize(bucketsCount);
+    for (int bucket = 0 ; bucket < bucketsCount ; bucket++) {
+      int first = bucket * Fanout;
+      int last = qMin(first + Fanout, finerLevel.mMinimum.size());
+      coarserLevel.mMinimum[bucket] = finerLevel.mMinimum.at(first);
+      coarserLevel.mMinimumRow[bucket] = finerLevel.mMinimumRow.at(first);
+      coarserLevel.mMaximum[bucket] = finerLevel.mMaximum.at(first);
+      coarserLevel.mMaximumRow[bucket] = finerLevel.mMaximumRow.at(first);
+      for (int i = first + 1 ; i < last ; i++) {
+        if (finerLevel.mMinimum.at(i) < coarserLevel.mMinimum.at(bucket) || qIsNaN(coarserLevel.mMinimum.at(bucket))) {
+          coarserLevel.mMinimum[bucket] = finerLevel.mMinimum.at(i);
+          coarserLevel.mMinimumRow[bucket] = finerLevel.mMinimumRow.at(i);
+        }
+        if (finerLevel.mMaximum.at(i) > coarserLevel.mMaximum.at(bucket) || qIsNaN(coarserLevel.mMaximum.at(bucket))) {
+          coarserLevel.mMaximum[bucket] = finerLevel.mMaximum.at(i);
+          coarserLevel.mMaximumRow[bucket] = finerLevel.mMaximumRow.at(i);
+        }
+      }
+    }
+    mLevels.append(coarserLevel);
+  }
+  return true;
+}
+
+/*!
+ * \brief MinMaxPyramid::load
+ * Loads the pyramid from the cache file.
+ * Returns false if the cache file does not exist or was written for another version of the result file.
+ * \param fileName
+ * \param pReader
+ * \param column
+ * \return
+ */
+bool MinMaxPyramid::load(const QString &fileName, MatResultReader *pReader, int column)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_4_6);
+  quint32 magic, version;
+  qint64 fileSize, lastModified;
+  qint32 rowsCount, cachedColumn, levelsCount;
+  stream >> magic >> version >> fileSize >> lastModified >> rowsCount >> cachedColumn >> levelsCount;
+  if (stream.status() != QDataStream::Ok || magic != 0x4F4D4D4D || version != 1 || fileSize != pReader->getFileSize()
+      || lastModified != pReader->getLastModified().toMSecsSinceEpoch() || rowsCount != pReader->getRowsCount() || cachedColumn != column
+      || levelsCount <= 0) {
+    return false;
+  }
+  mLevels.clear();
+  for (int i = 0 ; i < levelsCount ; i++) {
+    MinMaxLevel level;
+    stream >> level.mBucketSize >> level.mMinimum >> level.mMaximum >> level.mMinimumRow >> level.mMaximumRow;
+    if (stream.status() != QDataStream::Ok || level.mMaximum.size() != level.mMinimum.size()
+        || level.mMinimumRow.size() != level.mMinimum.size() || level.mMaximumRow.size() != level.mMinimum.size()) {
+      mLevels.clear();
+      return false;
+    }
+    mLevels.append(level);
+  }
+  return true;
+}
+
+/*!
+ * \brief MinMaxPyramid::save
+ * Writes the pyramid to the cache file.
+ * \param fileName
+ * \param pReader
+ * \param column
+ * \return
+ */
+bool MinMaxPyramid::save(const QString &fileName, MatResultReader *pReader, int column) const
+{
+  if (!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+    return false;
+  }
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return false;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_4_6);
+  stream << (quint32)0x4F4D4D4D << (quint32)1 << pReader->getFileSize() << pReader->getLastModified().toMSecsSinceEpoch()
+         << (qint32)pReader->getRowsCount() << (qint32)column << (qint32)mLevels.size();
+  foreach (MinMaxLevel level, mLevels) {
+    stream << level.mBucketSize << level.mMinimum << level.mMaximum << level.mMinimumRow << level.mMaximumRow;
+  }
+  return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef MATRESULTREADER_H
+#define MATRESULTREADER_H
+
+#include <QFile>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+class MatResultReader
+{
+public:
+  MatResultReader(const QString &fileName);
+  ~MatResultReader();
+  bool isValid() const {return mValid;}
+  QString getFileName() const {return mFileName;}
+  qint64 getFileSize() const {return mFileSize;}
+  QDateTime getLastModified() const {return mLastModified;}
+  int getRowsCount() const {return mRowsCount;}
+  bool isModified() const;
+  bool findVariable(const QString &name, int *pColumn, bool *pNegated);
+  bool readColumn(int column, int firstRow, int count, double *pValues);
+  int lowerBoundRow(double time);
+  void releasePages();
+private:
+  class Page
+  {
+  public:
+    qint64 mIndex;
+    uchar *mpData;
+    qint64 mSize;
+  };
+  QString mFileName;
+  QFile mFile;
+  qint64 mFileSize;
+  QDateTime mLastModified;
+  bool mValid;
+  bool mTransposed;
+  qint64 mNamesOffset;
+  int mNameLength;
+  qint64 mDataInfoOffset;
+  int mVariablesCount;
+  QHash<QString, int> mVariables;
+  qint64 mDataOffset;
+  int mElementSize;
+  int mRowsCount;
+  int mColumnsCount;
+  QList<Page> mPages;
+  bool readMatrices();
+  void readVariableNames();
+  const uchar* getPage(qint64 index, qint64 *pSize);
+  bool readBytes(qint64 offset, char *pData, qint64 size);
+};
+
+class MinMaxLevel
+{
+public:
+  int mBucketSize;
+  QVector<double> mMinimum;
+  QVector<double> mMaximum;
+  QVector<qint32> mMinimumRow;
+  QVector<qint32> mMaximumRow;
+};
+
+class MinMaxPyramid
+{
+public:
+  enum {
+    BaseBucketSize = 256,
+    Fanout = 4
+  };
+  MinMaxPyramid();
+  bool isEmpty() const {return mLevels.isEmpty();}
+  int getLevelsCount() const {return mLevels.size();}
+  const MinMaxLevel& getLevel(int level) const {return mLevels.at(level);}
+  int findLevel(int rowsCount, int bucketsCount) const;
+  bool read(MatResultReader *pReader, int column);
+  static QString getCacheFileName(const QString &resultFileName, int column);
+private:
+  QList<MinMaxLevel> mLevels;
+  bool build(MatResultReader *pReader, int column);
+  bool load(const QString &fileName, MatResultReader *pReader, int column);
+  bool save(const QString &fileName, MatResultReader *pReader, int column) const;
+};
+
+#endif // MATRESULTREADER_H
@@ -38,6 +38,7 @@
 #include "Modeling/ModelWidgetContainer.h"
 #include "Modeling/MessagesWidget.h"
 #include "Plotting/VariablesWidget.h"
+#include "Plotting/DecimatedPlotCurve.h"
 
 using namespace OMPlot;
 
@@ -241,6 +242,7 @@ void PlotWindowContainer::clearPlotWindow()
     pPlotCurve->detach();
     i = 0;   //Restart iteration
   }
+  qDeleteAll(DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot()));
   pPlotWindow->fitInView();
   MainWindow::instance()->getVariablesWidget()->updateVariablesTreeHelper(subWindowList(QMdiArea::ActivationHistoryOrder).last());
 }
@@ -257,6 +259,13 @@ void PlotWindowContainer::exportVariables()
                              tr("No plot window is active for exporting variables."), Helper::ok);
     return;
   }
+  // the variables of large result files are drawn decimated and are not exported.
+  if (!DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot()).isEmpty()) {
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                          tr("The variables of result files with %1 or more rows are not exported.")
+                                                          .arg(DecimatedPlotCurve::MinimumRowsCount), Helper::scriptingKind,
+                                                          Helper::warningLevel));
+  }
   if (pPlotWindow->getPlot()->getPlotCurvesList().isEmpty()) {
     QMessageBox::information(this, QString(Helper::applicationName).append(" - ").append(Helper::information),
                              tr("No variables are selected for exporting."), Helper::ok);
@@ -317,6 +326,17 @@ void PlotWindowContainer::updatePlotWindows(QString variable)
           }
         }
       }
+      foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+        if (variable.compare(pDecimatedPlotCurve->getFileName()) == 0) {
+          pDecimatedPlotCurve->detach();
+          delete pDecimatedPlotCurve;
+          if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+            pPlotWindow->fitInView();
+          } else {
+            pPlotWindow->getPlot()->replot();
+          }
+        }
+      }
     } // is plotWidget
   }
 }
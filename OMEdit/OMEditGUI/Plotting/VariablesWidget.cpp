@@ -39,6 +39,7 @@
 #include "Modeling/MessagesWidget.h"
 #include "util/read_matlab4.h"
 #include "Plotting/PlotWindowContainer.h"
+#include "Plotting/DecimatedPlotCurve.h"
 #include "Simulation/SimulationDialog.h"
 
 #include <QObject>
@@ -398,35 +399,37 @@ Qt::ItemFlags VariablesTreeModel::flags(const QModelIndex &index) const
   return flags;
 }
 
+/*!
+ * \brief VariablesTreeModel::findVariablesTreeItem
+ * Finds the VariablesTreeItem by its name using the variables hash.
+ * \param name - the variable name e.g., model_res.mat.a.b
+ * \param root - the item is only returned if it is root or one of its descendants.
+ * \return
+ */
 VariablesTreeItem* VariablesTreeModel::findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const
 {
-  if (root->getVariableName() == name)
+  if (root->getVariableName() == name) {
     return root;
-  for (int i = root->getChildren().size(); --i >= 0; )
-    if (VariablesTreeItem *item = findVariablesTreeItem(name, root->getChildren().at(i)))
-      return item;
-  return 0;
+  }
+  VariablesTreeItem *pVariablesTreeItem = mVariablesTreeItemsHash.value(name, 0);
+  if (pVariablesTreeItem && root != mpRootVariablesTreeItem) {
+    VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem->parent();
+    while (pParentVariablesTreeItem && pParentVariablesTreeItem != root) {
+      pParentVariablesTreeItem = pParentVariablesTreeItem->parent();
+    }
+    if (!pParentVariablesTreeItem) {
+      return 0;
+    }
+  }
+  return pVariablesTreeItem;
 }
 
 QModelIndex VariablesTreeModel::variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const
 {
-  return variablesTreeItemIndexHelper(pVariablesTreeItem, mpRootVariablesTreeItem, QModelIndex());
-}
-
-QModelIndex VariablesTreeModel::variablesTreeItemIndexHelper(const VariablesTreeItem *pVariablesTreeItem,
-                                                             const VariablesTreeItem *pParentVariablesTreeItem,
-                                                             const QModelIndex &parentIndex) const
-{
-  if (pVariablesTreeItem == pParentVariablesTreeItem)
-    return parentIndex;
-  for (int i = pParentVariablesTreeItem->getChildren().size(); --i >= 0; ) {
-    const VariablesTreeItem *childItem = pParentVariablesTreeItem->getChildren().at(i);
-    QModelIndex childIndex = index(i, 0, parentIndex);
-    QModelIndex index = variablesTreeItemIndexHelper(pVariablesTreeItem, childItem, childIndex);
-    if (index.isValid())
-      return index;
+  if (!pVariablesTreeItem || pVariablesTreeItem == mpRootVariablesTreeItem) {
+    return QModelIndex();
   }
-  return QModelIndex();
+  return createIndex(pVariablesTreeItem->row(), 0, const_cast<VariablesTreeItem*>(pVariablesTreeItem));
 }
 
 void VariablesTreeModel::parseInitXml(QXmlStreamReader &xmlReader)
@@ -500,12 +503,10 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
   QVector<QVariant> Variabledata;
   Variabledata << filePath << fileName << fileName << text << "" << "" << "" << QStringList() << "" << toolTip;
 
+  /* The whole result tree is built before it is added to the model so that the views are notified only once. */
   VariablesTreeItem *pTopVariablesTreeItem = new VariablesTreeItem(Variabledata, mpRootVariablesTreeItem, true);
   pTopVariablesTreeItem->setSimulationOptions(simulationOptions);
-  int row = rowCount();
-  beginInsertRows(index, row, row);
-  mpRootVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
-  endInsertRows();
+  mVariablesTreeItemsHash.insert(pTopVariablesTreeItem->getVariableName(), pTopVariablesTreeItem);
   /* open the model_init.xml file for reading */
   if (simulationOptions.isValid()) {
     QString initFileName = QString(simulationOptions.getOutputFileName()).append("_init.xml");
@@ -575,7 +576,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
           findVariable = QString("%1.%2.%3").arg(fileName, parentVariable, variable);
         }
       }
-      if ((pParentVariablesTreeItem = findVariablesTreeItem(findVariable, pParentVariablesTreeItem)) != NULL) {
+      if ((pParentVariablesTreeItem = mVariablesTreeItemsHash.value(findVariable, 0)) != NULL) {
         if (count == 1) {
           parentVariable = variable;
         } else {
@@ -588,11 +589,10 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
        * If loop iteration is not first and pParentVariablesTreeItem is 0 then find the parent item.
        */
       if (!pParentVariablesTreeItem && count > 1) {
-        pParentVariablesTreeItem = findVariablesTreeItem(fileName + "." + parentVariable, pTopVariablesTreeItem);
+        pParentVariablesTreeItem = mVariablesTreeItemsHash.value(fileName + "." + parentVariable, 0);
       } else {
         pParentVariablesTreeItem = pTopVariablesTreeItem;
       }
-      QModelIndex index = variablesTreeItemIndex(pParentVariablesTreeItem);
       QVector<QVariant> variableData;
       /* if last item */
       if (variables.size() == count && plotVariable.startsWith("der(")) {
@@ -644,10 +644,8 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       variableData << tr("File: %1/%2\nVariable: %3").arg(filePath).arg(fileName).arg(variableToFind);
       VariablesTreeItem *pVariablesTreeItem = new VariablesTreeItem(variableData, pParentVariablesTreeItem);
       pVariablesTreeItem->setEditable(changeAble);
-      int row = rowCount(index);
-      beginInsertRows(index, row, row);
-      pParentVariablesTreeItem->insertChild(row, pVariablesTreeItem);
-      endInsertRows();
+      pParentVariablesTreeItem->insertChild(pParentVariablesTreeItem->getChildren().size(), pVariablesTreeItem);
+      mVariablesTreeItemsHash.insert(pVariablesTreeItem->getVariableName(), pVariablesTreeItem);
       if (count == 1) {
         parentVariable = variable;
       } else {
@@ -662,6 +660,10 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       omc_free_matlab4_reader(&matReader);
     }
   }
+  int row = rowCount();
+  beginInsertRows(index, row, row);
+  mpRootVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
+  endInsertRows();
   mpVariablesTreeView->collapseAll();
   QModelIndex idx = variablesTreeItemIndex(pTopVariablesTreeItem);
   idx = mpVariablesTreeView->getVariablesWidget()->getVariableTreeProxyModel()->mapFromSource(idx);
@@ -685,6 +687,7 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
 {
   VariablesTreeItem *pVariablesTreeItem = findVariablesTreeItem(variable, mpRootVariablesTreeItem);
   if (pVariablesTreeItem) {
+    removeVariablesTreeItemsFromHash(pVariablesTreeItem);
     beginRemoveRows(variablesTreeItemIndex(pVariablesTreeItem), 0, pVariablesTreeItem->getChildren().size());
     pVariablesTreeItem->removeChildren();
     VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem->parent();
@@ -697,6 +700,21 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
   return false;
 }
 
+/*!
+ * \brief VariablesTreeModel::removeVariablesTreeItemsFromHash
+ * Removes the VariablesTreeItem and all its children from the variables hash.
+ * \param pVariablesTreeItem
+ */
+void VariablesTreeModel::removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem)
+{
+  if (mVariablesTreeItemsHash.value(pVariablesTreeItem->getVariableName()) == pVariablesTreeItem) {
+    mVariablesTreeItemsHash.remove(pVariablesTreeItem->getVariableName());
+  }
+  foreach (VariablesTreeItem *pChildVariablesTreeItem, pVariablesTreeItem->getChildren()) {
+    removeVariablesTreeItemsFromHash(pChildVariablesTreeItem);
+  }
+}
+
 void VariablesTreeModel::unCheckVariables(VariablesTreeItem *pVariablesTreeItem)
 {
   QList<VariablesTreeItem*> items = pVariablesTreeItem->getChildren();
@@ -754,8 +772,15 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
           qDebug() << QString("%1 not found in %2").arg(variableToFind).arg(pMatReader->fileName);
         }
         double res;
-        if (var && !omc_matlab4_val(&res, pMatReader, var, omc_matlab4_stopTime(pMatReader))) {
+        /* omc_matlab4_val reads and keeps the whole column of the variable in memory which for large result files means reading
+         * the whole file just to fill the Variables Browser. Read only the last row of the variable instead.
+         * var->index is 1-based and negative for negated aliases while omc_matlab4_read_single_val expects the 0-based column.
+         */
+        if (var && var->isParam && !omc_matlab4_val(&res, pMatReader, var, omc_matlab4_stopTime(pMatReader))) {
           *value = QString::number(res);
+        } else if (var && !var->isParam && pMatReader->nrows > 0
+                   && !omc_matlab4_read_single_val(&res, pMatReader, qAbs(var->index) - 1, pMatReader->nrows - 1)) {
+          *value = QString::number(var->index < 0 ? -res : res);
         }
       }
     }
@@ -1034,6 +1059,14 @@ void VariablesWidget::variablesUpdated()
           }
         }
       }
+      // the decimated curves read the updated result file when they are drawn.
+      foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+        if (!mpVariablesTreeModel->findVariablesTreeItem(pDecimatedPlotCurve->getNameStructure(),
+                                                         mpVariablesTreeModel->getRootVariablesTreeItem())) {
+          pDecimatedPlotCurve->detach();
+          delete pDecimatedPlotCurve;
+        }
+      }
       if (pPlotWindow->getAutoScaleButton()->isChecked()) {
         pPlotWindow->fitInView();
       } else {
@@ -1084,6 +1117,13 @@ void VariablesWidget::updateVariablesTreeHelper(QMdiSubWindow *pSubWindow)
           mpVariablesTreeModel->setData(mpVariablesTreeModel->variablesTreeItemIndex(pVariablesTreeItem), Qt::Checked, Qt::CheckStateRole);
       }
     }
+    foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+      VariablesTreeItem *pVariablesTreeItem = mpVariablesTreeModel->findVariablesTreeItem(pDecimatedPlotCurve->getNameStructure(),
+                                                                                          mpVariablesTreeModel->getRootVariablesTreeItem());
+      if (pVariablesTreeItem) {
+        mpVariablesTreeModel->setData(mpVariablesTreeModel->variablesTreeItemIndex(pVariablesTreeItem), Qt::Checked, Qt::CheckStateRole);
+      }
+    }
     mpVariablesTreeModel->blockSignals(state);
   }
   /* invalidate the view so that the items show the updated values. */
@@ -1252,6 +1292,10 @@ void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickne
     if (pPlotWindow->getPlotType() == PlotWindow::PLOT) {
       // check the item checkstate
       if (pVariablesTreeItem->isChecked()) {
+        // variables of large result files are not loaded by OMPlot but drawn decimated.
+        if (!pPlotCurve && plotDecimatedVariable(pVariablesTreeItem, curveThickness, curveStyle, pPlotWindow)) {
+          return;
+        }
         pPlotWindow->initializeFile(QString(pVariablesTreeItem->getFilePath()).append("/").append(pVariablesTreeItem->getFileName()));
         pPlotWindow->setCurveWidth(curveThickness);
         pPlotWindow->setCurveStyle(curveStyle);
@@ -1320,6 +1364,18 @@ void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickne
             break;
           }
         }
+        foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+          if (pDecimatedPlotCurve->getNameStructure().compare(pVariablesTreeItem->getVariableName()) == 0) {
+            pDecimatedPlotCurve->detach();
+            delete pDecimatedPlotCurve;
+            if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+              pPlotWindow->fitInView();
+            } else {
+              pPlotWindow->getPlot()->replot();
+            }
+            break;
+          }
+        }
       }
     } else {  // if plottype is PLOTPARAMETRIC then
       // check the item checkstate
@@ -1450,6 +1506,64 @@ void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickne
   }
 }
 
+/*!
+ * \brief VariablesWidget::plotDecimatedVariable
+ * Plots the variable with a DecimatedPlotCurve if it is from a large MATLAB v4 result file.
+ * Returns false if the variable should be plotted by OMPlot.
+ * \param pVariablesTreeItem
+ * \param curveThickness
+ * \param curveStyle
+ * \param pPlotWindow
+ * \return
+ */
+bool VariablesWidget::plotDecimatedVariable(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle,
+                                            PlotWindow *pPlotWindow)
+{
+  DecimatedPlotCurve *pDecimatedPlotCurve = 0;
+  foreach (DecimatedPlotCurve *pPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+    if (pPlotCurve->getNameStructure().compare(pVariablesTreeItem->getVariableName()) == 0) {
+      pDecimatedPlotCurve = pPlotCurve;
+      break;
+    }
+  }
+  if (!pDecimatedPlotCurve) {
+    pDecimatedPlotCurve = DecimatedPlotCurve::create(pVariablesTreeItem->getFilePath(), pVariablesTreeItem->getFileName(),
+                                                     pVariablesTreeItem->getPlotVariable(), pVariablesTreeItem->getDisplayUnit());
+    if (!pDecimatedPlotCurve) {
+      return false;
+    }
+    pDecimatedPlotCurve->setCurveColor(pPlotWindow->getPlot()->getPlotCurvesList().size()
+                                       + DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot()).size());
+    pDecimatedPlotCurve->setCurveWidth(curveThickness);
+    pDecimatedPlotCurve->setCurveStyle(curveStyle);
+    if (pVariablesTreeItem->getUnit().compare(pVariablesTreeItem->getDisplayUnit()) != 0) {
+      OMCInterface::convertUnits_res convertUnit = MainWindow::instance()->getOMCProxy()->convertUnits(pVariablesTreeItem->getUnit(),
+                                                                                             pVariablesTreeItem->getDisplayUnit());
+      if (convertUnit.unitsCompatible) {
+        pDecimatedPlotCurve->convertYValues(convertUnit.offset, convertUnit.scaleFactor);
+      } else {
+        pDecimatedPlotCurve->setDisplayUnit(pVariablesTreeItem->getUnit());
+      }
+    }
+    if (pPlotWindow->getTimeUnit().compare("s") != 0) {
+      OMCInterface::convertUnits_res convertUnit = MainWindow::instance()->getOMCProxy()->convertUnits("s", pPlotWindow->getTimeUnit());
+      if (convertUnit.unitsCompatible) {
+        pDecimatedPlotCurve->convertXValues(convertUnit.offset, convertUnit.scaleFactor);
+      }
+    }
+    pDecimatedPlotCurve->attach(pPlotWindow->getPlot());
+  }
+  if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+    pPlotWindow->fitInView();
+  } else {
+    pPlotWindow->getPlot()->replot();
+    if (pPlotWindow->getPlot()->getPlotZoomer()->zoomStack().size() == 1) {
+      pPlotWindow->getPlot()->getPlotZoomer()->setZoomBase(false);
+    }
+  }
+  return true;
+}
+
 /*!
  * \brief VariablesWidget::unitChanged
  * Handles the case when display unit is changed in VariablesTreeView.\n
@@ -1496,6 +1610,14 @@ void VariablesWidget::unitChanged(const QModelIndex &index)
           break;
         }
       }
+      foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+        if (pDecimatedPlotCurve->getNameStructure().compare(pVariablesTreeItem->getVariableName()) == 0) {
+          pDecimatedPlotCurve->convertYValues(convertUnit.offset, convertUnit.scaleFactor);
+          pDecimatedPlotCurve->setDisplayUnit(pVariablesTreeItem->getDisplayUnit());
+          pPlotWindow->getPlot()->replot();
+          break;
+        }
+      }
     }
   } catch (PlotException &e) {
     QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error), e.what(), Helper::ok);
@@ -1524,6 +1646,9 @@ void VariablesWidget::timeUnitChanged(QString unit)
         }
         pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
       }
+      foreach (DecimatedPlotCurve *pDecimatedPlotCurve, DecimatedPlotCurve::getPlotCurves(pPlotWindow->getPlot())) {
+        pDecimatedPlotCurve->convertXValues(convertUnit.offset, convertUnit.scaleFactor);
+      }
       pPlotWindow->setXLabel(QString("time [%1]").arg(unit));
       pPlotWindow->setTimeUnit(unit);
       pPlotWindow->getPlot()->replot();
@@ -117,8 +117,6 @@ public:
   Qt::ItemFlags flags(const QModelIndex &index) const;
   VariablesTreeItem* findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const;
   QModelIndex variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const;
-  QModelIndex variablesTreeItemIndexHelper(const VariablesTreeItem *pVariablesTreeItem, const VariablesTreeItem *pParentVariablesTreeItem,
-                                           const QModelIndex &parentIndex) const;
   void parseInitXml(QXmlStreamReader &xmlReader);
   QHash<QString, QString> parseScalarVariable(QXmlStreamReader &xmlReader);
   void insertVariablesItems(QString fileName, QString filePath, QStringList variablesList, SimulationOptions simulationOptions);
@@ -128,7 +126,9 @@ public:
 private:
   VariablesTreeView *mpVariablesTreeView;
   VariablesTreeItem *mpRootVariablesTreeItem;
+  QHash<QString, VariablesTreeItem*> mVariablesTreeItemsHash;
   QHash<QString, QHash<QString,QString> > mScalarVariablesList;
+  void removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem);
   void getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble, QString *unit,
                               QString *displayUnit, QString *description);
 signals:
@@ -189,6 +189,7 @@ private:
   QList<QStringList> mPlotParametricVariables;
   QString mFileName;
   QMdiSubWindow *mpLastActiveSubWindow;
+  bool plotDecimatedVariable(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle, OMPlot::PlotWindow *pPlotWindow);
 public slots:
   void plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle, OMPlot::PlotCurve *pPlotCurve = 0,
                      OMPlot::PlotWindow *pPlotWindow = 0);
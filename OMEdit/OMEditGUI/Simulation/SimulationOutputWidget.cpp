@@ -40,6 +40,9 @@
 #include "SimulationProcessThread.h"
 #include "SimulationDialog.h"
 #include "TransformationalDebugger/TransformationsWidget.h"
+#include "Plotting/PlotWindowContainer.h"
+#include "Plotting/VariablesWidget.h"
+#include "Modeling/MessagesWidget.h"
 
 #include <QApplication>
 #include <QObject>
@@ -191,7 +194,7 @@ void SimulationOutputTree::keyPressEvent(QKeyEvent *event)
  * \param pParent
  */
 SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptions, QWidget *pParent)
-  : mSimulationOptions(simulationOptions)
+  : mSimulationOptions(simulationOptions), mLivePlotFilePosition(0), mLivePlotTimeColumn(-1), mLivePlotStride(1), mLivePlotRowsCount(0)
 {
   Q_UNUSED(pParent);
   setWindowTitle(QString("%1 - %2 %3").arg(Helper::applicationName).arg(mSimulationOptions.getClassName()).arg(Helper::simulationOutput));
@@ -309,6 +312,9 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
   mSocketDisconnected = true;
   mpTcpServer->listen(QHostAddress(QHostAddress::LocalHost));
   connect(mpTcpServer, SIGNAL(newConnection()), SLOT(createSimulationProgressSocket()));
+  // live plotting timer
+  mLivePlotTimer.setInterval(1000);
+  connect(&mLivePlotTimer, SIGNAL(timeout()), SLOT(updateLivePlotting()));
   // create the thread
   mpSimulationProcessThread = new SimulationProcessThread(this);
   connect(mpSimulationProcessThread, SIGNAL(sendCompilationStarted()), SLOT(compilationProcessStarted()));
@@ -442,6 +448,136 @@ void SimulationOutputWidget::socketDisconnected()
   mSocketDisconnected = true;
 }
 
+/*!
+ * \brief SimulationOutputWidget::initializeLivePlotting
+ * Collects the curves of the open plot windows that belong to the result file of this simulation.\n
+ * These curves are cleared and filled from the csv result file while the simulation is running.
+ * The other result formats can't be read before the simulation has finished so they are not plotted live,
+ * the user is notified about it if there are curves to update.
+ */
+void SimulationOutputWidget::initializeLivePlotting()
+{
+  mLivePlotTimer.stop();
+  mLivePlotFilePosition = 0;
+  mLivePlotPendingData.clear();
+  mLivePlotVariablesList.clear();
+  mLivePlotCurvesList.clear();
+  mLivePlotTimeColumn = -1;
+  mLivePlotStride = 1;
+  mLivePlotRowsCount = 0;
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  VariablesTreeModel *pVariablesTreeModel = MainWindow::instance()->getVariablesWidget()->getVariablesTreeModel();
+  bool csvFormat = mSimulationOptions.getOutputFormat().compare("csv") == 0;
+  foreach (QMdiSubWindow *pSubWindow, MainWindow::instance()->getPlotWindowContainer()->subWindowList(QMdiArea::StackingOrder)) {
+    OMPlot::PlotWindow *pPlotWindow = qobject_cast<OMPlot::PlotWindow*>(pSubWindow->widget());
+    if (pPlotWindow && pPlotWindow->getPlotType() == OMPlot::PlotWindow::PLOT) {
+      // the result file has the time in seconds.
+      OMCInterface::convertUnits_res convertTimeUnit;
+      convertTimeUnit.unitsCompatible = false;
+      if (csvFormat && !pPlotWindow->getTimeUnit().isEmpty() && pPlotWindow->getTimeUnit().compare("s") != 0) {
+        convertTimeUnit = pOMCProxy->convertUnits("s", pPlotWindow->getTimeUnit());
+      }
+      foreach (OMPlot::PlotCurve *pPlotCurve, pPlotWindow->getPlot()->getPlotCurvesList()) {
+        if (pPlotCurve->getFileName().compare(mSimulationOptions.getResultFileName()) == 0) {
+          LivePlotCurve livePlotCurve;
+          livePlotCurve.mpPlotWindow = pPlotWindow;
+          livePlotCurve.mpPlotCurve = pPlotCurve;
+          livePlotCurve.mColumn = -1;
+          livePlotCurve.mXOffset = convertTimeUnit.unitsCompatible ? convertTimeUnit.offset : 0.0;
+          livePlotCurve.mXScaleFactor = convertTimeUnit.unitsCompatible ? convertTimeUnit.scaleFactor : 1.0;
+          livePlotCurve.mYOffset = 0.0;
+          livePlotCurve.mYScaleFactor = 1.0;
+          // the result file has the values in the unit of the variable, the curve shows them in its display unit.
+          VariablesTreeItem *pVariablesTreeItem = pVariablesTreeModel->findVariablesTreeItem(pPlotCurve->getNameStructure(),
+                                                                                             pVariablesTreeModel->getRootVariablesTreeItem());
+          if (csvFormat && pVariablesTreeItem && !pVariablesTreeItem->getUnit().isEmpty() && !pPlotCurve->getDisplayUnit().isEmpty()
+              && pVariablesTreeItem->getUnit().compare(pPlotCurve->getDisplayUnit()) != 0) {
+            OMCInterface::convertUnits_res convertUnit = pOMCProxy->convertUnits(pVariablesTreeItem->getUnit(), pPlotCurve->getDisplayUnit());
+            if (convertUnit.unitsCompatible) {
+              livePlotCurve.mYOffset = convertUnit.offset;
+              livePlotCurve.mYScaleFactor = convertUnit.scaleFactor;
+            }
+          }
+          mLivePlotCurvesList.append(livePlotCurve);
+        }
+      }
+    }
+  }
+  if (mLivePlotCurvesList.isEmpty()) {
+    return;
+  }
+  if (!csvFormat) {
+    mLivePlotCurvesList.clear();
+    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                                          tr("The plotted variables of %1 are only updated while the simulation is running "
+                                                             "with the csv result format. They are updated once the simulation has finished.")
+                                                          .arg(mSimulationOptions.getResultFileName()),
+                                                          Helper::scriptingKind, Helper::notificationLevel));
+    return;
+  }
+  for (int i = 0 ; i < mLivePlotCurvesList.size() ; i++) {
+    mLivePlotCurvesList[i].mpPlotCurve->setSamples(mLivePlotCurvesList.at(i).mXValues, mLivePlotCurvesList.at(i).mYValues);
+  }
+  mLivePlotTimer.start();
+}
+
+/*!
+ * \brief SimulationOutputWidget::restoreLivePlotCurves
+ * Shows the values the live plot curves had before the simulation started.\n
+ * The live values are only set as the samples of the curves, the values of the curves are not changed.
+ */
+void SimulationOutputWidget::restoreLivePlotCurves()
+{
+  QList<OMPlot::PlotWindow*> plotWindows;
+  foreach (const LivePlotCurve &livePlotCurve, mLivePlotCurvesList) {
+    OMPlot::PlotWindow *pPlotWindow = qobject_cast<OMPlot::PlotWindow*>(livePlotCurve.mpPlotWindow.data());
+    if (pPlotWindow && pPlotWindow->getPlot()->getPlotCurvesList().contains(livePlotCurve.mpPlotCurve)) {
+      OMPlot::PlotCurve *pPlotCurve = livePlotCurve.mpPlotCurve;
+      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      if (!plotWindows.contains(pPlotWindow)) {
+        plotWindows.append(pPlotWindow);
+      }
+    }
+  }
+  foreach (OMPlot::PlotWindow *pPlotWindow, plotWindows) {
+    if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+      pPlotWindow->fitInView();
+    } else {
+      pPlotWindow->getPlot()->replot();
+    }
+  }
+  mLivePlotCurvesList.clear();
+}
+
+/*!
+ * \brief SimulationOutputWidget::readLivePlotHeader
+ * Reads the variable names from the header of the csv result file and resolves the columns of the live plot curves.
+ * \param header
+ */
+void SimulationOutputWidget::readLivePlotHeader(const QByteArray &header)
+{
+  // the variable names are quoted and array subscripts may contain commas.
+  QString name;
+  bool quoted = false;
+  foreach (const QChar &character, QString::fromUtf8(header.trimmed())) {
+    if (character == '"') {
+      quoted = !quoted;
+    } else if (character == ',' && !quoted) {
+      mLivePlotVariablesList.append(name.trimmed());
+      name.clear();
+    } else {
+      name.append(character);
+    }
+  }
+  mLivePlotVariablesList.append(name.trimmed());
+  mLivePlotTimeColumn = mLivePlotVariablesList.indexOf("time");
+  for (int i = 0 ; i < mLivePlotCurvesList.size() ; i++) {
+    OMPlot::PlotCurve *pPlotCurve = mLivePlotCurvesList.at(i).mpPlotCurve;
+    QString variable = pPlotCurve->getNameStructure().mid(pPlotCurve->getFileName().length() + 1);
+    mLivePlotCurvesList[i].mColumn = mLivePlotVariablesList.indexOf(variable);
+  }
+}
+
 /*!
  * \brief SimulationOutputWidget::compilationProcessStarted
  * Slot activated when SimulationProcessThread sendCompilationStarted signal is raised.\n
@@ -515,6 +651,9 @@ void SimulationOutputWidget::simulationProcessStarted()
     mResultFileLastModifiedDateTime = resultFileInfo.lastModified();
   }
   mpArchivedSimulationItem->setStatus(Helper::running);
+  if (OptionsDialog::instance()->getSimulationPage()->getLivePlottingCheckBox()->isChecked()) {
+    initializeLivePlotting();
+  }
 }
 
 /*!
@@ -580,8 +719,13 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
  */
 void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-  Q_UNUSED(exitCode);
-  Q_UNUSED(exitStatus);
+  mLivePlotTimer.stop();
+  // if the simulation failed or didn't write a result then show the values of the previous result again.
+  QFileInfo resultFileInfo(QString("%1/%2").arg(mSimulationOptions.getWorkingDirectory(), mSimulationOptions.getResultFileName()));
+  if (exitStatus != QProcess::NormalExit || exitCode != 0 || !resultFileInfo.exists()
+      || (mResultFileLastModifiedDateTime.isValid() && resultFileInfo.lastModified() <= mResultFileLastModifiedDateTime)) {
+    restoreLivePlotCurves();
+  }
   mpProgressLabel->setText(tr("Simulation of <b>%1</b> is finished.").arg(mSimulationOptions.getClassName()));
   mpProgressBar->setValue(mpProgressBar->maximum());
   mpCancelButton->setEnabled(false);
@@ -589,6 +733,102 @@ void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::E
   mpArchivedSimulationItem->setStatus(Helper::finished);
 }
 
+/*!
+ * \brief SimulationOutputWidget::updateLivePlotting
+ * Slot activated when mLivePlotTimer timeout signal is raised.\n
+ * Reads the rows appended to the csv result file since the last update and appends them to the live plot curves.\n
+ * Once the curves reach the maximum number of points every second point is dropped and only every second row is read from then on.
+ */
+void SimulationOutputWidget::updateLivePlotting()
+{
+  static const int maximumPoints = 10000;
+  QFile resultFile(QString("%1/%2").arg(mSimulationOptions.getWorkingDirectory(), mSimulationOptions.getResultFileName()));
+  QFileInfo resultFileInfo(resultFile);
+  // wait until the simulation has started writing the new result file
+  if (!resultFileInfo.exists() || (mResultFileLastModifiedDateTime.isValid() && resultFileInfo.lastModified() <= mResultFileLastModifiedDateTime)) {
+    return;
+  }
+  if (resultFileInfo.size() < mLivePlotFilePosition) {
+    initializeLivePlotting();
+    mLivePlotTimer.start();
+  }
+  if (resultFileInfo.size() == mLivePlotFilePosition || !resultFile.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  resultFile.seek(mLivePlotFilePosition);
+  QByteArray data = mLivePlotPendingData + resultFile.readAll();
+  mLivePlotFilePosition = resultFile.pos();
+  resultFile.close();
+  // only complete lines are read, the rest is kept for the next update.
+  int lastNewLine = data.lastIndexOf('\n');
+  if (lastNewLine < 0) {
+    mLivePlotPendingData = data;
+    return;
+  }
+  mLivePlotPendingData = data.mid(lastNewLine + 1);
+  QList<QByteArray> lines = data.left(lastNewLine).split('\n');
+  bool updated = false;
+  foreach (const QByteArray &line, lines) {
+    if (line.trimmed().isEmpty()) {
+      continue;
+    }
+    if (mLivePlotVariablesList.isEmpty()) {
+      readLivePlotHeader(line);
+      continue;
+    }
+    if (mLivePlotRowsCount++ % mLivePlotStride != 0) {
+      continue;
+    }
+    QList<QByteArray> values = line.split(',');
+    if (mLivePlotTimeColumn < 0 || mLivePlotTimeColumn >= values.size()) {
+      continue;
+    }
+    double time = values.at(mLivePlotTimeColumn).toDouble();
+    bool thinned = false;
+    for (int i = 0 ; i < mLivePlotCurvesList.size() ; i++) {
+      LivePlotCurve &livePlotCurve = mLivePlotCurvesList[i];
+      if (livePlotCurve.mColumn >= 0 && livePlotCurve.mColumn < values.size()) {
+        livePlotCurve.mXValues.append(Utilities::convertUnit(time, livePlotCurve.mXOffset, livePlotCurve.mXScaleFactor));
+        livePlotCurve.mYValues.append(Utilities::convertUnit(values.at(livePlotCurve.mColumn).toDouble(), livePlotCurve.mYOffset,
+                                                             livePlotCurve.mYScaleFactor));
+        if (livePlotCurve.mXValues.size() >= maximumPoints) {
+          for (int j = 0 ; j < livePlotCurve.mXValues.size() / 2 ; j++) {
+            livePlotCurve.mXValues[j] = livePlotCurve.mXValues.at(2 * j);
+            livePlotCurve.mYValues[j] = livePlotCurve.mYValues.at(2 * j);
+          }
+          livePlotCurve.mXValues.resize(livePlotCurve.mXValues.size() / 2);
+          livePlotCurve.mYValues.resize(livePlotCurve.mYValues.size() / 2);
+          thinned = true;
+        }
+      }
+    }
+    if (thinned) {
+      mLivePlotStride *= 2;
+    }
+    updated = true;
+  }
+  if (!updated) {
+    return;
+  }
+  QList<OMPlot::PlotWindow*> plotWindows;
+  foreach (const LivePlotCurve &livePlotCurve, mLivePlotCurvesList) {
+    OMPlot::PlotWindow *pPlotWindow = qobject_cast<OMPlot::PlotWindow*>(livePlotCurve.mpPlotWindow.data());
+    if (pPlotWindow && pPlotWindow->getPlot()->getPlotCurvesList().contains(livePlotCurve.mpPlotCurve)) {
+      livePlotCurve.mpPlotCurve->setSamples(livePlotCurve.mXValues, livePlotCurve.mYValues);
+      if (!plotWindows.contains(pPlotWindow)) {
+        plotWindows.append(pPlotWindow);
+      }
+    }
+  }
+  foreach (OMPlot::PlotWindow *pPlotWindow, plotWindows) {
+    if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+      pPlotWindow->fitInView();
+    } else {
+      pPlotWindow->getPlot()->replot();
+    }
+  }
+}
+
 /*!
  * \brief SimulationOutputWidget::cancelCompilationOrSimulation
  * Slot activated when mpCancelButton clicked signal is raised.\n
@@ -607,6 +847,7 @@ void SimulationOutputWidget::cancelCompilationOrSimulation()
   } else if (mpSimulationProcessThread->isSimulationProcessRunning()) {
     mpSimulationProcessThread->setSimulationProcessKilled(true);
     mpSimulationProcessThread->getSimulationProcess()->kill();
+    mLivePlotTimer.stop();
     mpProgressLabel->setText(tr("Simulation of <b>%1</b> is cancelled.").arg(mSimulationOptions.getClassName()));
     mpProgressBar->setValue(mpProgressBar->maximum());
     mpCancelButton->setEnabled(false);
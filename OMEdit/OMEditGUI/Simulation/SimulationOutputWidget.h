@@ -45,6 +45,12 @@
 #include <QProcess>
 #include <QDateTime>
 #include <QTcpServer>
+#include <QTimer>
+#include <QPointer>
+
+namespace OMPlot {
+class PlotCurve;
+}
 
 class Label;
 class SimulationProcessThread;
@@ -75,6 +81,23 @@ protected:
   virtual void keyPressEvent(QKeyEvent *event);
 };
 
+/*!
+ * \brief The LivePlotCurve struct
+ * Holds the values of a plot curve which is updated while the simulation is running.\n
+ * The offsets and scale factors convert the result file values to the time unit and the display unit of the curve.
+ */
+typedef struct {
+  QPointer<QWidget> mpPlotWindow;
+  OMPlot::PlotCurve *mpPlotCurve;
+  int mColumn;
+  double mXOffset;
+  double mXScaleFactor;
+  double mYOffset;
+  double mYScaleFactor;
+  QVector<double> mXValues;
+  QVector<double> mYValues;
+} LivePlotCurve;
+
 class SimulationOutputWidget : public QWidget
 {
   Q_OBJECT
@@ -108,6 +131,18 @@ private:
   bool mSocketDisconnected;
   SimulationProcessThread *mpSimulationProcessThread;
   QDateTime mResultFileLastModifiedDateTime;
+  QTimer mLivePlotTimer;
+  qint64 mLivePlotFilePosition;
+  QByteArray mLivePlotPendingData;
+  QStringList mLivePlotVariablesList;
+  QList<LivePlotCurve> mLivePlotCurvesList;
+  int mLivePlotTimeColumn;
+  int mLivePlotStride;
+  int mLivePlotRowsCount;
+
+  void initializeLivePlotting();
+  void readLivePlotHeader(const QByteArray &header);
+  void restoreLivePlotCurves();
 public slots:
   void createSimulationProgressSocket();
   void readSimulationProgress();
@@ -118,6 +153,7 @@ public slots:
   void simulationProcessStarted();
   void writeSimulationOutput(QString output, StringHandler::SimulationMessageType type, bool textFormat);
   void simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+  void updateLivePlotting();
   void cancelCompilationOrSimulation();
   void openTransformationBrowser(QUrl url);
 protected:
@@ -445,6 +445,619 @@ const QSet<QString> MyHandler::operationExpTags = QSet<QString>() << "before" <<
 const QSet<QString> MyHandler::equationTags = QSet<QString>() << "residual" << "assign" << "statement" << "linear" << "nonlinear" << "mixed" << "when" << "ifequation";
 const QSet<QString> MyHandler::equationPartTags = QSet<QString>() << "residual" << "rhs" << "statement" << "row" << "cell";
 
+/*!
+ * \class InfoJSONReader
+ * \brief Streaming reader for the transformational debugger info.json file.
+ */
+/*!
+ * \brief InfoJSONReader::InfoJSONReader
+ * \param variables - the variables are stored here.
+ * \param equations - the equations are stored here. Index 0 is the first equation of the file.
+ */
+InfoJSONReader::InfoJSONReader(QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations)
+  : variables(variables), equations(equations)
+{
+  hasOperationsEnabled = false;
+  pos = 0;
+  end = 0;
+  keyStart = 0;
+  keyLength = 0;
+  keyHasEscapes = false;
+  failed = false;
+}
+
+/*!
+ * \brief InfoJSONReader::read
+ * Reads the info.json file.
+ * \param file
+ * \return false if the file could not be read. Use getErrorString() to get the reason.
+ */
+bool InfoJSONReader::read(QFile &file)
+{
+  failed = false;
+  errorString.clear();
+  if (!file.open(QIODevice::ReadOnly)) {
+    return error(file.errorString());
+  }
+  /* map the file so we don't need an extra copy of it in memory. Fallback to reading it if mapping is not possible. */
+  QByteArray contents;
+  qint64 size = file.size();
+  uchar *pMappedData = size > 0 ? file.map(0, size) : 0;
+  if (pMappedData) {
+    pos = reinterpret_cast<const char*>(pMappedData);
+  } else {
+    contents = file.readAll();
+    pos = contents.constData();
+    size = contents.size();
+  }
+  end = pos + size;
+  bool ok = readDocument();
+  if (pMappedData) {
+    file.unmap(pMappedData);
+  }
+  file.close();
+  pos = end = 0;
+  strings.clear();
+  return ok;
+}
+
+/*!
+ * \brief InfoJSONReader::error
+ * Marks the reading as failed and sets the error message. Only the first error is kept.
+ * \param message
+ * \return always false.
+ */
+bool InfoJSONReader::error(const QString &message)
+{
+  if (!failed) {
+    failed = true;
+    errorString = message;
+  }
+  return false;
+}
+
+void InfoJSONReader::skipWhitespace()
+{
+  while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+    pos++;
+  }
+}
+
+bool InfoJSONReader::expect(char c)
+{
+  skipWhitespace();
+  if (pos < end && *pos == c) {
+    pos++;
+    return true;
+  }
+  return error(QString("expected '%1' but found '%2'").arg(c).arg(pos < end ? QString(QChar(*pos)) : QString("end of file")));
+}
+
+/*!
+ * \brief InfoJSONReader::nextMember
+ * Moves to the next member of an object. The key of the member is available via isKey().
+ * \param first - true for the first member of the object. Is set to false.
+ * \return false when the end of the object is reached or an error occurred.
+ */
+bool InfoJSONReader::nextMember(bool &first)
+{
+  if (!nextElement(first, '}')) {
+    return false;
+  }
+  if (!readStringSpan(keyStart, keyLength, keyHasEscapes)) {
+    return false;
+  }
+  return expect(':');
+}
+
+/*!
+ * \brief InfoJSONReader::nextElement
+ * Moves to the next element of an array or object.
+ * \param first - true for the first element. Is set to false.
+ * \param close - the closing character i.e., ']' or '}'.
+ * \return false when the end is reached or an error occurred.
+ */
+bool InfoJSONReader::nextElement(bool &first, char close)
+{
+  if (failed) {
+    return false;
+  }
+  skipWhitespace();
+  if (pos < end && *pos == close) {
+    pos++;
+    return false;
+  }
+  if (!first && !expect(',')) {
+    return false;
+  }
+  first = false;
+  return true;
+}
+
+bool InfoJSONReader::isKey(const char *name) const
+{
+  return (int)qstrlen(name) == keyLength && qstrncmp(keyStart, name, keyLength) == 0;
+}
+
+/*!
+ * \brief InfoJSONReader::readStringSpan
+ * Reads a string without decoding it.
+ * \param start - start of the string contents.
+ * \param length - length of the string contents in bytes.
+ * \param hasEscapes - true if the string contains escape sequences.
+ * \return
+ */
+bool InfoJSONReader::readStringSpan(const char *&start, int &length, bool &hasEscapes)
+{
+  if (!expect('"')) {
+    return false;
+  }
+  start = pos;
+  hasEscapes = false;
+  while (pos < end && *pos != '"') {
+    if (*pos == '\\') {
+      hasEscapes = true;
+      pos++;
+    }
+    pos++;
+  }
+  if (pos >= end) {
+    return error("unterminated string");
+  }
+  length = pos - start;
+  pos++;
+  return true;
+}
+
+/*!
+ * \brief InfoJSONReader::decodeString
+ * Decodes the UTF-8 string contents and its escape sequences.
+ * \param start
+ * \param length
+ * \param hasEscapes
+ * \return
+ */
+QString InfoJSONReader::decodeString(const char *start, int length, bool hasEscapes)
+{
+  if (!hasEscapes) {
+    return QString::fromUtf8(start, length);
+  }
+  QString result;
+  result.reserve(length);
+  const char *stringEnd = start + length;
+  const char *segment = start;
+  for (const char *p = start ; p < stringEnd ; p++) {
+    if (*p != '\\') {
+      continue;
+    }
+    result.append(QString::fromUtf8(segment, p - segment));
+    p++;
+    switch (*p) {
+      case 'b': result.append(QChar('\b')); break;
+      case 'f': result.append(QChar('\f')); break;
+      case 'n': result.append(QChar('\n')); break;
+      case 'r': result.append(QChar('\r')); break;
+      case 't': result.append(QChar('\t')); break;
+      case 'u': {
+        ushort code;
+        if (!decodeHex4(p + 1, stringEnd, code)) {
+          result.append(QChar(QChar::ReplacementCharacter));
+          break;
+        }
+        p += 4;
+        if (QChar::isHighSurrogate(code)) {
+          /* characters outside the BMP are escaped as a high surrogate followed by a low surrogate. */
+          ushort lowCode;
+          if (p + 2 < stringEnd && p[1] == '\\' && p[2] == 'u' && decodeHex4(p + 3, stringEnd, lowCode) && QChar::isLowSurrogate(lowCode)) {
+            result.append(QChar(code));
+            result.append(QChar(lowCode));
+            p += 6;
+          } else {
+            result.append(QChar(QChar::ReplacementCharacter));
+          }
+        } else if (QChar::isLowSurrogate(code)) {
+          result.append(QChar(QChar::ReplacementCharacter));
+        } else {
+          result.append(QChar(code));
+        }
+        break;
+      }
+      default: result.append(QChar(*p)); break;
+    }
+    segment = p + 1;
+  }
+  result.append(QString::fromUtf8(segment, stringEnd - segment));
+  return result;
+}
+
+/*!
+ * \brief InfoJSONReader::decodeHex4
+ * Decodes the 4 hexadecimal digits of a unicode escape sequence.
+ * \param p - the first digit.
+ * \param stringEnd
+ * \param code - set to the UTF-16 code unit.
+ * \return false if there are less than 4 hexadecimal digits.
+ */
+bool InfoJSONReader::decodeHex4(const char *p, const char *stringEnd, ushort &code)
+{
+  if (p + 4 > stringEnd) {
+    return false;
+  }
+  bool ok;
+  code = QByteArray(p, 4).toUShort(&ok, 16);
+  return ok;
+}
+
+bool InfoJSONReader::readString(QString &value)
+{
+  const char *start;
+  int length;
+  bool hasEscapes;
+  if (!readStringSpan(start, length, hasEscapes)) {
+    return false;
+  }
+  value = decodeString(start, length, hasEscapes);
+  return true;
+}
+
+bool InfoJSONReader::readNumber(double &value)
+{
+  skipWhitespace();
+  const char *start = pos;
+  while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '-' || *pos == '+' || *pos == '.' || *pos == 'e' || *pos == 'E')) {
+    pos++;
+  }
+  bool ok;
+  value = QByteArray(start, pos - start).toDouble(&ok);
+  return ok ? true : error("expected a number");
+}
+
+bool InfoJSONReader::readInt(int &value)
+{
+  double number;
+  if (!readNumber(number)) {
+    return false;
+  }
+  value = (int)number;
+  return true;
+}
+
+/*!
+ * \brief InfoJSONReader::readStringList
+ * Reads an array of strings. The strings are trimmed.
+ * \param values
+ * \param intern - if true then the strings are shared with the other occurrences of the same string.
+ * \return
+ */
+bool InfoJSONReader::readStringList(QStringList &values, bool intern)
+{
+  if (!expect('[')) {
+    return false;
+  }
+  bool first = true;
+  QString value;
+  while (nextElement(first, ']')) {
+    if (!readString(value)) {
+      return false;
+    }
+    values.append(intern ? this->intern(value.trimmed()) : value.trimmed());
+  }
+  return !failed;
+}
+
+/*!
+ * \brief InfoJSONReader::skipValue
+ * Skips a value of any type.
+ * \return
+ */
+bool InfoJSONReader::skipValue()
+{
+  skipWhitespace();
+  if (pos >= end) {
+    return error("unexpected end of file");
+  }
+  bool first = true;
+  switch (*pos) {
+    case '"': {
+      const char *start;
+      int length;
+      bool hasEscapes;
+      return readStringSpan(start, length, hasEscapes);
+    }
+    case '{':
+      pos++;
+      while (nextMember(first)) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !failed;
+    case '[':
+      pos++;
+      while (nextElement(first, ']')) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !failed;
+    default:
+      /* number, true, false or null */
+      while (pos < end && *pos != ',' && *pos != '}' && *pos != ']' && *pos != ' ' && *pos != '\n' && *pos != '\r' && *pos != '\t') {
+        pos++;
+      }
+      return true;
+  }
+}
+
+/*!
+ * \brief InfoJSONReader::intern
+ * Returns the shared copy of the string.
+ * \param value
+ * \return
+ */
+QString InfoJSONReader::intern(const QString &value)
+{
+  return *strings.insert(value);
+}
+
+bool InfoJSONReader::readDocument()
+{
+  if (!expect('{')) {
+    return false;
+  }
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("variables")) {
+      readVariables();
+    } else if (isKey("equations")) {
+      readEquations();
+    } else {
+      skipValue();
+    }
+  }
+  if (failed) {
+    return false;
+  }
+  /* link the equations with their parents and the variables they define and use. */
+  for (int i = 0 ; i < equations.size() ; i++) {
+    OMEquation *equation = equations[i];
+    if (equation->parent >= 0 && equation->parent < equations.size()) {
+      equations[equation->parent]->eqs << equation->index;
+    } else {
+      equation->parent = 0;
+    }
+    /* a variable might only appear in the equations e.g., a temporary variable so create it. */
+    foreach (const QString &variable, equation->defines) {
+      getVariable(variable).definedIn << equation->index;
+    }
+    foreach (const QString &variable, equation->depends) {
+      getVariable(variable).usedIn << equation->index;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief InfoJSONReader::getVariable
+ * Returns the variable. Creates it if it is not in the variables section.
+ * \param name
+ * \return
+ */
+OMVariable& InfoJSONReader::getVariable(const QString &name)
+{
+  OMVariable &variable = variables[name];
+  if (variable.name.isEmpty()) {
+    variable.name = name;
+  }
+  return variable;
+}
+
+bool InfoJSONReader::readVariables()
+{
+  if (!expect('{')) {
+    return false;
+  }
+  bool first = true;
+  while (nextMember(first)) {
+    QString name = intern(decodeString(keyStart, keyLength, keyHasEscapes));
+    /* construct the variable in place. */
+    OMVariable &variable = variables[name];
+    variable.name = name;
+    if (!readVariable(variable)) {
+      return false;
+    }
+    if (!hasOperationsEnabled && variable.ops.size() > 0) {
+      hasOperationsEnabled = true;
+    }
+  }
+  return !failed;
+}
+
+bool InfoJSONReader::readVariable(OMVariable &variable)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("comment")) {
+      readString(variable.comment);
+    } else if (isKey("source")) {
+      readSource(variable.info, variable.ops);
+    } else {
+      skipValue();
+    }
+  }
+  return !failed;
+}
+
+bool InfoJSONReader::readEquations()
+{
+  if (!expect('[')) {
+    return false;
+  }
+  bool first = true;
+  while (nextElement(first, ']')) {
+    OMEquation *equation = new OMEquation();
+    equations.append(equation);
+    int parent = -1;
+    if (!readEquation(equation, parent)) {
+      return false;
+    }
+    if (equation->index != equations.size() - 1) {
+      return error(QString("got index %1 expected %2").arg(equation->index).arg(equations.size() - 1));
+    }
+    /* parent is linked once all equations are read. */
+    equation->parent = parent;
+    if (!hasOperationsEnabled && equation->ops.size() > 0) {
+      hasOperationsEnabled = true;
+    }
+  }
+  return !failed;
+}
+
+bool InfoJSONReader::readEquation(OMEquation *equation, int &parent)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  equation->index = 0;
+  equation->profileBlock = -1;
+  bool hasDisplay = false;
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("eqIndex")) {
+      readInt(equation->index);
+    } else if (isKey("section")) {
+      if (readString(equation->section)) {
+        equation->section = intern(equation->section);
+      }
+    } else if (isKey("parent")) {
+      readInt(parent);
+    } else if (isKey("defines")) {
+      readStringList(equation->defines, true);
+    } else if (isKey("uses")) {
+      readStringList(equation->depends, true);
+    } else if (isKey("equation")) {
+      readStringList(equation->text, false);
+    } else if (isKey("tag")) {
+      if (readString(equation->tag)) {
+        equation->tag = intern(equation->tag);
+      }
+    } else if (isKey("display")) {
+      hasDisplay = readString(equation->display);
+    } else if (isKey("source")) {
+      readSource(equation->info, equation->ops);
+    } else {
+      skipValue();
+    }
+  }
+  if (!hasDisplay) {
+    equation->display = equation->tag;
+  }
+  return !failed;
+}
+
+bool InfoJSONReader::readSource(OMInfo &info, QList<OMOperation*> &ops)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("info")) {
+      readInfo(info);
+    } else if (isKey("operations")) {
+      readOperations(ops);
+    } else {
+      skipValue();
+    }
+  }
+  info.isValid = true;
+  return !failed;
+}
+
+bool InfoJSONReader::readInfo(OMInfo &info)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("file")) {
+      if (readString(info.file)) {
+        info.file = intern(info.file);
+      }
+    } else if (isKey("lineStart")) {
+      readInt(info.lineStart);
+    } else if (isKey("lineEnd")) {
+      readInt(info.lineEnd);
+    } else if (isKey("colStart")) {
+      readInt(info.colStart);
+    } else if (isKey("colEnd")) {
+      readInt(info.colEnd);
+    } else {
+      skipValue();
+    }
+  }
+  return !failed;
+}
+
+bool InfoJSONReader::readOperations(QList<OMOperation*> &ops)
+{
+  if (!expect('[')) {
+    return false;
+  }
+  bool first = true;
+  while (nextElement(first, ']')) {
+    OMOperation *op = readOperation();
+    if (failed) {
+      delete op;
+      return false;
+    }
+    if (op) {
+      ops += op;
+    }
+  }
+  return !failed;
+}
+
+OMOperation* InfoJSONReader::readOperation()
+{
+  if (!expect('{')) {
+    return NULL;
+  }
+  QString op, display;
+  QStringList dataStrings;
+  bool first = true;
+  while (nextMember(first)) {
+    if (isKey("op")) {
+      readString(op);
+    } else if (isKey("display")) {
+      readString(display);
+    } else if (isKey("data")) {
+      readStringList(dataStrings, false);
+    } else {
+      skipValue();
+    }
+  }
+  if (failed) {
+    return NULL;
+  }
+  if (op == "before-after") {
+    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
+  } else if (op == "before-after-assert") {
+    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
+  } else if (op == "chain" && !dataStrings.isEmpty()) {
+    QStringList firstLast;
+    firstLast << dataStrings.first() << dataStrings.last();
+    return new OMOperationBeforeAfter(display != "" ? display : op, firstLast);
+  } else if (op == "info") {
+    return new OMOperationInfo(display != "" ? display : op, dataStrings.join(", "));
+  }
+  return NULL;
+}
+
 #if 0
 
 #include <time.h>
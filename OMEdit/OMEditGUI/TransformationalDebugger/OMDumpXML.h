@@ -38,6 +38,7 @@
 #include <QFile>
 #include <QXmlDefaultHandler>
 #include <QHash>
+#include <QSet>
 
 class OMOperation {
 public:
@@ -215,4 +216,54 @@ private:
   bool fatalError(const QXmlParseException & exception);
 };
 
+/*!
+ * \brief The InfoJSONReader class
+ * Streaming reader for the transformational debugger info.json file.\n
+ * The file is memory mapped and parsed in a single pass directly into the variables and equations,
+ * without building an intermediate document. Repeated strings like file names and variable names are shared.
+ */
+class InfoJSONReader {
+public:
+  bool hasOperationsEnabled;
+  InfoJSONReader(QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations);
+  bool read(QFile &file);
+  QString getErrorString() const {return errorString;}
+private:
+  QHash<QString,OMVariable> &variables;
+  QList<OMEquation*> &equations;
+  QSet<QString> strings;
+  QString errorString;
+  const char *pos;
+  const char *end;
+  const char *keyStart;
+  int keyLength;
+  bool keyHasEscapes;
+  bool failed;
+  bool error(const QString &message);
+  void skipWhitespace();
+  bool expect(char c);
+  bool nextMember(bool &first);
+  bool nextElement(bool &first, char close);
+  bool isKey(const char *name) const;
+  bool readStringSpan(const char *&start, int &length, bool &hasEscapes);
+  QString decodeString(const char *start, int length, bool hasEscapes);
+  static bool decodeHex4(const char *p, const char *stringEnd, ushort &code);
+  bool readString(QString &value);
+  bool readNumber(double &value);
+  bool readInt(int &value);
+  bool readStringList(QStringList &values, bool intern);
+  bool skipValue();
+  QString intern(const QString &value);
+  OMVariable& getVariable(const QString &name);
+  bool readDocument();
+  bool readVariables();
+  bool readVariable(OMVariable &variable);
+  bool readEquations();
+  bool readEquation(OMEquation *equation, int &parent);
+  bool readSource(OMInfo &info, QList<OMOperation*> &ops);
+  bool readInfo(OMInfo &info);
+  bool readOperations(QList<OMOperation*> &ops);
+  OMOperation* readOperation();
+};
+
 #endif
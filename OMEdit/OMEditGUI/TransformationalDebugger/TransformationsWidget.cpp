@@ -742,59 +742,12 @@ TransformationsWidget::TransformationsWidget(QString infoJSONFullFileName, QWidg
   }
 }
 
-static QStringList variantListToStringList(const QVariantList lst)
+static OMEquation* getOMEquation(const QList<OMEquation*> &equations, int index)
 {
-  QStringList strs;
-  foreach(QVariant v, lst){
-    QString s = v.toString();
-    strs << v.toString().trimmed();
+  /* the equations are usually stored at their index. */
+  if (index >= 1 && index < equations.size() && equations[index]->index == index) {
+    return equations[index];
   }
-  return strs;
-}
-
-static OMOperation* variantToOperationPtr(QVariantMap var)
-{
-  QString op = var["op"].toString();
-  QString display = var["display"].toString();
-  QStringList dataStrings = variantListToStringList(var["data"].toList());
-
-  if (op == "before-after") {
-    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
-  } else if (op == "before-after-assert") {
-    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
-  } else if (op == "chain") {
-    QStringList firstLast;
-    firstLast << dataStrings.first() << dataStrings.last();
-    return new OMOperationBeforeAfter(display != "" ? display : op, firstLast);
-  } else if (op == "info") {
-    return new OMOperationInfo(display != "" ? display : op, dataStrings.join(", "));
-  }
-  // "chain"
-  return NULL;
-}
-
-
-static void variantToSource(QVariantMap var, OMInfo &info, QStringList &types, QList<OMOperation*> &ops)
-{
-  Q_UNUSED(types);
-  QVariantMap vinfo = var["info"].toMap();
-  info.file = vinfo["file"].toString();
-  info.lineStart = vinfo["lineStart"].toInt();
-  info.lineEnd = vinfo["lineEnd"].toInt();
-  info.colStart = vinfo["colStart"].toInt();
-  info.colEnd = vinfo["colEnd"].toInt();
-  info.isValid = true;
-  QVariantList vops = var["operations"].toList();
-  foreach (QVariant vop, vops) {
-    OMOperation *op = variantToOperationPtr(vop.toMap());
-    if (op) {
-      ops += op;
-    }
-  }
-}
-
-static OMEquation* getOMEquation(QList<OMEquation*> equations, int index)
-{
   for (int i = 1 ; i < equations.size() ; i++) {
     if (equations[i]->index == index) {
       return equations[i];
@@ -806,75 +759,22 @@ static OMEquation* getOMEquation(QList<OMEquation*> equations, int index)
 void TransformationsWidget::loadTransformations()
 {
   QFile file(mInfoJSONFullFileName);
+  if (mInfoJSONFullFileName.endsWith(".json")) {
+    /* the equations of the xml file are owned by MyHandler. */
+    qDeleteAll(mEquations);
+  }
   mEquations.clear();
   mVariables.clear();
   hasOperationsEnabled = false;
   if (mInfoJSONFullFileName.endsWith(".json")) {
-    QJson::Parser parser;
-    bool ok;
-    QVariantMap result;
-    result = parser.parse(&file, &ok).toMap();
-    if (!ok) {
-      QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson), Helper::parsingFailedJson + ": " + mInfoJSONFullFileName, Helper::ok);
+    InfoJSONReader infoJSONReader(mVariables, mEquations);
+    if (!infoJSONReader.read(file)) {
+      QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson),
+                            QString("%1: %2. %3").arg(Helper::parsingFailedJson, mInfoJSONFullFileName, infoJSONReader.getErrorString()), Helper::ok);
       return;
     }
-    QVariantMap vars = result["variables"].toMap();
-    QVariantList eqs = result["equations"].toList();
-    for(QVariantMap::const_iterator iter = vars.begin(); iter != vars.end(); ++iter) {
-      QVariantMap value = iter.value().toMap();
-      OMVariable *var = new OMVariable();
-      var->name = iter.key();
-      var->comment = value["comment"].toString();
-      variantToSource(value["source"].toMap(), var->info, var->types, var->ops);
-      if (!hasOperationsEnabled && var->ops.size() > 0) {
-        hasOperationsEnabled = true;
-      }
-      mVariables[iter.key()] = *var;
-    }
+    hasOperationsEnabled = infoJSONReader.hasOperationsEnabled;
     mpTVariablesTreeModel->insertTVariablesItems(mVariables);
-    for (int i=0; i<eqs.size(); i++) {
-      mEquations << new OMEquation();
-    }
-    for (int i=0; i<eqs.size(); i++) {
-      QVariantMap veq = eqs[i].toMap();
-      OMEquation *eq = mEquations[i];
-      eq->section = veq["section"].toString();
-      if (veq["eqIndex"].toInt() != i) {
-        QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson), Helper::parsingFailedJson + QString(": got index ") + veq["eqIndex"].toString() + QString(" expected ") + QString::number(i), Helper::ok);
-        return;
-      }
-      eq->index = i;
-      eq->profileBlock = -1;
-      if (veq.find("parent") != veq.end()) {
-        eq->parent = veq["parent"].toInt();
-        mEquations[eq->parent]->eqs << eq->index;
-      } else {
-        eq->parent = 0;
-      }
-      if (veq.find("defines") != veq.end()) {
-        eq->defines = variantListToStringList(veq["defines"].toList());
-        foreach (QString v, eq->defines) {
-          mVariables[v].definedIn << eq->index;
-        }
-      }
-      if (veq.find("uses") != veq.end()) {
-        eq->depends = variantListToStringList(veq["uses"].toList());
-        foreach (QString v, eq->depends) {
-          mVariables[v].usedIn << eq->index;
-        }
-      }
-      eq->text = variantListToStringList(veq["equation"].toList());
-      eq->tag = veq["tag"].toString();
-      if (veq.find("display") != veq.end()) {
-        eq->display = veq["display"].toString();
-      } else {
-        eq->display = eq->tag;
-      }
-      variantToSource(veq["source"].toMap(), eq->info, eq->types, eq->ops);
-      if (!hasOperationsEnabled && eq->ops.size() > 0) {
-        hasOperationsEnabled = true;
-      }
-    }
     parseProfiling(mProfJSONFullFileName);
     fetchEquations();
   } else {
@@ -0,0 +1,459 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "AnnotationParser.h"
+
+#include <QVarLengthArray>
+
+/*!
+ * \class AnnotationValue
+ * \brief A value of the annotation parsed by AnnotationParser.
+ * The value only refers to the node of the parser so it is valid as long as the parser exists. The text of the value is never copied
+ * unless AnnotationValue::toString() or AnnotationValue::toUnquotedString() is used.
+ */
+/*!
+ * \brief AnnotationValue::AnnotationValue
+ * Creates an invalid value.
+ */
+AnnotationValue::AnnotationValue()
+  : mpAnnotationParser(0), mNode(-1)
+{
+}
+
+/*!
+ * \brief AnnotationValue::AnnotationValue
+ * \param pAnnotationParser
+ * \param node - the index of the node in the parser.
+ */
+AnnotationValue::AnnotationValue(const AnnotationParser *pAnnotationParser, int node)
+  : mpAnnotationParser(pAnnotationParser), mNode(node)
+{
+}
+
+/*!
+ * \brief AnnotationValue::getType
+ * Returns the type of the value.
+ * \return
+ */
+AnnotationValue::Type AnnotationValue::getType() const
+{
+  if (!mpAnnotationParser || mNode < 0 || mNode >= mpAnnotationParser->mNodes.size()) {
+    return Invalid;
+  }
+  return mpAnnotationParser->mNodes.at(mNode).mType;
+}
+
+/*!
+ * \brief AnnotationValue::size
+ * Returns the number of elements of an array. Other values have no elements.
+ * \return
+ */
+int AnnotationValue::size() const
+{
+  return isArray() ? mpAnnotationParser->mNodes.at(mNode).mChildrenCount : 0;
+}
+
+/*!
+ * \brief AnnotationValue::at
+ * Returns the element at index of an array or an invalid value if there is no such element.
+ * \param index
+ * \return
+ */
+AnnotationValue AnnotationValue::at(int index) const
+{
+  if (index < 0 || index >= size()) {
+    return AnnotationValue();
+  }
+  return AnnotationValue(mpAnnotationParser, mpAnnotationParser->mChildren.at(mpAnnotationParser->mNodes.at(mNode).mFirstChild + index));
+}
+
+/*!
+ * \brief AnnotationValue::getRecordName
+ * Returns the name of a record constructor e.g., Line for Line(...).
+ * \return
+ */
+QStringRef AnnotationValue::getRecordName() const
+{
+  if (!isRecord()) {
+    return QStringRef();
+  }
+  const AnnotationParser::Node &node = mpAnnotationParser->mNodes.at(mNode);
+  const AnnotationParser::Node &arguments = mpAnnotationParser->mNodes.at(mpAnnotationParser->mChildren.at(node.mFirstChild));
+  return QStringRef(&mpAnnotationParser->mAnnotation, node.mPosition, arguments.mPosition - node.mPosition);
+}
+
+/*!
+ * \brief AnnotationValue::getRecordArguments
+ * Returns the arguments of a record constructor as an array. Returns an invalid value if the value is not a record.
+ * \return
+ */
+AnnotationValue AnnotationValue::getRecordArguments() const
+{
+  if (!isRecord()) {
+    return AnnotationValue();
+  }
+  return AnnotationValue(mpAnnotationParser, mpAnnotationParser->mChildren.at(mpAnnotationParser->mNodes.at(mNode).mFirstChild));
+}
+
+/*!
+ * \brief AnnotationValue::toStringRef
+ * Returns the text of the value without copying it. Arrays include the curly brackets and strings include the quotes.
+ * \return
+ */
+QStringRef AnnotationValue::toStringRef() const
+{
+  if (!isValid()) {
+    return QStringRef();
+  }
+  const AnnotationParser::Node &node = mpAnnotationParser->mNodes.at(mNode);
+  return QStringRef(&mpAnnotationParser->mAnnotation, node.mPosition, node.mLength);
+}
+
+/*!
+ * \brief AnnotationValue::toString
+ * Returns a copy of the text of the value.
+ * \return
+ */
+QString AnnotationValue::toString() const
+{
+  return toStringRef().toString();
+}
+
+/*!
+ * \brief AnnotationValue::toUnquotedString
+ * Returns a copy of the text of the value. The quotes of a string are removed.
+ * \return
+ */
+QString AnnotationValue::toUnquotedString() const
+{
+  if (getType() == String) {
+    const AnnotationParser::Node &node = mpAnnotationParser->mNodes.at(mNode);
+    return mpAnnotationParser->mAnnotation.mid(node.mPosition + 1, node.mLength - 2);
+  }
+  return toString();
+}
+
+/*!
+ * \brief AnnotationValue::startsWith
+ * Returns true if the text of the value starts with c.
+ * \param c
+ * \return
+ */
+bool AnnotationValue::startsWith(QChar c) const
+{
+  QStringRef value = toStringRef();
+  return !value.isEmpty() && value.at(0) == c;
+}
+
+/*!
+ * \brief AnnotationValue::equals
+ * Returns true if the text of the value is value.
+ * \param value
+ * \return
+ */
+bool AnnotationValue::equals(const QLatin1String &value) const
+{
+  return isValid() && toStringRef() == value;
+}
+
+/*!
+ * \brief AnnotationValue::toDouble
+ * Converts the value to double. Returns 0 if the value is not a number.
+ * \param ok - set to false if the conversion fails.
+ * \return
+ */
+double AnnotationValue::toDouble(bool *ok) const
+{
+  if (getType() != Token) {
+    if (ok) {
+      *ok = false;
+    }
+    return 0;
+  }
+  const AnnotationParser::Node &node = mpAnnotationParser->mNodes.at(mNode);
+  // wraps the characters of the annotation without copying them.
+  return QString::fromRawData(mpAnnotationParser->mAnnotation.unicode() + node.mPosition, node.mLength).toDouble(ok);
+}
+
+/*!
+ * \brief AnnotationValue::toInt
+ * Converts the value to int. Returns 0 if the value is not an integer.
+ * \param ok - set to false if the conversion fails.
+ * \return
+ */
+int AnnotationValue::toInt(bool *ok) const
+{
+  if (getType() != Token) {
+    if (ok) {
+      *ok = false;
+    }
+    return 0;
+  }
+  const AnnotationParser::Node &node = mpAnnotationParser->mNodes.at(mNode);
+  return QString::fromRawData(mpAnnotationParser->mAnnotation.unicode() + node.mPosition, node.mLength).toInt(ok);
+}
+
+/*!
+ * \brief AnnotationValue::toBool
+ * Returns true if the value is true.
+ * \return
+ */
+bool AnnotationValue::toBool() const
+{
+  return equals(QLatin1String("true"));
+}
+
+/*!
+ * \brief AnnotationValue::toPointF
+ * Converts an array of two numbers e.g., {-100,100} to a point.
+ * \param pPoint - set to the point if the value is an array of at least two elements.
+ * \return true if the value is converted.
+ */
+bool AnnotationValue::toPointF(QPointF *pPoint) const
+{
+  if (size() < 2) {
+    return false;
+  }
+  *pPoint = QPointF(at(0).toDouble(), at(1).toDouble());
+  return true;
+}
+
+/*!
+ * \brief AnnotationValue::toColor
+ * Converts an array of three integers e.g., {0,0,255} to a color.
+ * \param pColor - set to the color if the value is an array of at least three elements.
+ * \return true if the value is converted.
+ */
+bool AnnotationValue::toColor(QColor *pColor) const
+{
+  if (size() < 3) {
+    return false;
+  }
+  *pColor = QColor(at(0).toInt(), at(1).toInt(), at(2).toInt());
+  return true;
+}
+
+/*!
+ * \brief AnnotationValue::toPoints
+ * Converts an array of points e.g., {{-100,100},{100,-100}} to a list of points. Elements that are not points are skipped.
+ * \return
+ */
+QList<QPointF> AnnotationValue::toPoints() const
+{
+  QList<QPointF> points;
+  int count = size();
+  for (int i = 0 ; i < count ; i++) {
+    QPointF point;
+    if (at(i).toPointF(&point)) {
+      points.append(point);
+    }
+  }
+  return points;
+}
+
+/*!
+ * \class AnnotationParser
+ * \brief Parses the annotation values returned by OMC e.g., true, {0,0}, 0, {{-100,100},{100,-100}}, LinePattern.Solid in a single pass.
+ * The parser builds a tree of nodes that refer to the positions in the annotation text. Nothing is copied while parsing.
+ * The top level comma separated values are the elements of the root array.
+ */
+/*!
+ * \brief AnnotationParser::AnnotationParser
+ * \param annotation
+ */
+AnnotationParser::AnnotationParser(const QString &annotation)
+  : mAnnotation(annotation)
+{
+  int root = addNode(AnnotationValue::Array, 0);
+  int index = 0;
+  parseList(root, index, QChar());
+  mNodes[root].mLength = mAnnotation.length();
+}
+
+/*!
+ * \brief AnnotationParser::addNode
+ * Adds a node and returns its index.
+ * \param type
+ * \param position
+ * \return
+ */
+int AnnotationParser::addNode(AnnotationValue::Type type, int position)
+{
+  Node node;
+  node.mType = type;
+  node.mPosition = position;
+  node.mLength = 0;
+  node.mFirstChild = 0;
+  node.mChildrenCount = 0;
+  mNodes.append(node);
+  return mNodes.size() - 1;
+}
+
+/*!
+ * \brief AnnotationParser::parseList
+ * Parses the comma separated values until end and adds them as the children of node.
+ * \param node - the array node.
+ * \param index - the position to start from. Set to the position after end.
+ * \param end - the closing character of the list. A null QChar parses until the end of the annotation.
+ */
+void AnnotationParser::parseList(int node, int &index, QChar end)
+{
+  QVarLengthArray<int, 16> children;
+  skipSpaces(index);
+  if (index < mAnnotation.length() && (end.isNull() || mAnnotation.at(index) != end)) {
+    forever {
+      children.append(parseValue(index, end));
+      skipSpaces(index);
+      if (index < mAnnotation.length() && mAnnotation.at(index) == ',') {
+        index++;
+      } else {
+        break;
+      }
+    }
+  }
+  if (!end.isNull() && index < mAnnotation.length() && mAnnotation.at(index) == end) {
+    index++;
+  }
+  // the children of a node are stored contiguously since nested arrays add their children first.
+  mNodes[node].mFirstChild = mChildren.size();
+  mNodes[node].mChildrenCount = children.size();
+  for (int i = 0 ; i < children.size() ; i++) {
+    mChildren.append(children[i]);
+  }
+}
+
+/*!
+ * \brief AnnotationParser::parseValue
+ * Parses an array, a string, a record or a token. A token is any text up to the next comma or end outside of brackets and strings.
+ * \param index - the position to start from. Set to the position after the value.
+ * \param end - the closing character of the enclosing list.
+ * \return the index of the node.
+ */
+int AnnotationParser::parseValue(int &index, QChar end)
+{
+  skipSpaces(index);
+  if (index < mAnnotation.length() && mAnnotation.at(index) == '{') {
+    int node = addNode(AnnotationValue::Array, index);
+    index++;
+    parseList(node, index, '}');
+    mNodes[node].mLength = index - mNodes.at(node).mPosition;
+    return node;
+  }
+  int position = index;
+  int valueEnd = index;
+  int depth = 0;
+  while (index < mAnnotation.length()) {
+    QChar c = mAnnotation.at(index);
+    if (c == '"' || c == '\'') {
+      skipString(index);
+      valueEnd = index;
+      continue;
+    }
+    if (depth == 0 && (c == ',' || c == end)) {
+      break;
+    }
+    if (c == '(' || c == '[' || c == '{') {
+      depth++;
+    } else if ((c == ')' || c == ']' || c == '}') && depth > 0) {
+      depth--;
+    }
+    index++;
+    if (!c.isSpace()) {
+      valueEnd = index;
+    }
+  }
+  // the value is a string if it is just one quoted string.
+  int stringEnd = position;
+  AnnotationValue::Type type = AnnotationValue::Token;
+  if (position < mAnnotation.length() && mAnnotation.at(position) == '"') {
+    skipString(stringEnd);
+    if (stringEnd == valueEnd) {
+      type = AnnotationValue::String;
+    }
+  }
+  int node = addNode(type, position);
+  mNodes[node].mLength = valueEnd - position;
+  // a token like Line(...) is a record constructor. Its arguments are parsed as an array.
+  if (type == AnnotationValue::Token && valueEnd > position && mAnnotation.at(valueEnd - 1) == ')') {
+    int nameEnd = position;
+    while (nameEnd < valueEnd && (mAnnotation.at(nameEnd).isLetterOrNumber() || mAnnotation.at(nameEnd) == '_' || mAnnotation.at(nameEnd) == '.')) {
+      nameEnd++;
+    }
+    if (nameEnd > position && nameEnd < valueEnd && mAnnotation.at(nameEnd) == '(') {
+      int arguments = addNode(AnnotationValue::Array, nameEnd);
+      int argumentsIndex = nameEnd + 1;
+      parseList(arguments, argumentsIndex, ')');
+      mNodes[arguments].mLength = argumentsIndex - nameEnd;
+      // e.g., f(x) + g(y) is not a record since the closing bracket of f is not the end of the token.
+      if (argumentsIndex == valueEnd) {
+        mNodes[node].mType = AnnotationValue::Record;
+        mNodes[node].mFirstChild = mChildren.size();
+        mChildren.append(arguments);
+      }
+    }
+  }
+  return node;
+}
+
+/*!
+ * \brief AnnotationParser::skipSpaces
+ * Moves the index to the next non space character.
+ * \param index
+ */
+void AnnotationParser::skipSpaces(int &index) const
+{
+  while (index < mAnnotation.length() && mAnnotation.at(index).isSpace()) {
+    index++;
+  }
+}
+
+/*!
+ * \brief AnnotationParser::skipString
+ * Moves the index from the opening quote to the position after the closing quote.
+ * \param index
+ */
+void AnnotationParser::skipString(int &index) const
+{
+  QChar quote = mAnnotation.at(index);
+  index++;
+  while (index < mAnnotation.length()) {
+    QChar c = mAnnotation.at(index);
+    if (c == '\\') {
+      index += 2;
+    } else if (c == quote) {
+      index++;
+      return;
+    } else {
+      index++;
+    }
+  }
+  index = qMin(index, mAnnotation.length());
+}
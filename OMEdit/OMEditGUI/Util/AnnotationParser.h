@@ -0,0 +1,108 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef ANNOTATIONPARSER_H
+#define ANNOTATIONPARSER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+#include <QList>
+#include <QPointF>
+#include <QColor>
+
+class AnnotationParser;
+
+class AnnotationValue
+{
+public:
+  enum Type {
+    Invalid,  /* Used for out of range values. */
+    Token,    /* Used for numbers, booleans, enumerations and expressions. */
+    String,   /* Used for quoted strings. */
+    Array,    /* Used for {...} arrays. */
+    Record    /* Used for record constructors e.g., Line(...). The arguments are an array. */
+  };
+  AnnotationValue();
+  AnnotationValue(const AnnotationParser *pAnnotationParser, int node);
+  bool isValid() const {return getType() != Invalid;}
+  Type getType() const;
+  bool isArray() const {return getType() == Array;}
+  bool isRecord() const {return getType() == Record;}
+  QStringRef getRecordName() const;
+  AnnotationValue getRecordArguments() const;
+  int size() const;
+  AnnotationValue at(int index) const;
+  QStringRef toStringRef() const;
+  QString toString() const;
+  QString toUnquotedString() const;
+  bool startsWith(QChar c) const;
+  bool equals(const QLatin1String &value) const;
+  double toDouble(bool *ok = 0) const;
+  int toInt(bool *ok = 0) const;
+  bool toBool() const;
+  bool toPointF(QPointF *pPoint) const;
+  bool toColor(QColor *pColor) const;
+  QList<QPointF> toPoints() const;
+private:
+  const AnnotationParser *mpAnnotationParser;
+  int mNode;
+};
+
+class AnnotationParser
+{
+public:
+  AnnotationParser(const QString &annotation);
+  AnnotationValue getRoot() const {return AnnotationValue(this, 0);}
+  const QString& getAnnotation() const {return mAnnotation;}
+private:
+  friend class AnnotationValue;
+  class Node
+  {
+  public:
+    AnnotationValue::Type mType;
+    int mPosition;
+    int mLength;
+    int mFirstChild;
+    int mChildrenCount;
+  };
+  QString mAnnotation;
+  QVector<Node> mNodes;
+  QVector<int> mChildren;
+
+  int addNode(AnnotationValue::Type type, int position);
+  void parseList(int node, int &index, QChar end);
+  int parseValue(int &index, QChar end);
+  void skipSpaces(int &index) const;
+  void skipString(int &index) const;
+};
+
+#endif // ANNOTATIONPARSER_H
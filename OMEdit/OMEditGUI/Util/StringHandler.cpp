@@ -1177,6 +1177,39 @@ QStringList StringHandler::unparseArrays(QString value)
   return lst;
 }
 
+QStringList StringHandler::getCurlyBracketsGroups(QString value)
+{
+  QStringList list;
+  bool mask = false;
+  bool inString = false;
+  int begin = 0;
+  int ele = 0;
+  for (int i = 0 ; i < value.length() ; i++) {
+    if (inString) {
+      if (mask) {
+        mask = false;
+      } else if (value.at(i) == '\\') {
+        mask = true;
+      } else if (value.at(i) == '"') {
+        inString = false;
+      }
+    } else if (value.at(i) == '"') {
+      inString = true;
+    } else if (value.at(i) == '{') {
+      if (ele == 0) {
+        begin = i;
+      }
+      ele++;
+    } else if (value.at(i) == '}' && ele > 0) {
+      ele--;
+      if (ele == 0) {
+        list.append(value.mid(begin, i - begin + 1));
+      }
+    }
+  }
+  return list;
+}
+
 bool StringHandler::unparseBool(QString value)
 {
   value = value.trimmed();
@@ -125,6 +125,8 @@ public:
   static QStringList unparseStrings(QString value);
   // Returns empty list if the string is not a standard Modelica array. Else it unparses it into normal form.
   static QStringList unparseArrays(QString value);
+  // Returns the top level {...} groups of the value e.g., the results of several statements sent to OMC in one expression.
+  static QStringList getCurlyBracketsGroups(QString value);
   // Returns false on failure
   static bool unparseBool(QString value);
   static QString getSaveFileName(QWidget* parent = 0, const QString &caption = "", QString * dir = 0, const QString & filter = "",
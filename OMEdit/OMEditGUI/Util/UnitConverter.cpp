@@ -0,0 +1,405 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "UnitConverter.h"
+
+#include <QHash>
+#include <qmath.h>
+
+/*!
+ * \class Unit
+ * \brief A unit expressed with the SI base units.
+ * A value v in the unit corresponds to v * scale + offset in the SI base units.
+ */
+/*!
+ * \brief Unit::Unit
+ * Creates an invalid unit.
+ */
+Unit::Unit()
+  : mValid(false), mScale(1), mOffset(0)
+{
+  for (int i = 0 ; i < BaseUnitsCount ; i++) {
+    mExponents[i] = 0;
+  }
+}
+
+/*!
+ * \brief Unit::Unit
+ * Creates a dimensionless unit.
+ * \param scale
+ * \param offset
+ */
+Unit::Unit(double scale, double offset)
+  : mValid(true), mScale(scale), mOffset(offset)
+{
+  for (int i = 0 ; i < BaseUnitsCount ; i++) {
+    mExponents[i] = 0;
+  }
+}
+
+/*!
+ * \brief Unit::isCompatible
+ * Checks if the units have the same dimension.
+ * \param unit
+ * \return
+ */
+bool Unit::isCompatible(const Unit &unit) const
+{
+  if (!mValid || !unit.mValid) {
+    return false;
+  }
+  for (int i = 0 ; i < BaseUnitsCount ; i++) {
+    if (mExponents[i] != unit.mExponents[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief Unit::multiply
+ * Returns the product of the units. The offset is only meaningful for a single unit so the product has no offset.
+ * \param unit
+ * \return
+ */
+Unit Unit::multiply(const Unit &unit) const
+{
+  if (!mValid || !unit.mValid) {
+    return Unit();
+  }
+  Unit result(mScale * unit.mScale);
+  for (int i = 0 ; i < BaseUnitsCount ; i++) {
+    result.mExponents[i] = mExponents[i] + unit.mExponents[i];
+  }
+  return result;
+}
+
+/*!
+ * \brief Unit::divide
+ * Returns the quotient of the units.
+ * \param unit
+ * \return
+ */
+Unit Unit::divide(const Unit &unit) const
+{
+  return multiply(unit.power(-1));
+}
+
+/*!
+ * \brief Unit::power
+ * Returns the unit raised to exponent.
+ * \param exponent
+ * \return
+ */
+Unit Unit::power(int exponent) const
+{
+  if (!mValid || exponent == 1) {
+    return *this;
+  }
+  Unit result(qPow(mScale, exponent));
+  for (int i = 0 ; i < BaseUnitsCount ; i++) {
+    result.mExponents[i] = mExponents[i] * exponent;
+  }
+  return result;
+}
+
+/*!
+ * \class UnitConverter
+ * \brief Parses the Modelica unit expressions and computes the conversion between two units without asking OMC.
+ * The grammar is the one of the Modelica specification section 19.1 e.g., "kg.m2/s3", "W/(m2.K)", "1/s", "degC".
+ */
+/*!
+ * \brief UnitConverter::UnitConverter
+ * \param unit
+ */
+UnitConverter::UnitConverter(const QString &unit)
+  : mUnit(unit), mPosition(0)
+{
+}
+
+/*!
+ * \brief UnitConverter::parseUnit
+ * Parses the unit expression.
+ * \param unit
+ * \return the unit or an invalid unit if the expression or one of its symbols is unknown.
+ */
+Unit UnitConverter::parseUnit(const QString &unit)
+{
+  UnitConverter unitConverter(unit.trimmed());
+  if (unitConverter.mUnit.isEmpty()) {
+    return Unit();
+  }
+  Unit result = unitConverter.parseExpression();
+  if (unitConverter.mPosition != unitConverter.mUnit.length()) {
+    return Unit();
+  }
+  return result;
+}
+
+/*!
+ * \brief UnitConverter::convertUnits
+ * Computes the scale factor and offset used to convert a value from one unit to another unit.
+ * The converted value is (value - offset) / scaleFactor, same as OMC convertUnits.
+ * \param from
+ * \param to
+ * \param scaleFactor
+ * \param offset
+ * \return false if the units are unknown or not compatible.
+ */
+bool UnitConverter::convertUnits(const QString &from, const QString &to, double *scaleFactor, double *offset)
+{
+  Unit fromUnit = parseUnit(from);
+  Unit toUnit = parseUnit(to);
+  if (!fromUnit.isCompatible(toUnit)) {
+    return false;
+  }
+  *scaleFactor = toUnit.getScale() / fromUnit.getScale();
+  *offset = (toUnit.getOffset() - fromUnit.getOffset()) / fromUnit.getScale();
+  return true;
+}
+
+/*!
+ * \brief UnitConverter::parseExpression
+ * unit_expression : unit_numerator [ "/" unit_denominator ]
+ * \return
+ */
+Unit UnitConverter::parseExpression()
+{
+  Unit numerator;
+  if (mPosition < mUnit.length() && mUnit.at(mPosition) == QLatin1Char('(')) {
+    mPosition++;
+    numerator = parseExpression();
+    if (mPosition >= mUnit.length() || mUnit.at(mPosition) != QLatin1Char(')')) {
+      return Unit();
+    }
+    mPosition++;
+  } else if (mPosition < mUnit.length() && mUnit.at(mPosition) == QLatin1Char('1')) {
+    mPosition++;
+    numerator = Unit(1);
+  } else {
+    numerator = parseFactor();
+    while (numerator.isValid() && mPosition < mUnit.length() && mUnit.at(mPosition) == QLatin1Char('.')) {
+      mPosition++;
+      numerator = numerator.multiply(parseFactor());
+    }
+  }
+  while (numerator.isValid() && mPosition < mUnit.length() && mUnit.at(mPosition) == QLatin1Char('/')) {
+    mPosition++;
+    Unit denominator;
+    if (mPosition < mUnit.length() && mUnit.at(mPosition) == QLatin1Char('(')) {
+      mPosition++;
+      denominator = parseExpression();
+      if (mPosition >= mUnit.length() || mUnit.at(mPosition) != QLatin1Char(')')) {
+        return Unit();
+      }
+      mPosition++;
+    } else {
+      denominator = parseFactor();
+    }
+    numerator = numerator.divide(denominator);
+  }
+  return numerator;
+}
+
+/*!
+ * \brief UnitConverter::parseFactor
+ * unit_factor : unit_operand [ unit_exponent ]
+ * \return
+ */
+Unit UnitConverter::parseFactor()
+{
+  Unit operand = parseOperand();
+  if (!operand.isValid() || mPosition >= mUnit.length()) {
+    return operand;
+  }
+  int start = mPosition;
+  if (mUnit.at(mPosition) == QLatin1Char('+') || mUnit.at(mPosition) == QLatin1Char('-')) {
+    mPosition++;
+  }
+  while (mPosition < mUnit.length() && mUnit.at(mPosition).isDigit()) {
+    mPosition++;
+  }
+  if (mPosition == start) {
+    return operand;
+  }
+  bool ok;
+  int exponent = mUnit.mid(start, mPosition - start).toInt(&ok);
+  return ok ? operand.power(exponent) : Unit();
+}
+
+/*!
+ * \brief UnitConverter::parseOperand
+ * unit_operand : unit_symbol | unit_prefix unit_symbol
+ * \return
+ */
+Unit UnitConverter::parseOperand()
+{
+  int start = mPosition;
+  while (mPosition < mUnit.length() && mUnit.at(mPosition).isLetter()) {
+    mPosition++;
+  }
+  if (mPosition == start) {
+    return Unit();
+  }
+  return findSymbol(mUnit.mid(start, mPosition - start));
+}
+
+/*!
+ * \brief makeUnit
+ * Creates a unit from its scale and the exponents of the SI base units.
+ * \return
+ */
+static Unit makeUnit(double scale, int m, int kg, int s, int A = 0, int K = 0, int mol = 0, int cd = 0, double offset = 0)
+{
+  Unit unit(scale, offset);
+  unit.setExponent(Unit::Metre, m);
+  unit.setExponent(Unit::Kilogram, kg);
+  unit.setExponent(Unit::Second, s);
+  unit.setExponent(Unit::Ampere, A);
+  unit.setExponent(Unit::Kelvin, K);
+  unit.setExponent(Unit::Mole, mol);
+  unit.setExponent(Unit::Candela, cd);
+  return unit;
+}
+
+/*!
+ * \brief createUnitsTable
+ * Creates the table of the SI units, the derived SI units and the common non SI units.
+ * \return
+ */
+static QHash<QString, Unit> createUnitsTable()
+{
+  QHash<QString, Unit> units;
+  // SI base units
+  units.insert("m", makeUnit(1, 1, 0, 0));
+  units.insert("g", makeUnit(1e-3, 0, 1, 0));
+  units.insert("s", makeUnit(1, 0, 0, 1));
+  units.insert("A", makeUnit(1, 0, 0, 0, 1));
+  units.insert("K", makeUnit(1, 0, 0, 0, 0, 1));
+  units.insert("mol", makeUnit(1, 0, 0, 0, 0, 0, 1));
+  units.insert("cd", makeUnit(1, 0, 0, 0, 0, 0, 0, 1));
+  // SI derived units
+  units.insert("rad", Unit(1));
+  units.insert("sr", Unit(1));
+  units.insert("Hz", makeUnit(1, 0, 0, -1));
+  units.insert("N", makeUnit(1, 1, 1, -2));
+  units.insert("Pa", makeUnit(1, -1, 1, -2));
+  units.insert("J", makeUnit(1, 2, 1, -2));
+  units.insert("W", makeUnit(1, 2, 1, -3));
+  units.insert("C", makeUnit(1, 0, 0, 1, 1));
+  units.insert("V", makeUnit(1, 2, 1, -3, -1));
+  units.insert("F", makeUnit(1, -2, -1, 4, 2));
+  units.insert("Ohm", makeUnit(1, 2, 1, -3, -2));
+  units.insert("S", makeUnit(1, -2, -1, 3, 2));
+  units.insert("Wb", makeUnit(1, 2, 1, -2, -1));
+  units.insert("T", makeUnit(1, 0, 1, -2, -1));
+  units.insert("H", makeUnit(1, 2, 1, -2, -2));
+  units.insert("lm", makeUnit(1, 0, 0, 0, 0, 0, 0, 1));
+  units.insert("lx", makeUnit(1, -2, 0, 0, 0, 0, 0, 1));
+  units.insert("Bq", makeUnit(1, 0, 0, -1));
+  units.insert("Gy", makeUnit(1, 2, 0, -2));
+  units.insert("Sv", makeUnit(1, 2, 0, -2));
+  units.insert("kat", makeUnit(1, 0, 0, -1, 0, 0, 1));
+  // non SI units
+  units.insert("min", makeUnit(60, 0, 0, 1));
+  units.insert("h", makeUnit(3600, 0, 0, 1));
+  units.insert("d", makeUnit(86400, 0, 0, 1));
+  units.insert("l", makeUnit(1e-3, 3, 0, 0));
+  units.insert("L", makeUnit(1e-3, 3, 0, 0));
+  units.insert("t", makeUnit(1e3, 0, 1, 0));
+  units.insert("bar", makeUnit(1e5, -1, 1, -2));
+  units.insert("Wh", makeUnit(3600, 2, 1, -2));
+  units.insert("eV", makeUnit(1.602176634e-19, 2, 1, -2));
+  units.insert("VA", makeUnit(1, 2, 1, -3));
+  units.insert("var", makeUnit(1, 2, 1, -3));
+  units.insert("deg", Unit(M_PI / 180));
+  units.insert("rev", Unit(2 * M_PI));
+  units.insert("rpm", makeUnit(2 * M_PI / 60, 0, 0, -1));
+  units.insert("degC", makeUnit(1, 0, 0, 0, 0, 1, 0, 0, 273.15));
+  units.insert("degF", makeUnit(5.0 / 9.0, 0, 0, 0, 0, 1, 0, 0, 459.67 * 5.0 / 9.0));
+  units.insert("degRk", makeUnit(5.0 / 9.0, 0, 0, 0, 0, 1));
+  return units;
+}
+
+/*!
+ * \brief createPrefixesTable
+ * Creates the table of the SI prefixes.
+ * \return
+ */
+static QHash<QString, double> createPrefixesTable()
+{
+  QHash<QString, double> prefixes;
+  prefixes.insert("Y", 1e24);
+  prefixes.insert("Z", 1e21);
+  prefixes.insert("E", 1e18);
+  prefixes.insert("P", 1e15);
+  prefixes.insert("T", 1e12);
+  prefixes.insert("G", 1e9);
+  prefixes.insert("M", 1e6);
+  prefixes.insert("k", 1e3);
+  prefixes.insert("h", 1e2);
+  prefixes.insert("da", 1e1);
+  prefixes.insert("d", 1e-1);
+  prefixes.insert("c", 1e-2);
+  prefixes.insert("m", 1e-3);
+  prefixes.insert("u", 1e-6);
+  prefixes.insert("n", 1e-9);
+  prefixes.insert("p", 1e-12);
+  prefixes.insert("f", 1e-15);
+  prefixes.insert("a", 1e-18);
+  prefixes.insert("z", 1e-21);
+  prefixes.insert("y", 1e-24);
+  return prefixes;
+}
+
+/*!
+ * \brief UnitConverter::findSymbol
+ * Finds the unit symbol. The symbol is first looked up as it is e.g., min, Pa, cd and then as prefix followed by a unit e.g., mm, kPa.
+ * \param symbol
+ * \return
+ */
+Unit UnitConverter::findSymbol(const QString &symbol)
+{
+  static const QHash<QString, Unit> units = createUnitsTable();
+  static const QHash<QString, double> prefixes = createPrefixesTable();
+  QHash<QString, Unit>::const_iterator unit = units.constFind(symbol);
+  if (unit != units.constEnd()) {
+    return unit.value();
+  }
+  for (int prefixLength = 1 ; prefixLength <= 2 && prefixLength < symbol.length() ; prefixLength++) {
+    QHash<QString, double>::const_iterator prefix = prefixes.constFind(symbol.left(prefixLength));
+    unit = units.constFind(symbol.mid(prefixLength));
+    if (prefix != prefixes.constEnd() && unit != units.constEnd()) {
+      return Unit(prefix.value()).multiply(unit.value());
+    }
+  }
+  return Unit();
+}
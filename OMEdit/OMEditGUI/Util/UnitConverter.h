@@ -0,0 +1,82 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef UNITCONVERTER_H
+#define UNITCONVERTER_H
+
+#include <QString>
+
+class Unit
+{
+public:
+  enum BaseUnit {
+    Metre,
+    Kilogram,
+    Second,
+    Ampere,
+    Kelvin,
+    Mole,
+    Candela,
+    BaseUnitsCount
+  };
+  Unit();
+  Unit(double scale, double offset = 0);
+  bool isValid() const {return mValid;}
+  double getScale() const {return mScale;}
+  double getOffset() const {return mOffset;}
+  void setExponent(BaseUnit baseUnit, int exponent) {mExponents[baseUnit] = exponent;}
+  bool isCompatible(const Unit &unit) const;
+  Unit multiply(const Unit &unit) const;
+  Unit divide(const Unit &unit) const;
+  Unit power(int exponent) const;
+private:
+  bool mValid;
+  double mScale;
+  double mOffset;
+  int mExponents[BaseUnitsCount];
+};
+
+class UnitConverter
+{
+public:
+  static Unit parseUnit(const QString &unit);
+  static bool convertUnits(const QString &from, const QString &to, double *scaleFactor, double *offset);
+private:
+  UnitConverter(const QString &unit);
+  QString mUnit;
+  int mPosition;
+  Unit parseExpression();
+  Unit parseFactor();
+  Unit parseOperand();
+  static Unit findSymbol(const QString &symbol);
+};
+
+#endif // UNITCONVERTER_H